@@ -8,7 +8,7 @@
 #include "src/Core/ActivityMonitor.h"
 
 #include "src/Database/DataBase.h"
-#include "src/Database/TTRFile/TTRFileReader.h"
+#include "src/Database/TTRFile/TTRFileMappedReader.h"
 #include "src/Database/TTEFile/TTEFileReader.h"
 
 #include "src/Utils/Logger.h"
@@ -29,7 +29,7 @@ int MAIN
 	//Logger::set_file_path(PathProvider::log_file_path());
 	Logger::set_log_level(LogLevel::LOG_INFO);
 
-	TTRFileReader ttr_reader(PathProvider::ttr_file_path());
+	TTRFileMappedReader ttr_reader(PathProvider::ttr_file_path());
 	//TTRFileWriter writer(PathProvider::ttr_file_path());
 
 	TTEFileReader tte_reader(PathProvider::tte_file_path());
@@ -39,8 +39,8 @@ int MAIN
 
 	for (auto event : tte_reader.events())
 	{
-		std::string entity = ttr_reader.get_entity(event.entity);
-		std::string domain = ttr_reader.get_domain(event.entity);
+		std::string_view entity = ttr_reader.get_entity(event.entity);
+		std::string_view domain = ttr_reader.get_domain(event.entity);
 
 		Logger::log_info("[{}.{}.{} - {}:{}:{}] ({}) {}",
 			event.date.day, event.date.month, event.date.year,
@@ -0,0 +1,80 @@
+#include "CountMinSketch.h"
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+	: _width((std::max<size_t>)(width, 1)), _depth((std::max<size_t>)(depth, 1))
+{
+	_counters.assign(_width * _depth, 0);
+
+	// SplitMix64, the multipliers of multiply-shift hashing have to be odd
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+
+	for (size_t i = 0; i < _depth; i++)
+	{
+		state += 0x9E3779B97F4A7C15ull;
+
+		uint64_t seed = state;
+		seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+		seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+		seed = seed ^ (seed >> 31);
+
+		_seeds.push_back(seed | 1);
+	}
+}
+
+void CountMinSketch::add(key_type key, int64_t weight)
+{
+	for (size_t row = 0; row < _depth; row++)
+	{
+		_counters[row * _width + _index(row, key)] += weight;
+	}
+}
+
+int64_t CountMinSketch::estimate(key_type key) const
+{
+	int64_t estimate = (std::numeric_limits<int64_t>::max)();
+
+	for (size_t row = 0; row < _depth; row++)
+	{
+		estimate = (std::min)(estimate, _counters[row * _width + _index(row, key)]);
+	}
+
+	return estimate;
+}
+
+bool CountMinSketch::merge(const CountMinSketch& other)
+{
+	if (other._width != _width || other._depth != _depth)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < _counters.size(); i++)
+	{
+		_counters[i] += other._counters[i];
+	}
+
+	return true;
+}
+
+size_t CountMinSketch::width() const
+{
+	return _width;
+}
+
+size_t CountMinSketch::depth() const
+{
+	return _depth;
+}
+
+size_t CountMinSketch::size_in_bytes() const
+{
+	return _counters.size() * sizeof(int64_t);
+}
+
+size_t CountMinSketch::_index(size_t row, key_type key) const
+{
+	// Multiply-shift on the upper 32 bits, then reduced to the width
+	uint64_t hash = (_seeds[row] * (uint64_t(key) + 1)) >> 32;
+
+	return size_t(hash % _width);
+}
\ No newline at end of file
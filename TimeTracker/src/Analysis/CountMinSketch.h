@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include <stdint.h>
+
+/*
+* Count-Min sketch (Cormode and Muthukrishnan) of non-negative weights.
+* 
+* depth rows of width counters, every row hashes a key to one counter with
+* its own multiply-shift hash. The estimate of a key is the minimum of its
+* counters, which never underestimates and overestimates by at most
+* e / width * total with probability 1 - e^-depth.
+* 
+* The hashes are seeded deterministically, so sketches of the same shape can
+* be merged by adding their counters.
+*/
+
+class CountMinSketch
+{
+public:
+	using key_type = uint32_t;
+
+public:
+	CountMinSketch(size_t width = 1024, size_t depth = 4);
+
+	void add(key_type key, int64_t weight);
+	int64_t estimate(key_type key) const;
+
+	bool merge(const CountMinSketch& other);
+
+	size_t width() const;
+	size_t depth() const;
+
+	size_t size_in_bytes() const;
+
+private:
+	size_t _width;
+	size_t _depth;
+
+	std::vector<int64_t> _counters;
+	std::vector<uint64_t> _seeds;
+
+	size_t _index(size_t row, key_type key) const;
+};
\ No newline at end of file
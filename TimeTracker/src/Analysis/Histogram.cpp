@@ -0,0 +1,145 @@
+#include "Histogram.h"
+
+Histogram::Histogram(size_t num_of_entities, Cycle cycle, timestamp bucket_size)
+	: _num_of_entities(num_of_entities), _cycle(cycle), _bucket_size(bucket_size)
+{
+	if (!valid_bucket_size(_bucket_size))
+	{
+		Logger::log_warning("Invalid histogram bucket size {}, using hours", _bucket_size);
+		_bucket_size = 3600;
+	}
+
+	_cycle_length = _cycle == Cycle::WEEK ? 7 * TimeConverter::seconds_per_day : TimeConverter::seconds_per_day;
+	_num_of_buckets = size_t(_cycle_length / _bucket_size);
+
+	_durations.assign(_num_of_entities * _num_of_buckets, 0);
+	_events.assign(_num_of_entities * _num_of_buckets, 0);
+}
+
+bool Histogram::valid_bucket_size(timestamp bucket_size)
+{
+	return bucket_size > 0 && TimeConverter::seconds_per_day % bucket_size == 0;
+}
+
+void Histogram::add_event(entity_id entity, timestamp time)
+{
+	if (entity >= _num_of_entities)
+	{
+		return;
+	}
+
+	_events[entity * _num_of_buckets + bucket_of(time)]++;
+}
+
+void Histogram::add_interval(entity_id entity, timestamp start, timestamp end)
+{
+	if (entity >= _num_of_entities || end <= start)
+	{
+		return;
+	}
+
+	timestamp* row = _durations.data() + entity * _num_of_buckets;
+
+	timestamp cycles = (end - start) / _cycle_length;
+	if (cycles > 0)
+	{
+		for (size_t bucket = 0; bucket < _num_of_buckets; bucket++)
+		{
+			row[bucket] += cycles * _bucket_size;
+		}
+	}
+
+	// The rest is shorter than a cycle and touches every bucket at most twice
+	timestamp remaining = (end - start) % _cycle_length;
+	timestamp position = _position(start);
+
+	while (remaining > 0)
+	{
+		size_t bucket = size_t(position / _bucket_size);
+		timestamp length = (std::min)(remaining, (timestamp(bucket) + 1) * _bucket_size - position);
+
+		row[bucket] += length;
+
+		remaining -= length;
+		position = (position + length) % _cycle_length;
+	}
+}
+
+bool Histogram::merge(const Histogram& other)
+{
+	if (other._num_of_entities != _num_of_entities || other._cycle != _cycle || other._bucket_size != _bucket_size)
+	{
+		Logger::log_error("Cannot merge histograms with different layouts");
+		return false;
+	}
+
+	for (size_t i = 0; i < _durations.size(); i++)
+	{
+		_durations[i] += other._durations[i];
+		_events[i] += other._events[i];
+	}
+
+	return true;
+}
+
+void Histogram::clear()
+{
+	std::fill(_durations.begin(), _durations.end(), 0);
+	std::fill(_events.begin(), _events.end(), 0);
+}
+
+size_t Histogram::num_of_entities() const
+{
+	return _num_of_entities;
+}
+
+size_t Histogram::num_of_buckets() const
+{
+	return _num_of_buckets;
+}
+
+Histogram::Cycle Histogram::cycle() const
+{
+	return _cycle;
+}
+
+Histogram::timestamp Histogram::bucket_size() const
+{
+	return _bucket_size;
+}
+
+size_t Histogram::bucket_of(timestamp time) const
+{
+	return size_t(_position(time) / _bucket_size);
+}
+
+Histogram::timestamp Histogram::duration(entity_id entity, size_t bucket) const
+{
+	return entity < _num_of_entities && bucket < _num_of_buckets ? _durations[entity * _num_of_buckets + bucket] : 0;
+}
+
+uint64_t Histogram::events(entity_id entity, size_t bucket) const
+{
+	return entity < _num_of_entities && bucket < _num_of_buckets ? _events[entity * _num_of_buckets + bucket] : 0;
+}
+
+bool Histogram::has_data(entity_id entity) const
+{
+	for (size_t bucket = 0; bucket < _num_of_buckets && entity < _num_of_entities; bucket++)
+	{
+		if (_durations[entity * _num_of_buckets + bucket] != 0 || _events[entity * _num_of_buckets + bucket] != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Histogram::timestamp Histogram::_position(timestamp time) const
+{
+	timestamp shifted = _cycle == Cycle::WEEK ? time + _week_offset : time;
+
+	timestamp position = shifted % _cycle_length;
+	return position < 0 ? position + _cycle_length : position;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <stdint.h>
+
+#include "IntervalBuilder.h"
+
+#include "../Utils/Logger.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* Dense histogram of the time spent and the events per entity over the time
+* of the day or the day of the week.
+*
+* The cycle, a day or a week starting on Monday, is divided into buckets of
+* bucket_size seconds, and every entity owns one row of durations and event
+* counts indexed by bucket, so accumulating is an array update instead of a
+* hash lookup. Intervals are split at bucket boundaries, whole cycles are added
+* to every bucket at once, so even intervals spanning weeks cost O(buckets).
+*
+* Histograms with the same layout can be merged, which is how HistogramBuilder
+* combines its partials.
+*/
+
+class Histogram
+{
+public:
+	using timestamp = TimeConverter::timestamp;
+	using entity_id = IntervalBuilder::entity_id;
+
+	enum class Cycle
+	{
+		DAY,
+		WEEK
+	};
+
+public:
+	Histogram(size_t num_of_entities = 0, Cycle cycle = Cycle::DAY, timestamp bucket_size = 3600);
+
+	// Buckets must evenly divide a day, so week buckets never straddle two days
+	static bool valid_bucket_size(timestamp bucket_size);
+
+	void add_event(entity_id entity, timestamp time);
+	void add_interval(entity_id entity, timestamp start, timestamp end);
+
+	// Fails when the layouts differ
+	bool merge(const Histogram& other);
+
+	void clear();
+
+	size_t num_of_entities() const;
+	size_t num_of_buckets() const;
+
+	Cycle cycle() const;
+	timestamp bucket_size() const;
+
+	size_t bucket_of(timestamp time) const;
+
+	timestamp duration(entity_id entity, size_t bucket) const;
+	uint64_t events(entity_id entity, size_t bucket) const;
+
+	// False when the entity has neither time nor events in any bucket
+	bool has_data(entity_id entity) const;
+
+private:
+	size_t _num_of_entities;
+
+	Cycle _cycle;
+	timestamp _bucket_size;
+	timestamp _cycle_length;
+	size_t _num_of_buckets;
+
+	std::vector<timestamp> _durations;
+	std::vector<uint64_t> _events;
+
+	// 2000-01-01 was a Saturday, this shifts week positions to start on Monday
+	static constexpr timestamp _week_offset = 5 * TimeConverter::seconds_per_day;
+
+private:
+	timestamp _position(timestamp time) const;
+};
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "HistogramBuilder.h"
+
+HistogramBuilder::HistogramBuilder(const Histogram& layout, size_t num_of_threads)
+{
+	if (num_of_threads == 0)
+	{
+		num_of_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+	}
+
+	_partials.assign(num_of_threads, Histogram(layout.num_of_entities(), layout.cycle(), layout.bucket_size()));
+	_batch.reserve(_min_batch_size);
+
+	if (num_of_threads > 1)
+	{
+		for (size_t i = 0; i < num_of_threads; i++)
+		{
+			_workers.emplace_back(&HistogramBuilder::_worker, this, i);
+		}
+	}
+}
+
+HistogramBuilder::~HistogramBuilder()
+{
+	_join();
+}
+
+void HistogramBuilder::add_event(entity_id entity, timestamp time)
+{
+	_batch.push_back(_Item{ entity, time, time, true });
+}
+
+void HistogramBuilder::add_interval(entity_id entity, timestamp start, timestamp end)
+{
+	_batch.push_back(_Item{ entity, start, end, false });
+}
+
+void HistogramBuilder::end_block()
+{
+	if (_batch.size() >= _min_batch_size)
+	{
+		_submit();
+	}
+}
+
+bool HistogramBuilder::finish(Histogram& histogram)
+{
+	if (_finished)
+	{
+		Logger::log_error("Histogram builder already finished");
+		return false;
+	}
+
+	if (!_batch.empty())
+	{
+		_submit();
+	}
+
+	_join();
+	_finished = true;
+
+	for (const Histogram& partial : _partials)
+	{
+		if (!histogram.merge(partial))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t HistogramBuilder::num_of_threads() const
+{
+	return _partials.size();
+}
+
+uint64_t HistogramBuilder::num_of_batches() const
+{
+	return _num_of_batches;
+}
+
+void HistogramBuilder::_worker(size_t index)
+{
+	Histogram& partial = _partials[index];
+
+	while (true)
+	{
+		_Batch batch;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_has_batch.wait(lock, [this]() { return !_queue.empty() || _finishing; });
+
+			if (_queue.empty())
+			{
+				return;
+			}
+
+			batch = std::move(_queue.front());
+			_queue.pop_front();
+		}
+
+		_has_room.notify_one();
+
+		_add_batch(batch, partial);
+	}
+}
+
+void HistogramBuilder::_submit()
+{
+	_num_of_batches++;
+
+	if (_workers.empty())
+	{
+		_add_batch(_batch, _partials.front());
+		_batch.clear();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_has_room.wait(lock, [this]() { return _queue.size() < _max_queued_batches; });
+
+		_queue.push_back(std::move(_batch));
+	}
+
+	_has_batch.notify_one();
+
+	_batch = _Batch();
+	_batch.reserve(_min_batch_size);
+}
+
+void HistogramBuilder::_join()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_finishing = true;
+	}
+
+	_has_batch.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+}
+
+void HistogramBuilder::_add_batch(const _Batch& batch, Histogram& histogram)
+{
+	for (const _Item& item : batch)
+	{
+		if (item.is_event)
+			histogram.add_event(item.entity, item.start);
+		else
+			histogram.add_interval(item.entity, item.start, item.end);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <stdint.h>
+
+#include "Histogram.h"
+
+/*
+* Fills a Histogram from a scan on several threads.
+*
+* The scan adds the events and intervals of one date block and ends the block,
+* which hands them over as a batch. Every worker adds the batches it takes to
+* its own partial histogram, and finish() merges the partials. The queue of
+* batches is bounded, so a scan that outpaces the workers waits instead of
+* buffering the whole database.
+*
+* Building intervals is sequential by nature and stays on the scanning thread,
+* only the splitting into buckets runs in parallel. Small date blocks are
+* coalesced until a batch is worth a handover, and with a single thread the
+* batches are added directly.
+*/
+
+class HistogramBuilder
+{
+public:
+	using timestamp = Histogram::timestamp;
+	using entity_id = Histogram::entity_id;
+
+public:
+	// The layout of the histogram is copied for every partial, 0 threads for one per core
+	HistogramBuilder(const Histogram& layout, size_t num_of_threads);
+	~HistogramBuilder();
+
+	void add_event(entity_id entity, timestamp time);
+	void add_interval(entity_id entity, timestamp start, timestamp end);
+
+	void end_block();
+
+	// Waits for the workers and adds the merged partials to the histogram
+	bool finish(Histogram& histogram);
+
+	size_t num_of_threads() const;
+	uint64_t num_of_batches() const;
+
+private:
+	struct _Item
+	{
+		entity_id entity = 0;
+
+		// Events have no end
+		timestamp start = 0;
+		timestamp end = 0;
+		bool is_event = false;
+	};
+
+	using _Batch = std::vector<_Item>;
+
+	_Batch _batch;
+	uint64_t _num_of_batches = 0;
+
+	std::vector<Histogram> _partials;
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _has_batch;
+	std::condition_variable _has_room;
+
+	std::deque<_Batch> _queue;
+	bool _finishing = false;
+	bool _finished = false;
+
+	static constexpr size_t _min_batch_size = 4096;
+	static constexpr size_t _max_queued_batches = 16;
+
+private:
+	void _worker(size_t index);
+
+	void _submit();
+	void _join();
+
+	static void _add_batch(const _Batch& batch, Histogram& histogram);
+};
\ No newline at end of file
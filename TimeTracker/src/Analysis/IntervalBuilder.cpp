@@ -0,0 +1,234 @@
+#include "IntervalBuilder.h"
+
+namespace
+{
+	const char* const exclusive_domains[] = { "Runtime", "System", "Activity" };
+
+	// See Merger::device_domain
+	const char* const device_domain = "Device";
+
+	struct HostApplication
+	{
+		const char* process;
+		const char* domain;
+	};
+
+	const HostApplication host_applications[] = {
+		{ "chrome.exe", "Browser" },
+		{ "Code.exe", "VSCode" },
+		{ "Obsidian.exe", "Obsidian" }
+	};
+}
+
+void IntervalBuilder::add_domain(domain_id id, std::string_view name)
+{
+	if (_domains.size() <= id)
+	{
+		_domains.resize(size_t(id) + 1);
+
+		for (std::vector<_State>& states : _states)
+		{
+			states.resize(_domains.size());
+		}
+	}
+
+	_Domain& domain = _domains[id];
+	domain.known = true;
+	domain.exclusive = false;
+	domain.device = name == device_domain;
+
+	for (const char* exclusive_domain : exclusive_domains)
+	{
+		if (name == exclusive_domain)
+		{
+			domain.exclusive = true;
+		}
+	}
+
+	_domain_ids.insert_or_assign(std::string(name), id);
+}
+
+void IntervalBuilder::add_entity(entity_id id, domain_id domain, std::string_view name)
+{
+	if (_entities.size() <= id)
+	{
+		_entities.resize(size_t(id) + 1);
+	}
+
+	_Entity& entity = _entities[id];
+	entity.known = true;
+	entity.domain = domain;
+	entity.hosted_domain = nullptr;
+
+	for (const HostApplication& application : host_applications)
+	{
+		if (name == application.process)
+		{
+			entity.hosted_domain = application.domain;
+		}
+	}
+
+	if (entity.hosted_domain != nullptr && domain < _domains.size())
+	{
+		_domains[domain].hosts = true;
+	}
+}
+
+bool IntervalBuilder::add_event(timestamp time, entity_id entity, const IntervalHandler& handler)
+{
+	if (!is_known_entity(entity))
+	{
+		return false;
+	}
+
+	const _Entity& info = _entities[entity];
+
+	if (info.domain >= _domains.size() || !_domains[info.domain].known)
+	{
+		return false;
+	}
+
+	_Domain& domain = _domains[info.domain];
+
+	if (domain.device)
+	{
+		_State& state = _state(info.domain);
+
+		_close_domain(state, info.domain, time, handler);
+		_open_domain(state, entity, time);
+
+		// The following events belong to this device, with the intervals it left open
+		auto [it, inserted] = _device_states.try_emplace(entity, _states.size());
+		if (inserted)
+		{
+			_states.emplace_back(_domains.size());
+		}
+
+		_current_state = it->second;
+		return true;
+	}
+
+	if (domain.exclusive)
+	{
+		for (size_t i = 0; i < _domains.size(); i++)
+		{
+			if (!_domains[i].device)
+			{
+				_close_domain(_state(domain_id(i)), domain_id(i), time, handler);
+			}
+		}
+	}
+	else
+	{
+		_close_domain(_state(info.domain), info.domain, time, handler);
+
+		_state(info.domain).has_last_entity = true;
+		_state(info.domain).last_entity = entity;
+	}
+
+	_open_domain(_state(info.domain), entity, time);
+
+	if (info.hosted_domain != nullptr)
+	{
+		auto it = _domain_ids.find(std::string_view(info.hosted_domain));
+		if (it != _domain_ids.end() && _state(it->second).has_last_entity)
+		{
+			_open_domain(_state(it->second), _state(it->second).last_entity, time);
+		}
+	}
+
+	return true;
+}
+
+void IntervalBuilder::close(timestamp time, const IntervalHandler& handler)
+{
+	for (std::vector<_State>& states : _states)
+	{
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			_close_domain(states[i], domain_id(i), time, handler);
+		}
+	}
+}
+
+bool IntervalBuilder::affects_other_domains(domain_id domain) const
+{
+	if (domain >= _domains.size() || !_domains[domain].known)
+	{
+		return false;
+	}
+
+	return _domains[domain].exclusive || _domains[domain].device || _domains[domain].hosts;
+}
+
+bool IntervalBuilder::tracks_devices() const
+{
+	for (const _Domain& domain : _domains)
+	{
+		if (domain.known && domain.device)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool IntervalBuilder::is_known_entity(entity_id entity) const
+{
+	return entity < _entities.size() && _entities[entity].known;
+}
+
+IntervalBuilder::domain_id IntervalBuilder::domain_of(entity_id entity) const
+{
+	return is_known_entity(entity) ? _entities[entity].domain : 0;
+}
+
+bool IntervalBuilder::open_interval(domain_id domain, Interval& interval) const
+{
+	if (domain >= _domains.size() || !_state(domain).open)
+	{
+		return false;
+	}
+
+	const _State& state = _state(domain);
+
+	interval.domain = domain;
+	interval.entity = state.entity;
+	interval.start = state.start;
+	interval.end = state.start;
+
+	return true;
+}
+
+IntervalBuilder::_State& IntervalBuilder::_state(domain_id domain)
+{
+	return _states[_domains[domain].device ? 0 : _current_state][domain];
+}
+
+const IntervalBuilder::_State& IntervalBuilder::_state(domain_id domain) const
+{
+	return _states[_domains[domain].device ? 0 : _current_state][domain];
+}
+
+void IntervalBuilder::_close_domain(_State& state, domain_id domain, timestamp time, const IntervalHandler& handler)
+{
+	if (!state.open)
+	{
+		return;
+	}
+
+	state.open = false;
+
+	if (time > state.start)
+	{
+		handler(Interval{ domain, state.entity, state.start, time });
+	}
+}
+
+void IntervalBuilder::_open_domain(_State& state, entity_id entity, timestamp time)
+{
+	state.open = true;
+	state.entity = entity;
+	state.start = time;
+}
\ No newline at end of file
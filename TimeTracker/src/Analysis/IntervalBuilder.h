@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include <stdint.h>
+
+#include "../Utils/StringHash.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* Turns the event stream into intervals, mirroring TrackingVisualizer/FormatData.py:
+* 
+*   - Events of the Runtime, System and Activity domains close every open interval
+*     of their device but the Device one.
+*   - Events of any other domain only close the open interval of their own domain.
+*   - Focusing a host application (e.g. chrome.exe) resumes the last entity of
+*     the domain reported by its plugin (e.g. Browser).
+* 
+* The Device domain only exists in the output of the Merger, where the events
+* of several devices interleave. A Device event switches to the events of its
+* device, and every device keeps its own open intervals and last entities, so
+* the events of one device never close or resume the intervals of another.
+* open_interval() reports the intervals of the current device.
+* 
+* Every event opens a new interval for its entity, which stays open until it is
+* closed by a later event or by close().
+*/
+
+class IntervalBuilder
+{
+public:
+	using domain_id = uint8_t;
+	using entity_id = uint16_t;
+	using timestamp = TimeConverter::timestamp;
+
+	struct Interval
+	{
+		domain_id domain = 0;
+		entity_id entity = 0;
+
+		timestamp start = 0;
+		timestamp end = 0;
+	};
+
+	using IntervalHandler = std::function<void(const Interval&)>;
+
+public:
+	void add_domain(domain_id id, std::string_view name);
+	void add_entity(entity_id id, domain_id domain, std::string_view name);
+
+	bool add_event(timestamp time, entity_id entity, const IntervalHandler& handler);
+	void close(timestamp time, const IntervalHandler& handler);
+
+	bool is_known_entity(entity_id entity) const;
+	domain_id domain_of(entity_id entity) const;
+
+	bool open_interval(domain_id domain, Interval& interval) const;
+
+	// Events of exclusive, device and host application domains change the intervals of other domains
+	bool affects_other_domains(domain_id domain) const;
+
+	// True once a Device domain was added, the intervals then depend on the device of every event
+	bool tracks_devices() const;
+
+private:
+	struct _Domain
+	{
+		bool known = false;
+		bool exclusive = false;
+		bool device = false;
+		bool hosts = false;
+	};
+
+	struct _State
+	{
+		bool open = false;
+		entity_id entity = 0;
+		timestamp start = 0;
+
+		bool has_last_entity = false;
+		entity_id last_entity = 0;
+	};
+
+	struct _Entity
+	{
+		bool known = false;
+		domain_id domain = 0;
+
+		const char* hosted_domain = nullptr;
+	};
+
+	std::vector<_Domain> _domains;
+	std::vector<_Entity> _entities;
+
+	// State of every domain per device, the first one before any Device event and for the Device domain itself
+	std::vector<std::vector<_State>> _states = std::vector<std::vector<_State>>(1);
+	std::unordered_map<entity_id, size_t> _device_states;
+	size_t _current_state = 0;
+
+	StringMap<domain_id> _domain_ids;
+
+private:
+	_State& _state(domain_id domain);
+	const _State& _state(domain_id domain) const;
+
+	void _close_domain(_State& state, domain_id domain, timestamp time, const IntervalHandler& handler);
+	void _open_domain(_State& state, entity_id entity, timestamp time);
+};
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "Sessionizer.h"
+
+void Sessionizer::add_domain(domain_id id, std::string_view name)
+{
+	if (_domains.size() <= id)
+	{
+		_domains.resize(size_t(id) + 1);
+	}
+
+	_domains[id].runtime = name == "Runtime";
+	_domains[id].activity = name == "Activity";
+}
+
+void Sessionizer::add_entity(entity_id id, domain_id domain, std::string_view name)
+{
+	if (_entities.size() <= id)
+	{
+		_entities.resize(size_t(id) + 1, _Marker::NONE);
+	}
+
+	_Marker marker = _Marker::NONE;
+
+	if (domain < _domains.size() && _domains[domain].runtime)
+	{
+		marker = name == "Startup" ? _Marker::STARTUP : name == "Shutdown" ? _Marker::SHUTDOWN : _Marker::NONE;
+	}
+	else if (domain < _domains.size() && _domains[domain].activity)
+	{
+		marker = name == "Inactivity start" ? _Marker::INACTIVITY_START : name == "Inactivity end" ? _Marker::INACTIVITY_END : _Marker::NONE;
+	}
+
+	_entities[id] = marker;
+}
+
+bool Sessionizer::add_event(timestamp time, entity_id entity, const SessionHandler& handler)
+{
+	if (entity >= _entities.size())
+	{
+		return false;
+	}
+
+	switch (_entities[entity])
+	{
+	case _Marker::STARTUP:
+		if (_open && _state != State::OFF && _has_last_time)
+		{
+			_change(State::OFF, _last_time, handler);
+		}
+
+		_change(State::ACTIVE, time, handler);
+		break;
+	case _Marker::SHUTDOWN:
+		_change(State::OFF, time, handler);
+		break;
+	case _Marker::INACTIVITY_START:
+		_change(State::IDLE, time, handler);
+		break;
+	case _Marker::INACTIVITY_END:
+		_change(State::ACTIVE, time, handler);
+		break;
+	case _Marker::NONE:
+		if (!_open || _state == State::OFF)
+		{
+			_change(State::ACTIVE, time, handler);
+		}
+		break;
+	}
+
+	_has_last_time = true;
+	_last_time = time;
+
+	return true;
+}
+
+void Sessionizer::close(timestamp time, const SessionHandler& handler)
+{
+	if (!_open)
+	{
+		return;
+	}
+
+	_open = false;
+
+	if (time > _start)
+	{
+		Session session{ _state, _start, time };
+
+		_sessions.push_back(session);
+		handler(session);
+	}
+}
+
+bool Sessionizer::open_session(Session& session) const
+{
+	if (!_open)
+	{
+		return false;
+	}
+
+	session = Session{ _state, _start, _start };
+
+	return true;
+}
+
+void Sessionizer::clip(const IntervalBuilder::Interval& interval, const IntervalBuilder::IntervalHandler& handler) const
+{
+	// Sessions ending before the interval were trimmed or are skipped here
+	auto it = std::upper_bound(_sessions.begin(), _sessions.end(), interval.start, [](timestamp time, const Session& session) {
+		return time < session.end;
+	});
+
+	for (; it != _sessions.end() && it->start < interval.end; ++it)
+	{
+		timestamp start = (std::max)(interval.start, it->start);
+		timestamp end = (std::min)(interval.end, it->end);
+
+		if (it->state == State::ACTIVE && start < end)
+		{
+			handler(IntervalBuilder::Interval{ interval.domain, interval.entity, start, end });
+		}
+	}
+
+	// The open session reaches up to the newest event
+	if (_open && _state == State::ACTIVE && interval.end > (std::max)(interval.start, _start))
+	{
+		handler(IntervalBuilder::Interval{ interval.domain, interval.entity, (std::max)(interval.start, _start), interval.end });
+	}
+}
+
+void Sessionizer::trim(timestamp time)
+{
+	while (!_sessions.empty() && _sessions.front().end <= time)
+	{
+		_sessions.pop_front();
+	}
+}
+
+std::string_view Sessionizer::state_name(State state)
+{
+	switch (state)
+	{
+	case State::ACTIVE:
+		return "active";
+	case State::IDLE:
+		return "idle";
+	case State::OFF:
+		return "off";
+	}
+
+	return "";
+}
+
+void Sessionizer::_change(State state, timestamp time, const SessionHandler& handler)
+{
+	if (_open && _state == state)
+	{
+		return;
+	}
+
+	close(time, handler);
+
+	_open = true;
+	_state = state;
+	_start = time;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <algorithm>
+
+#include <stdint.h>
+
+#include "IntervalBuilder.h"
+
+#include "../Utils/TimeConverter.h"
+
+/*
+* Splits the event stream into active, idle and powered-off sessions in one
+* pass, next to an IntervalBuilder fed the same events:
+* 
+*   - Runtime Startup starts an active session, Runtime Shutdown a powered-off one.
+*   - Activity Inactivity start starts an idle session, Inactivity end an active one.
+*   - Any other event ends a powered-off session, it does not end an idle one.
+*   - A Startup without a Shutdown before it powers off at the previous event,
+*     as Database::add_event does when it back-fills the Shutdown.
+* 
+* clip() reports the parts of an interval that fall into active sessions, so
+* per-entity durations leave out the time the user was away. The sessions are
+* kept until trim() drops those no interval can reach anymore.
+*/
+
+class Sessionizer
+{
+public:
+	using domain_id = IntervalBuilder::domain_id;
+	using entity_id = IntervalBuilder::entity_id;
+	using timestamp = IntervalBuilder::timestamp;
+
+	enum class State : uint8_t
+	{
+		ACTIVE = 0,
+		IDLE = 1,
+		OFF = 2
+	};
+
+	struct Session
+	{
+		State state = State::ACTIVE;
+
+		timestamp start = 0;
+		timestamp end = 0;
+	};
+
+	using SessionHandler = std::function<void(const Session&)>;
+
+public:
+	void add_domain(domain_id id, std::string_view name);
+	void add_entity(entity_id id, domain_id domain, std::string_view name);
+
+	// Add every event here before the IntervalBuilder, so the sessions reach the intervals it closes
+	bool add_event(timestamp time, entity_id entity, const SessionHandler& handler);
+	void close(timestamp time, const SessionHandler& handler);
+
+	bool open_session(Session& session) const;
+
+	void clip(const IntervalBuilder::Interval& interval, const IntervalBuilder::IntervalHandler& handler) const;
+
+	// Forgets the sessions that end at or before the time
+	void trim(timestamp time);
+
+	static std::string_view state_name(State state);
+
+private:
+	enum class _Marker : uint8_t
+	{
+		NONE,
+		STARTUP,
+		SHUTDOWN,
+		INACTIVITY_START,
+		INACTIVITY_END
+	};
+
+	struct _Domain
+	{
+		bool runtime = false;
+		bool activity = false;
+	};
+
+	std::vector<_Domain> _domains;
+	std::vector<_Marker> _entities;
+
+	bool _open = false;
+	State _state = State::ACTIVE;
+	timestamp _start = 0;
+
+	bool _has_last_time = false;
+	timestamp _last_time = 0;
+
+	// Closed sessions that intervals may still reach, oldest first
+	std::deque<Session> _sessions;
+
+private:
+	void _change(State state, timestamp time, const SessionHandler& handler);
+};
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "SpaceSaving.h"
+
+SpaceSaving::SpaceSaving(size_t capacity)
+	: _capacity((std::max<size_t>)(capacity, 1))
+{
+	_heap.reserve(_capacity);
+	_positions.reserve(_capacity);
+}
+
+void SpaceSaving::add(key_type key, int64_t weight)
+{
+	_total += weight;
+
+	auto it = _positions.find(key);
+	if (it != _positions.end())
+	{
+		_heap[it->second].count += weight;
+		_sift_down(it->second);
+		return;
+	}
+
+	if (_heap.size() < _capacity)
+	{
+		_heap.push_back({ key, weight, 0 });
+		_positions.emplace(key, _heap.size() - 1);
+		_sift_up(_heap.size() - 1);
+		return;
+	}
+
+	// The smallest counter is taken over, its count becomes the error of the new key
+	Counter& minimum = _heap.front();
+
+	_positions.erase(minimum.key);
+	_positions.emplace(key, 0);
+
+	minimum.key = key;
+	minimum.error = minimum.count;
+	minimum.count += weight;
+
+	_sift_down(0);
+}
+
+std::vector<SpaceSaving::Counter> SpaceSaving::top(size_t n) const
+{
+	std::vector<Counter> counters = _heap;
+
+	std::sort(counters.begin(), counters.end(),
+		[](const Counter& a, const Counter& b)
+		{
+			return a.count != b.count ? a.count > b.count : a.key < b.key;
+		}
+	);
+
+	if (counters.size() > n)
+	{
+		counters.resize(n);
+	}
+
+	return counters;
+}
+
+size_t SpaceSaving::capacity() const
+{
+	return _capacity;
+}
+
+size_t SpaceSaving::size() const
+{
+	return _heap.size();
+}
+
+int64_t SpaceSaving::total() const
+{
+	return _total;
+}
+
+void SpaceSaving::_sift_down(size_t index)
+{
+	while (true)
+	{
+		size_t smallest = index;
+		size_t left = 2 * index + 1;
+		size_t right = left + 1;
+
+		if (left < _heap.size() && _heap[left].count < _heap[smallest].count)
+			smallest = left;
+		if (right < _heap.size() && _heap[right].count < _heap[smallest].count)
+			smallest = right;
+
+		if (smallest == index)
+		{
+			return;
+		}
+
+		_swap(index, smallest);
+		index = smallest;
+	}
+}
+
+void SpaceSaving::_sift_up(size_t index)
+{
+	while (index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+
+		if (_heap[parent].count <= _heap[index].count)
+		{
+			return;
+		}
+
+		_swap(index, parent);
+		index = parent;
+	}
+}
+
+void SpaceSaving::_swap(size_t a, size_t b)
+{
+	std::swap(_heap[a], _heap[b]);
+
+	_positions[_heap[a].key] = a;
+	_positions[_heap[b].key] = b;
+}
\ No newline at end of file
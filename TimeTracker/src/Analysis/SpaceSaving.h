@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include <stdint.h>
+
+/*
+* Weighted Space-Saving summary (Metwally, Agrawal and El Abbadi) over a
+* stream of (key, weight) pairs, keeping at most capacity counters.
+* 
+* When a new key arrives and the summary is full, the counter with the
+* smallest count is taken over by the new key, which inherits that count as
+* its error. The count of every tracked key overestimates its true weight by
+* at most its error, and every key whose weight exceeds total / capacity is
+* guaranteed to be tracked.
+* 
+* The counters form a min-heap on their count, so an update costs
+* O(log capacity) and memory never depends on the number of distinct keys.
+*/
+
+class SpaceSaving
+{
+public:
+	using key_type = uint32_t;
+
+	struct Counter
+	{
+		key_type key = 0;
+
+		int64_t count = 0;
+		int64_t error = 0;
+	};
+
+public:
+	SpaceSaving(size_t capacity);
+
+	void add(key_type key, int64_t weight);
+
+	// Counters by descending count, at most n of them
+	std::vector<Counter> top(size_t n) const;
+
+	size_t capacity() const;
+	size_t size() const;
+
+	int64_t total() const;
+
+private:
+	size_t _capacity;
+	int64_t _total = 0;
+
+	std::vector<Counter> _heap;
+	std::unordered_map<key_type, size_t> _positions;
+
+	void _sift_down(size_t index);
+	void _sift_up(size_t index);
+	void _swap(size_t a, size_t b);
+};
\ No newline at end of file
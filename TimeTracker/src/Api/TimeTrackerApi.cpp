@@ -0,0 +1,341 @@
+#include "TimeTrackerApi.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+
+#include "../Analysis/IntervalBuilder.h"
+
+#include "../Database/TTEFile/TTEFileDate.h"
+#include "../Database/TTEFile/TTEFileEvent.h"
+#include "../Database/TTEFile/TTEFileScanner.h"
+#include "../Database/TTRFile/TTRFileMappedReader.h"
+
+#include "../Utils/Logger.h"
+#include "../Utils/StringConverter.h"
+#include "../Utils/TimeConverter.h"
+
+// TimeConverter counts from 2000-01-01, the API from 1970-01-01
+static constexpr TimeConverter::timestamp unix_epoch_offset = 946684800;
+
+struct tt_database
+{
+	std::wstring tte_file_path;
+
+	std::vector<std::string> domain_names;
+	std::vector<std::string> entity_names;
+	std::vector<uint8_t> entity_domains;
+
+	bool events_loaded = false;
+	bool events_valid = false;
+	std::vector<int64_t> timestamps;
+	std::vector<uint16_t> entities;
+
+	bool intervals_loaded = false;
+	std::vector<IntervalBuilder::Interval> intervals;
+};
+
+static bool load_events(tt_database* database)
+{
+	if (database->events_loaded)
+	{
+		return database->events_valid;
+	}
+
+	database->events_loaded = true;
+
+	if (database->tte_file_path.empty())
+	{
+		database->events_valid = true;
+		return true;
+	}
+
+	TTEFileScanner scanner(database->tte_file_path);
+
+	if (!scanner.open())
+	{
+		return false;
+	}
+
+	std::vector<TTEFileEvent::encoded_event> events(1024);
+
+	TTEFileDate::encoded_date encoded_date = 0;
+	uint32_t num_of_events = 0;
+
+	while (scanner.next_block(encoded_date, num_of_events))
+	{
+		TTEFileDate date = TTEFileDate::decode(encoded_date);
+
+		database->timestamps.reserve(database->timestamps.size() + num_of_events);
+		database->entities.reserve(database->entities.size() + num_of_events);
+
+		size_t size = 0;
+		while ((size = scanner.read_events(events.data(), events.size())) > 0)
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				TTEFileEvent event = TTEFileEvent::decode(events[i]);
+
+				database->timestamps.push_back(TimeConverter::to_timestamp(2000 + date.year, date.month, date.day, event.hour, event.minute, event.second) + unix_epoch_offset);
+				database->entities.push_back(event.entity);
+			}
+		}
+	}
+
+	// Keeping the events before a truncated block would look like a shorter history
+	if (scanner.failed())
+	{
+		Logger::log_error("Failed to read events: {}", StringConverter::to_utf8(database->tte_file_path));
+
+		database->timestamps.clear();
+		database->entities.clear();
+		return false;
+	}
+
+	database->events_valid = true;
+
+	return true;
+}
+
+static bool load_intervals(tt_database* database)
+{
+	if (database->intervals_loaded)
+	{
+		return true;
+	}
+
+	if (!load_events(database))
+	{
+		return false;
+	}
+
+	database->intervals.clear();
+
+	IntervalBuilder builder;
+
+	for (size_t i = 0; i < database->domain_names.size(); i++)
+	{
+		builder.add_domain(IntervalBuilder::domain_id(i), database->domain_names[i]);
+	}
+
+	for (size_t i = 0; i < database->entity_names.size(); i++)
+	{
+		builder.add_entity(IntervalBuilder::entity_id(i), database->entity_domains[i], database->entity_names[i]);
+	}
+
+	auto add_interval = [database](const IntervalBuilder::Interval& interval)
+		{
+			database->intervals.push_back(interval);
+		};
+
+	for (size_t i = 0; i < database->timestamps.size(); i++)
+	{
+		builder.add_event(database->timestamps[i] - unix_epoch_offset, database->entities[i], add_interval);
+	}
+
+	if (!database->timestamps.empty())
+	{
+		builder.close(database->timestamps.back() - unix_epoch_offset, add_interval);
+	}
+
+	database->intervals_loaded = true;
+
+	return true;
+}
+
+static int64_t copy_names(const std::vector<std::string>& names, char* buffer, int64_t capacity)
+{
+	int64_t size = 0;
+
+	for (const std::string& name : names)
+	{
+		int64_t length = int64_t(name.size()) + 1;
+
+		if (buffer != nullptr && size + length <= capacity)
+		{
+			std::memcpy(buffer + size, name.c_str(), size_t(length));
+		}
+
+		size += length;
+	}
+
+	return size;
+}
+
+int32_t tt_version(void)
+{
+	return TIME_TRACKER_API_VERSION;
+}
+
+tt_database* tt_open(const char* ttr_file_path, const char* tte_file_path)
+{
+	try
+	{
+		std::unique_ptr<tt_database> database = std::make_unique<tt_database>();
+
+		if (tte_file_path != nullptr)
+		{
+			database->tte_file_path = StringConverter::to_utf16(tte_file_path);
+		}
+
+		if (ttr_file_path == nullptr)
+		{
+			return database.release();
+		}
+
+		TTRFileMappedReader registry(StringConverter::to_utf16(ttr_file_path));
+
+		if (!registry.reload())
+		{
+			Logger::log_error("Failed to open registry: {}", ttr_file_path);
+			return nullptr;
+		}
+
+		for (std::string_view domain : registry.domains())
+		{
+			database->domain_names.emplace_back(domain);
+		}
+
+		for (const TTRFileMappedReader::Entity& entity : registry.entities())
+		{
+			database->entity_names.emplace_back(entity.name);
+			database->entity_domains.push_back(entity.domain_id);
+		}
+
+		return database.release();
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void tt_close(tt_database* database)
+{
+	delete database;
+}
+
+int64_t tt_domain_names(tt_database* database, char* names, int64_t capacity)
+{
+	try
+	{
+		if (database == nullptr)
+		{
+			return -1;
+		}
+
+		return copy_names(database->domain_names, names, capacity);
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+int64_t tt_entity_names(tt_database* database, char* names, int64_t capacity)
+{
+	try
+	{
+		if (database == nullptr)
+		{
+			return -1;
+		}
+
+		return copy_names(database->entity_names, names, capacity);
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+int64_t tt_entity_domains(tt_database* database, uint8_t* domains, int64_t capacity)
+{
+	try
+	{
+		if (database == nullptr)
+		{
+			return -1;
+		}
+
+		int64_t count = int64_t(database->entity_domains.size());
+
+		if (domains != nullptr && capacity > 0)
+		{
+			std::memcpy(domains, database->entity_domains.data(), size_t((std::min)(count, capacity)));
+		}
+
+		return count;
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+int64_t tt_read_events(tt_database* database, int64_t* timestamps, uint16_t* entities, int64_t capacity)
+{
+	try
+	{
+		if (database == nullptr || !load_events(database))
+		{
+			return -1;
+		}
+
+		int64_t count = int64_t(database->timestamps.size());
+		size_t n = size_t((std::max<int64_t>)((std::min)(count, capacity), 0));
+
+		if (timestamps != nullptr)
+		{
+			std::memcpy(timestamps, database->timestamps.data(), n * sizeof(int64_t));
+		}
+
+		if (entities != nullptr)
+		{
+			std::memcpy(entities, database->entities.data(), n * sizeof(uint16_t));
+		}
+
+		return count;
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+int64_t tt_read_intervals(tt_database* database, int64_t* starts, int64_t* ends, uint8_t* domains, uint16_t* entities, int64_t capacity)
+{
+	try
+	{
+		if (database == nullptr || !load_intervals(database))
+		{
+			return -1;
+		}
+
+		int64_t count = int64_t(database->intervals.size());
+		size_t n = size_t((std::max<int64_t>)((std::min)(count, capacity), 0));
+
+		for (size_t i = 0; i < n; i++)
+		{
+			const IntervalBuilder::Interval& interval = database->intervals[i];
+
+			if (starts != nullptr)
+				starts[i] = interval.start + unix_epoch_offset;
+			if (ends != nullptr)
+				ends[i] = interval.end + unix_epoch_offset;
+			if (domains != nullptr)
+				domains[i] = interval.domain;
+			if (entities != nullptr)
+				entities[i] = interval.entity;
+		}
+
+		return count;
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
\ No newline at end of file
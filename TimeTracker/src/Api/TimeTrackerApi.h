@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+* Stable C ABI over the TTE/TTR readers, used by the TrackingVisualizer
+* through ctypes.
+* 
+* A handle is a snapshot of a TTE/TTR pair: the registry is read on open and
+* the events and intervals are decoded on first use and kept, reopen to see
+* newer events.
+* 
+* Every bulk function returns the total number of items and fills at most
+* capacity of them, so a first call with a capacity of 0 sizes the buffers.
+* Invalid handles and unreadable files return -1. No exception leaves the
+* API, a failure inside it, like running out of memory, returns -1 or NULL.
+* 
+*   - Timestamps are local time in seconds since 1970-01-01, numpy's
+*     datetime64[s] without a time zone.
+*   - Names are UTF-8 and every name is followed by a NUL byte, the name
+*     functions return the number of bytes including them.
+*   - Intervals are built like the ones of IntervalBuilder, intervals still
+*     open after the last event are closed at its time.
+*/
+
+#ifdef _WIN32
+#define TIME_TRACKER_API __declspec(dllexport)
+#else
+#define TIME_TRACKER_API __attribute__((visibility("default")))
+#endif
+
+// Incremented whenever a signature or a layout changes
+#define TIME_TRACKER_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct tt_database tt_database;
+
+TIME_TRACKER_API int32_t tt_version(void);
+
+// Paths are UTF-8, either may be NULL to read only the registry or only the events
+// Returns NULL if the registry can't be read
+TIME_TRACKER_API tt_database* tt_open(const char* ttr_file_path, const char* tte_file_path);
+TIME_TRACKER_API void tt_close(tt_database* database);
+
+TIME_TRACKER_API int64_t tt_domain_names(tt_database* database, char* names, int64_t capacity);
+TIME_TRACKER_API int64_t tt_entity_names(tt_database* database, char* names, int64_t capacity);
+
+// Domain ID of every entity
+TIME_TRACKER_API int64_t tt_entity_domains(tt_database* database, uint8_t* domains, int64_t capacity);
+
+TIME_TRACKER_API int64_t tt_read_events(tt_database* database, int64_t* timestamps, uint16_t* entities, int64_t capacity);
+
+TIME_TRACKER_API int64_t tt_read_intervals(tt_database* database, int64_t* starts, int64_t* ends, uint8_t* domains, uint16_t* entities, int64_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -8,6 +8,20 @@ std::condition_variable RemoteTimeTracker::_has_stopped{};
 
 std::mutex RemoteTimeTracker::_mutex{};
 
+std::atomic<size_t> RemoteTimeTracker::_num_of_subscribers = 0;
+
+std::atomic<bool> RemoteTimeTracker::_datagram_running = false;
+std::atomic<bool> RemoteTimeTracker::_datagram_should_run = false;
+
+Metrics::Counter& RemoteTimeTracker::_requests = Metrics::counter("timetracker_remote_requests_total", "HTTP requests handled");
+Metrics::Counter& RemoteTimeTracker::_rejected_requests = Metrics::counter("timetracker_remote_rejected_requests_total", "HTTP requests with a rejected body, parameter or batch record");
+Metrics::Counter& RemoteTimeTracker::_received_datagrams = Metrics::counter("timetracker_remote_datagrams_total", "Datagrams received on the local UDP channel");
+
+Metrics::Counter& RemoteTimeTracker::_valid_records = Metrics::counter("timetracker_remote_records_total", "Event records received over HTTP and UDP by outcome", "result=\"valid\"");
+Metrics::Counter& RemoteTimeTracker::_invalid_records = Metrics::counter("timetracker_remote_records_total", "Event records received over HTTP and UDP by outcome", "result=\"invalid\"");
+
+Metrics::Gauge& RemoteTimeTracker::_stream_subscribers = Metrics::gauge("timetracker_remote_stream_subscribers", "Connected /stream subscribers");
+
 RemoteTimeTracker::RemoteTimeTracker()
 {
 	if (!RemoteTimeTracker::_running)
@@ -50,20 +64,42 @@ bool RemoteTimeTracker::start()
 
 	_server.Post("/", [](const httplib::Request& req, httplib::Response& res)
 		{
-			std::string body = req.body;
-			if (_is_valid_body(body))
+			TRACE_SPAN("RemoteTimeTracker::POST /");
+
+			std::string_view domain, entity, tail;
+			if (_parse_body(req.body, domain, entity, tail) && tail.empty())
 			{
-				_handle_valid_body(body);
+				_handle_valid_body(domain, entity);
+				_valid_records.increment();
 				res.set_content("VALID", "text/plain");
 			}
 			else
 			{
-				res.set_content("INVALID", "text/plain");
+				_invalid_records.increment();
+				_reject(res);
 			}
 		});
 
+	_server.Post("/batch", [](const httplib::Request& req, httplib::Response& res)
+		{
+			TRACE_SPAN("RemoteTimeTracker::POST /batch");
+
+			res.set_content(_handle_batch_body(req.body), "text/plain");
+		});
+
+	_server.Get("/events", _handle_events_query);
+	_server.Get("/totals", _handle_totals_query);
+	_server.Get("/histogram", _handle_histogram_query);
+	_server.Get("/sessions", _handle_sessions_query);
+	_server.Get("/state", _handle_state_query);
+	_server.Get("/stream", _handle_stream);
+	_server.Get("/metrics", _handle_metrics_query);
+	_server.Get("/trace", _handle_trace_query);
+
 	_server.set_logger([](const httplib::Request& req, const httplib::Response& res)
 		{
+			_requests.increment();
+
 			DEBUG_LOG_LINE("Received request: " << req.method << " " << req.path << " " << res.status);
 		});
 
@@ -76,6 +112,15 @@ bool RemoteTimeTracker::start()
 
 	server_thread.detach();
 
+	RemoteTimeTracker::_datagram_should_run = true;
+
+	// Set before the thread exists, so a stop() right after start() waits for it
+	RemoteTimeTracker::_datagram_running = true;
+
+	std::thread datagram_thread(_datagram_thread);
+
+	datagram_thread.detach();
+
 	return true;
 }
 
@@ -83,7 +128,7 @@ bool RemoteTimeTracker::stop()
 {
 	std::unique_lock<std::mutex> lock(RemoteTimeTracker::_mutex);
 
-	if (!RemoteTimeTracker::_running)
+	if (!RemoteTimeTracker::_running && !RemoteTimeTracker::_datagram_running)
 	{
 		Logger::log_warning("RemoteTimeTracker is not running");
 		return true;
@@ -91,7 +136,9 @@ bool RemoteTimeTracker::stop()
 
 	_server.stop();
 
-	RemoteTimeTracker::_has_stopped.wait(lock, [] { return !RemoteTimeTracker::_running; });
+	RemoteTimeTracker::_datagram_should_run = false;
+
+	RemoteTimeTracker::_has_stopped.wait(lock, [] { return !RemoteTimeTracker::_running && !RemoteTimeTracker::_datagram_running; });
 
 	return true;
 }
@@ -104,20 +151,165 @@ void RemoteTimeTracker::_server_thread()
 
 	_server.listen("localhost", REMOTE_TIME_TRACKER_PORT);
 
+	std::unique_lock<std::mutex> lock(RemoteTimeTracker::_mutex);
+
 	RemoteTimeTracker::_running = false;
 
 	RemoteTimeTracker::_has_stopped.notify_all();
 }
 
-bool RemoteTimeTracker::_is_valid_body(const std::string& body)
+void RemoteTimeTracker::_datagram_thread()
+{
+	socket_t sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (sock == INVALID_SOCKET)
+	{
+		Logger::log_error("Failed to create datagram socket");
+		_datagram_stopped();
+		return;
+	}
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(REMOTE_TIME_TRACKER_DATAGRAM_PORT);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		Logger::log_error("Failed to bind datagram socket to port {}", REMOTE_TIME_TRACKER_DATAGRAM_PORT);
+		httplib::detail::close_socket(sock);
+		_datagram_stopped();
+		return;
+	}
+
+	Logger::log_info("RemoteTimeTracker datagram channel listening on port {}", REMOTE_TIME_TRACKER_DATAGRAM_PORT);
+
+	// One spare byte tells a datagram that fits from one cut off at the limit
+	char buffer[_max_datagram_size + 1];
+
+	while (RemoteTimeTracker::_datagram_should_run)
+	{
+		// Wake up periodically so stop() does not depend on closing the socket under a blocked recvfrom
+		if (httplib::detail::select_read(sock, 0, 250000) <= 0)
+		{
+			continue;
+		}
+
+		auto received = recvfrom(sock, buffer, static_cast<int>(sizeof(buffer)), 0, nullptr, nullptr);
+
+		if (received <= 0)
+		{
+			continue;
+		}
+
+		_received_datagrams.increment();
+
+		if (static_cast<size_t>(received) > _max_datagram_size)
+		{
+			_invalid_records.increment();
+			DEBUG_LOG_LINE("Dropped datagram larger than " << _max_datagram_size << " bytes");
+			continue;
+		}
+
+		std::string_view domain, entity, tail;
+		if (_parse_body(std::string_view(buffer, received), domain, entity, tail) && tail.empty())
+		{
+			_handle_valid_body(domain, entity);
+			_valid_records.increment();
+		}
+		else
+		{
+			_invalid_records.increment();
+			DEBUG_LOG_LINE("Received invalid datagram: " << std::string_view(buffer, received));
+		}
+	}
+
+	httplib::detail::close_socket(sock);
+
+	_datagram_stopped();
+}
+
+void RemoteTimeTracker::_datagram_stopped()
+{
+	// Under the mutex, or stop() may check the flag before it changes and miss the notification
+	std::unique_lock<std::mutex> lock(RemoteTimeTracker::_mutex);
+
+	RemoteTimeTracker::_datagram_running = false;
+
+	RemoteTimeTracker::_has_stopped.notify_all();
+}
+
+bool RemoteTimeTracker::_parse_body(std::string_view body, std::string_view& domain, std::string_view& entity, std::string_view& tail)
+{
+	if (body.size() < 5 || !body.starts_with("TTE:"))
+	{
+		return false;
+	}
+
+	size_t separators[2] = { 0, 0 };
+	size_t num_of_separators = 0;
+
+	for (size_t i = 4; i < body.size(); i++)
+	{
+		if (body[i] != ':')
+		{
+			continue;
+		}
+
+		if (num_of_separators == 2)
+		{
+			return false;
+		}
+
+		separators[num_of_separators++] = i;
+	}
+
+	if (num_of_separators != 2)
+	{
+		return false;
+	}
+
+	domain = body.substr(4, separators[0] - 4);
+	entity = body.substr(separators[0] + 1, separators[1] - separators[0] - 1);
+	tail = body.substr(separators[1] + 1);
+
+	return true;
+}
+
+void RemoteTimeTracker::_handle_valid_body(std::string_view domain, std::string_view entity)
 {
-	if (body.empty() || body.size() < 5 || !body.starts_with("TTE:") || !body.ends_with(":"))
+	time_t now = time(nullptr);
+	std::tm local_time;
+	Platform::local_time(now, local_time);
+
+	Database::add_event(domain, entity, local_time);
+}
+
+bool RemoteTimeTracker::_parse_batch_record(std::string_view record, Database::Event& event)
+{
+	std::string_view timestamp;
+	if (!_parse_body(record, event.domain, event.entity, timestamp))
 	{
 		return false;
 	}
 
-	size_t count = std::count(body.begin(), body.end(), ':');
-	if (count != 3)
+	if (timestamp.empty() || timestamp.size() > 18)
+	{
+		return false;
+	}
+
+	std::time_t time = 0;
+	for (char c : timestamp)
+	{
+		if (c < '0' || c > '9')
+		{
+			return false;
+		}
+
+		time = time * 10 + (c - '0');
+	}
+
+	if (!Platform::local_time(time, event.time))
 	{
 		return false;
 	}
@@ -125,22 +317,470 @@ bool RemoteTimeTracker::_is_valid_body(const std::string& body)
 	return true;
 }
 
-void RemoteTimeTracker::_handle_valid_body(const std::string& body)
+std::string RemoteTimeTracker::_handle_batch_body(std::string_view body)
+{
+	std::vector<Database::Event> events;
+	std::vector<bool> parsed;
+
+	while (!body.empty())
+	{
+		size_t end = body.find('\n');
+		std::string_view record = body.substr(0, end);
+
+		body.remove_prefix(end == std::string_view::npos ? body.size() : end + 1);
+
+		if (!record.empty() && record.back() == '\r')
+		{
+			record.remove_suffix(1);
+		}
+
+		if (record.empty())
+		{
+			continue;
+		}
+
+		Database::Event event;
+		bool valid = _parse_batch_record(record, event);
+
+		parsed.push_back(valid);
+		if (valid)
+		{
+			events.push_back(event);
+		}
+	}
+
+	std::vector<bool> added;
+	size_t num_added = Database::add_events(events, added);
+
+	Logger::log_info("Batch request: {} records, {} added", parsed.size(), num_added);
+
+	std::string response;
+	response.reserve(parsed.size() * 8);
+
+	size_t event_index = 0;
+	bool rejected = false;
+
+	for (bool valid : parsed)
+	{
+		bool success = valid && added[event_index++];
+		response += success ? "VALID\n" : "INVALID\n";
+
+		(success ? _valid_records : _invalid_records).increment();
+		rejected = rejected || !success;
+	}
+
+	// Counted once per request, the records are counted by _invalid_records
+	if (rejected)
+	{
+		_rejected_requests.increment();
+	}
+
+	return response;
+}
+
+void RemoteTimeTracker::_reject(httplib::Response& res)
+{
+	_rejected_requests.increment();
+	res.set_content("INVALID", "text/plain");
+}
+
+bool RemoteTimeTracker::_parse_range(const httplib::Request& req, TimeConverter::timestamp& from, TimeConverter::timestamp& to)
+{
+	from = 0;
+	to = (std::numeric_limits<TimeConverter::timestamp>::max)();
+
+	if (req.has_param("from") && !TimeConverter::parse(req.get_param_value("from"), from))
+	{
+		return false;
+	}
+
+	if (req.has_param("to") && !TimeConverter::parse(req.get_param_value("to"), to))
+	{
+		return false;
+	}
+
+	return from <= to;
+}
+
+size_t RemoteTimeTracker::_parse_count(const httplib::Request& req, const std::string& name, size_t default_value, size_t max_value)
 {
-	std::string domain;
-	std::string entity;
+	if (!req.has_param(name))
+	{
+		return default_value;
+	}
+
+	std::string value = req.get_param_value(name);
 
-	size_t start = 4;
-	size_t end = body.find(':', start);
-	domain = body.substr(start, end - start);
+	size_t count = 0;
+	auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
 
-	start = end + 1;
-	end = body.find(':', start);
-	entity = body.substr(start, end - start);
+	if (error != std::errc() || end != value.data() + value.size())
+	{
+		return default_value;
+	}
+
+	return (std::min)(count, max_value);
+}
+
+void RemoteTimeTracker::_handle_events_query(const httplib::Request& req, httplib::Response& res)
+{
+	TRACE_SPAN("RemoteTimeTracker::_handle_events_query");
 
-	std::time_t now = std::time(nullptr);
+	TimeConverter::timestamp from, to;
+	if (!_parse_range(req, from, to))
+	{
+		res.status = 400;
+		_reject(res);
+		return;
+	}
+
+	size_t offset = _parse_count(req, "offset", 0, (std::numeric_limits<size_t>::max)());
+	size_t limit = _parse_count(req, "limit", _default_page_size, _max_page_size);
+
+	size_t sent = 0;
+
+	res.set_chunked_content_provider("application/json",
+		[from, to, offset, limit, sent](size_t, httplib::DataSink& sink) mutable
+		{
+			const EventIndex& index = Database::index();
+
+			std::string chunk = sent == 0 ? "{\"events\":[" : "";
+
+			std::vector<EventIndex::Event> events;
+			bool has_more = index.get_events(from, to, offset + sent, (std::min)(_events_per_chunk, limit - sent), events);
+
+			for (const EventIndex::Event& event : events)
+			{
+				chunk += Format::format("{}{{\"time\":\"{}\",\"domain\":{},\"entity\":{}}}",
+					sent++ == 0 ? "" : ",",
+					TimeConverter::to_string(event.time),
+					StringConverter::to_json(index.domain_name(event.domain)),
+					StringConverter::to_json(index.entity_name(event.entity)));
+			}
+
+			bool finished = !has_more || sent == limit || events.empty();
+
+			if (finished)
+			{
+				chunk += has_more ? Format::format("],\"next\":{}}}", offset + sent) : "],\"next\":null}";
+			}
+
+			if (!sink.write(chunk.data(), chunk.size()))
+			{
+				return false;
+			}
+
+			if (finished)
+			{
+				sink.done();
+			}
+
+			return true;
+		});
+}
+
+void RemoteTimeTracker::_handle_totals_query(const httplib::Request& req, httplib::Response& res)
+{
+	TRACE_SPAN("RemoteTimeTracker::_handle_totals_query");
+
+	TimeConverter::timestamp from, to;
+	if (!_parse_range(req, from, to))
+	{
+		res.status = 400;
+		_reject(res);
+		return;
+	}
+
+	const EventIndex& index = Database::index();
+
+	bool filter_domain = req.has_param("domain");
+	EventIndex::domain_id domain = 0;
+
+	if (filter_domain && !index.find_domain(req.get_param_value("domain"), domain))
+	{
+		res.set_content("{\"totals\":[]}", "application/json");
+		return;
+	}
+
+	size_t limit = _parse_count(req, "limit", _default_page_size, _max_page_size);
+
+	time_t now = time(nullptr);
 	std::tm local_time;
-	localtime_s(&local_time, &now);
+	Platform::local_time(now, local_time);
 
-	Database::add_event(domain, entity, local_time);
+	std::vector<EventIndex::Total> totals;
+	index.get_totals(from, to, TimeConverter::to_timestamp(local_time), totals);
+
+	std::string body = "{\"totals\":[";
+
+	size_t count = 0;
+	for (const EventIndex::Total& total : totals)
+	{
+		if (count == limit)
+		{
+			break;
+		}
+
+		if (filter_domain && total.domain != domain)
+		{
+			continue;
+		}
+
+		body += Format::format("{}{{\"domain\":{},\"entity\":{},\"seconds\":{},\"active_seconds\":{}}}",
+			count++ == 0 ? "" : ",",
+			StringConverter::to_json(index.domain_name(total.domain)),
+			StringConverter::to_json(index.entity_name(total.entity)),
+			total.duration, total.active_duration);
+	}
+
+	body += "]}";
+
+	res.set_content(body, "application/json");
+}
+
+void RemoteTimeTracker::_handle_histogram_query(const httplib::Request& req, httplib::Response& res)
+{
+	TRACE_SPAN("RemoteTimeTracker::_handle_histogram_query");
+
+	TimeConverter::timestamp from, to;
+	if (!_parse_range(req, from, to))
+	{
+		res.status = 400;
+		_reject(res);
+		return;
+	}
+
+	std::string cycle_name = req.has_param("cycle") ? req.get_param_value("cycle") : "day";
+	Histogram::Cycle cycle = cycle_name == "week" ? Histogram::Cycle::WEEK : Histogram::Cycle::DAY;
+
+	TimeConverter::timestamp bucket_size = TimeConverter::timestamp(_parse_count(req, "bucket", 60, 24 * 60)) * 60;
+
+	if ((cycle_name != "day" && cycle_name != "week") || !Histogram::valid_bucket_size(bucket_size))
+	{
+		res.status = 400;
+		_reject(res);
+		return;
+	}
+
+	const EventIndex& index = Database::index();
+
+	bool filter_domain = req.has_param("domain");
+	EventIndex::domain_id domain = 0;
+
+	if (filter_domain && !index.find_domain(req.get_param_value("domain"), domain))
+	{
+		res.set_content(Format::format("{{\"cycle\":\"{}\",\"bucket_seconds\":{},\"entities\":[]}}", cycle_name, bucket_size), "application/json");
+		return;
+	}
+
+	Histogram histogram;
+	index.get_histogram(from, to, cycle, bucket_size, _histogram_threads, histogram);
+
+	std::string body = Format::format("{{\"cycle\":\"{}\",\"bucket_seconds\":{},\"entities\":[", cycle_name, bucket_size);
+
+	size_t count = 0;
+	for (size_t entity = 0; entity < histogram.num_of_entities(); entity++)
+	{
+		EventIndex::entity_id id = EventIndex::entity_id(entity);
+		EventIndex::domain_id entity_domain = index.domain_of(id);
+
+		if (!histogram.has_data(id) || (filter_domain && entity_domain != domain))
+		{
+			continue;
+		}
+
+		std::string seconds, events;
+
+		for (size_t bucket = 0; bucket < histogram.num_of_buckets(); bucket++)
+		{
+			seconds += Format::format("{}{}", bucket == 0 ? "" : ",", histogram.duration(id, bucket));
+			events += Format::format("{}{}", bucket == 0 ? "" : ",", histogram.events(id, bucket));
+		}
+
+		body += Format::format("{}{{\"domain\":{},\"entity\":{},\"seconds\":[{}],\"events\":[{}]}}",
+			count++ == 0 ? "" : ",",
+			StringConverter::to_json(index.domain_name(entity_domain)),
+			StringConverter::to_json(index.entity_name(id)),
+			seconds, events);
+	}
+
+	body += "]}";
+
+	res.set_content(body, "application/json");
+}
+
+void RemoteTimeTracker::_handle_sessions_query(const httplib::Request& req, httplib::Response& res)
+{
+	TRACE_SPAN("RemoteTimeTracker::_handle_sessions_query");
+
+	TimeConverter::timestamp from, to;
+	if (!_parse_range(req, from, to))
+	{
+		res.status = 400;
+		_reject(res);
+		return;
+	}
+
+	std::vector<EventIndex::SessionDay> days;
+	Database::index().get_sessions(from, to, days);
+
+	std::string body = "{\"days\":[";
+
+	for (size_t i = 0; i < days.size(); i++)
+	{
+		int year, month, day;
+		TimeConverter::to_date(days[i].day, year, month, day);
+
+		body += Format::format("{}{{\"day\":\"{:04}-{:02}-{:02}\",\"active_seconds\":{},\"idle_seconds\":{},\"off_seconds\":{}}}",
+			i == 0 ? "" : ",",
+			year, month, day,
+			days[i].active, days[i].idle, days[i].off);
+	}
+
+	body += "]}";
+
+	res.set_content(body, "application/json");
+}
+
+void RemoteTimeTracker::_handle_state_query(const httplib::Request& req, httplib::Response& res)
+{
+	TRACE_SPAN("RemoteTimeTracker::_handle_state_query");
+
+	const EventIndex& index = Database::index();
+
+	std::vector<EventIndex::State> states;
+	index.get_state(states);
+
+	std::string body = "{\"state\":[";
+
+	for (size_t i = 0; i < states.size(); i++)
+	{
+		body += Format::format("{}{{\"domain\":{},\"entity\":{},\"since\":\"{}\"}}",
+			i == 0 ? "" : ",",
+			StringConverter::to_json(index.domain_name(states[i].domain)),
+			StringConverter::to_json(index.entity_name(states[i].entity)),
+			TimeConverter::to_string(states[i].since));
+	}
+
+	body += "]}";
+
+	res.set_content(body, "application/json");
+}
+
+void RemoteTimeTracker::_handle_stream(const httplib::Request& req, httplib::Response& res)
+{
+	// Every subscriber occupies a server worker, so cap them to keep ingestion responsive
+	if (++_num_of_subscribers > _max_subscribers)
+	{
+		--_num_of_subscribers;
+
+		res.status = 503;
+		res.set_content("TOO MANY SUBSCRIBERS", "text/plain");
+		return;
+	}
+
+	_stream_subscribers.add(1);
+
+	const EventStream& stream = Database::stream();
+
+	uint64_t cursor = stream.next_sequence();
+
+	if (req.has_header("Last-Event-ID"))
+	{
+		std::string last_id = req.get_header_value("Last-Event-ID");
+
+		uint64_t sequence = 0;
+		auto [end, error] = std::from_chars(last_id.data(), last_id.data() + last_id.size(), sequence);
+
+		if (error == std::errc() && sequence < cursor)
+		{
+			cursor = sequence + 1;
+		}
+	}
+
+	size_t idle_polls = 0;
+
+	res.set_header("Cache-Control", "no-cache");
+	res.set_chunked_content_provider("text/event-stream",
+		[cursor, idle_polls](size_t, httplib::DataSink& sink) mutable
+		{
+			if (!_server.is_running())
+			{
+				sink.done();
+				return true;
+			}
+
+			std::vector<EventStream::Message> messages;
+			EventStream::ReadResult result = Database::stream().read(cursor, messages, _events_per_chunk, _stream_poll_interval);
+
+			std::string chunk;
+
+			switch (result)
+			{
+			case EventStream::ReadResult::MESSAGES:
+				idle_polls = 0;
+				for (const EventStream::Message& message : messages)
+				{
+					chunk += _format_stream_message(message);
+				}
+				break;
+			case EventStream::ReadResult::TIMEOUT:
+				if (++idle_polls < _stream_keep_alive_polls)
+				{
+					return true;
+				}
+				idle_polls = 0;
+				chunk = ": keep-alive\n\n";
+				break;
+			case EventStream::ReadResult::OVERRUN:
+				Logger::log_warning("Disconnecting slow stream subscriber");
+				chunk = "event: overrun\ndata: {}\n\n";
+				sink.write(chunk.data(), chunk.size());
+				return false;
+			case EventStream::ReadResult::CLOSED:
+				sink.done();
+				return true;
+			}
+
+			return sink.write(chunk.data(), chunk.size());
+		},
+		[](bool)
+		{
+			--_num_of_subscribers;
+			_stream_subscribers.add(-1);
+		});
+}
+
+void RemoteTimeTracker::_handle_metrics_query(const httplib::Request& req, httplib::Response& res)
+{
+	res.set_content(Metrics::to_text(), "text/plain; version=0.0.4");
+}
+
+std::string RemoteTimeTracker::_format_stream_message(const EventStream::Message& message)
+{
+	const EventIndex& index = Database::index();
+
+	std::string domain = StringConverter::to_json(index.domain_name(message.domain));
+	std::string entity = StringConverter::to_json(index.entity_name(message.entity));
+
+	if (message.type == EventStream::MessageType::INTERVAL)
+	{
+		return Format::format("id: {}\nevent: interval\ndata: {{\"domain\":{},\"entity\":{},\"start\":\"{}\",\"end\":\"{}\",\"seconds\":{}}}\n\n",
+			message.sequence, domain, entity,
+			TimeConverter::to_string(message.start), TimeConverter::to_string(message.end),
+			message.end - message.start);
+	}
+
+	return Format::format("id: {}\nevent: event\ndata: {{\"domain\":{},\"entity\":{},\"time\":\"{}\"}}\n\n",
+		message.sequence, domain, entity, TimeConverter::to_string(message.start));
+}
+
+void RemoteTimeTracker::_handle_trace_query(const httplib::Request& req, httplib::Response& res)
+{
+	res.set_content(Trace::to_json(), "application/json");
+
+	if (req.has_param("clear"))
+	{
+		Trace::clear();
+	}
 }
\ No newline at end of file
@@ -1,7 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <charconv>
 #include <condition_variable>
 #include <mutex>
 
@@ -10,18 +16,58 @@
 #include "../Database/Database.h"
 
 #include "../Utils/httplib.h"
+#include "../Utils/Format.h"
 #include "../Utils/Logger.h"
+#include "../Utils/Metrics.h"
+#include "../Utils/Trace.h"
+#include "../Utils/Platform.h"
+#include "../Utils/StringConverter.h"
+#include "../Utils/TimeConverter.h"
 
 /*
 * Request body format:
 * 
-* TTE:<domain>:<entity>:
+* POST /
+*   TTE:<domain>:<entity>:
+* 
+* POST /batch
+*   TTE:<domain>:<entity>:<unix_time>    [one record per line]
+* 
+* The batch response contains one line per record, VALID or INVALID,
+* in the same order as the request.
+* 
+* UDP datagram on localhost:
+*   TTE:<domain>:<entity>:               [one event per datagram, no response]
+* 
+* Queries (JSON, served from the Database's EventIndex):
+* 
+* GET /events?from=&to=&offset=&limit=   Events in [from, to), streamed in chunks
+* GET /totals?from=&to=&domain=&limit=   Time per entity, rolled up per day, and the
+*                                        part of it in active sessions, open intervals
+*                                        counted up to now
+* GET /histogram?from=&to=&domain=&cycle=&bucket=
+*                                        Time and events per entity over the time of
+*                                        the day (cycle=day) or the week (cycle=week),
+*                                        one array element per bucket of minutes
+* GET /sessions?from=&to=                Active, idle and powered-off time per day
+* GET /state                             Currently open interval per domain
+* GET /stream                            Server-sent events for every committed
+*                                        event and closed interval
+* GET /metrics                           Runtime metrics in the Prometheus text format
+* GET /trace?clear=                      Recorded trace spans as Chrome trace JSON, empty
+*                                        unless built with TIME_TRACKER_TRACING
+* 
+* from/to are local times formatted as YYYY-MM-DD or YYYY-MM-DDTHH:MM:SS.
 */
 
 #ifndef REMOTE_TIME_TRACKER_PORT
 #define REMOTE_TIME_TRACKER_PORT 'R' + 'T' * 'T' // 7138
 #endif
 
+#ifndef REMOTE_TIME_TRACKER_DATAGRAM_PORT
+#define REMOTE_TIME_TRACKER_DATAGRAM_PORT REMOTE_TIME_TRACKER_PORT
+#endif
+
 class RemoteTimeTracker
 {
 public:
@@ -39,11 +85,63 @@ private:
 
 	static std::mutex _mutex;
 
+private:
+	static std::atomic<bool> _datagram_running;
+	static std::atomic<bool> _datagram_should_run;
+
+	static constexpr size_t _max_datagram_size = 1024;
+
+	static constexpr size_t _default_page_size = 1000;
+	static constexpr size_t _max_page_size = 10000;
+	static constexpr size_t _events_per_chunk = 256;
+
+	// Histograms replay the whole index, but the server workers share the cores
+	static constexpr size_t _histogram_threads = 2;
+
+	static std::atomic<size_t> _num_of_subscribers;
+
+	static constexpr size_t _max_subscribers = 4;
+	static constexpr std::chrono::milliseconds _stream_poll_interval{ 1000 };
+	static constexpr size_t _stream_keep_alive_polls = 15;
+
+private:
+	static Metrics::Counter& _requests;
+	static Metrics::Counter& _rejected_requests;
+	static Metrics::Counter& _received_datagrams;
+
+	static Metrics::Counter& _valid_records;
+	static Metrics::Counter& _invalid_records;
+
+	static Metrics::Gauge& _stream_subscribers;
+
 private:
 	static void _server_thread();
+	static void _datagram_thread();
+	static void _datagram_stopped();
 
 private:
-	static bool _is_valid_body(const std::string& body);
-	static void _handle_valid_body(const std::string& body);
+	static bool _parse_body(std::string_view body, std::string_view& domain, std::string_view& entity, std::string_view& tail);
+	static void _handle_valid_body(std::string_view domain, std::string_view entity);
+
+	static bool _parse_batch_record(std::string_view record, Database::Event& event);
+	static std::string _handle_batch_body(std::string_view body);
+
+	static void _reject(httplib::Response& res);
+
+private:
+	static bool _parse_range(const httplib::Request& req, TimeConverter::timestamp& from, TimeConverter::timestamp& to);
+	static size_t _parse_count(const httplib::Request& req, const std::string& name, size_t default_value, size_t max_value);
+
+	static void _handle_events_query(const httplib::Request& req, httplib::Response& res);
+	static void _handle_totals_query(const httplib::Request& req, httplib::Response& res);
+	static void _handle_histogram_query(const httplib::Request& req, httplib::Response& res);
+	static void _handle_sessions_query(const httplib::Request& req, httplib::Response& res);
+	static void _handle_state_query(const httplib::Request& req, httplib::Response& res);
+
+	static void _handle_stream(const httplib::Request& req, httplib::Response& res);
+
+	static void _handle_metrics_query(const httplib::Request& req, httplib::Response& res);
+	static void _handle_trace_query(const httplib::Request& req, httplib::Response& res);
+	static std::string _format_stream_message(const EventStream::Message& message);
 };
 
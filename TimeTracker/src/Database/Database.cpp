@@ -3,36 +3,136 @@
 TTRFileWriter* Database::_registry = nullptr;
 TTEFileWriter* Database::_events = nullptr;
 
+TTESegmentManifest* Database::_manifest = nullptr;
+std::wstring Database::_events_file_path{};
+
 std::mutex Database::_mutex{};
 
-bool Database::add_event(const std::string& domain, const std::string& entity)
+EventIndex Database::_index{};
+EventStream Database::_stream(_stream_capacity);
+
+StringMap<TTRFileWriter::domain_id> Database::_domain_ids{};
+std::vector<StringMap<TTRFileWriter::entity_id>> Database::_entity_ids{};
+
+Metrics::Histogram& Database::_add_event_latency = Metrics::histogram("timetracker_database_add_event_seconds", "Latency of Database::add_event, including waiting for the lock", 1e-9);
+Metrics::Histogram& Database::_add_events_latency = Metrics::histogram("timetracker_database_add_events_seconds", "Latency of Database::add_events per batch", 1e-9);
+
+Metrics::Counter& Database::_added_events = Metrics::counter("timetracker_database_events_total", "Events passed to the database by outcome", "result=\"added\"");
+Metrics::Counter& Database::_duplicate_events = Metrics::counter("timetracker_database_events_total", "Events passed to the database by outcome", "result=\"duplicate\"");
+Metrics::Counter& Database::_rejected_events = Metrics::counter("timetracker_database_events_total", "Events passed to the database by outcome", "result=\"out_of_order\"");
+Metrics::Counter& Database::_failed_events = Metrics::counter("timetracker_database_events_total", "Events passed to the database by outcome", "result=\"failed\"");
+
+Metrics::Counter& Database::_registry_cache_hits = Metrics::counter("timetracker_database_registry_lookups_total", "Domain and entity id lookups by where they were resolved", "source=\"cache\"");
+Metrics::Counter& Database::_registry_lookups = Metrics::counter("timetracker_database_registry_lookups_total", "Domain and entity id lookups by where they were resolved", "source=\"registry\"");
+Metrics::Counter& Database::_registry_insertions = Metrics::counter("timetracker_database_registry_lookups_total", "Domain and entity id lookups by where they were resolved", "source=\"inserted\"");
+
+Metrics::Gauge& Database::_indexed_events = Metrics::gauge("timetracker_database_indexed_events", "Events held by the in-memory index");
+
+bool Database::add_event(std::string_view domain, std::string_view entity)
 {
 	time_t now = time(nullptr);
 	std::tm local_time;
-	localtime_s(&local_time, &now);
+	Platform::local_time(now, local_time);
 
 	return add_event(domain, entity, local_time);
 }
 
-bool Database::add_event(const std::string& domain, const std::string& entity, std::tm time)
+bool Database::add_event(std::string_view domain, std::string_view entity, std::tm time)
 {
+	TRACE_SPAN("Database::add_event");
+
+	Metrics::Timer timer(_add_event_latency);
+
 	std::unique_lock<std::mutex> lock(_mutex);
 
-	if (!_registry->domain_exists(domain))
+	return _add_event(domain, entity, time);
+}
+
+size_t Database::add_events(const std::vector<Event>& events, std::vector<bool>& results)
+{
+	TRACE_SPAN("Database::add_events");
+
+	Metrics::Timer timer(_add_events_latency);
+
+	results.assign(events.size(), false);
+
+	// Converted once, the comparator must not depend on the time zone
+	std::vector<TimeConverter::timestamp> times(events.size());
+	std::vector<size_t> order(events.size());
+
+	for (size_t i = 0; i < order.size(); i++)
 	{
-		Logger::log_info("Adding domain: {}", domain);
-		_registry->add_domain(domain);
+		times[i] = TimeConverter::to_timestamp(events[i].time);
+		order[i] = i;
 	}
 
-	TTRFileWriter::domain_id domain_id = _registry->get_domain_id(domain);
+	std::stable_sort(order.begin(), order.end(), [&times](size_t a, size_t b) {
+		return times[a] < times[b];
+	});
 
-	if (!_registry->entity_exists(domain_id, entity))
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	size_t added = 0;
+
+	for (size_t i = 0; i < order.size(); i++)
 	{
-		Logger::log_info("Adding entity: {}", entity);
-		_registry->add_entity(domain_id, entity);
+		size_t index = order[i];
+		const Event& event = events[index];
+
+		// Exact duplicates sort next to the events of the same second
+		bool duplicate = false;
+		size_t original = index;
+
+		for (size_t j = i; j > 0 && times[order[j - 1]] == times[index] && !duplicate; j--)
+		{
+			original = order[j - 1];
+			duplicate = events[original].domain == event.domain && events[original].entity == event.entity;
+		}
+
+		// Skipped like a repeat of the last event, it succeeds if its first copy was stored
+		if (duplicate)
+		{
+			Logger::log_info("Skipping duplicate event: {}:{} {}:{}:{}", event.domain, event.entity, event.time.tm_hour, event.time.tm_min, event.time.tm_sec);
+			_duplicate_events.increment();
+
+			results[index] = results[original];
+			added += results[index] ? 1 : 0;
+			continue;
+		}
+
+		if (_precedes_last_event(event.time))
+		{
+			Logger::log_warning("Rejecting out-of-order event: {}:{} {}:{}:{}", event.domain, event.entity, event.time.tm_hour, event.time.tm_min, event.time.tm_sec);
+			_rejected_events.increment();
+			continue;
+		}
+
+		if (_add_event(event.domain, event.entity, event.time))
+		{
+			results[index] = true;
+			added++;
+		}
 	}
 
-	TTRFileWriter::entity_id entity_id = _registry->get_entity_id(domain_id, entity);
+	return added;
+}
+
+const EventIndex& Database::index()
+{
+	return _index;
+}
+
+const EventStream& Database::stream()
+{
+	return _stream;
+}
+
+bool Database::_add_event(std::string_view domain, std::string_view entity, std::tm time)
+{
+	TRACE_SPAN("Database::_add_event");
+
+	TTRFileWriter::domain_id domain_id = _domain_id(domain, true);
+	TTRFileWriter::entity_id entity_id = _entity_id(domain_id, entity, true);
 
 	TTEFileWriter::Event last_event;
 	if (_events->get_last_event(last_event))
@@ -40,12 +140,13 @@ bool Database::add_event(const std::string& domain, const std::string& entity, s
 		if (last_event.entity == entity_id)
 		{
 			Logger::log_info("Skipping duplicate event: {}-{} {}:{}:{}", domain_id, entity_id, time.tm_hour, time.tm_min, time.tm_sec);
+			_duplicate_events.increment();
 			return true;
 		}
 	}
 
-	TTRFileWriter::domain_id runtime_domain_id = _registry->get_domain_id("Runtime");
-	TTRFileWriter::entity_id startup_entity_id = _registry->get_entity_id(runtime_domain_id, "Startup");
+	TTRFileWriter::domain_id runtime_domain_id = _domain_id("Runtime", false);
+	TTRFileWriter::entity_id startup_entity_id = _entity_id(runtime_domain_id, "Startup", false);
 
 	if (entity_id == startup_entity_id)
 	{
@@ -60,9 +161,7 @@ bool Database::add_event(const std::string& domain, const std::string& entity, s
 			last_time.tm_min = last_event.minute;
 			last_time.tm_sec = last_event.second;
 
-			lock.unlock();
-			Database::add_event("Runtime", "Shutdown", last_time);
-			lock.lock();
+			_add_event("Runtime", "Shutdown", last_time);
 		}
 	}
 
@@ -71,7 +170,142 @@ bool Database::add_event(const std::string& domain, const std::string& entity, s
 	TTEFileWriter::Date date(time.tm_year - 100, time.tm_mon + 1, time.tm_mday);
 	TTEFileWriter::Event event(entity_id, time.tm_hour, time.tm_min, time.tm_sec);
 
-	return _events->add_event(date, event);
+	if (_manifest != nullptr && !_use_segment(date))
+	{
+		_failed_events.increment();
+		return false;
+	}
+
+	if (!_events->add_event(date, event))
+	{
+		_failed_events.increment();
+		return false;
+	}
+
+	_added_events.increment();
+
+	if (_manifest != nullptr)
+	{
+		_manifest->record_event(TTEFileDate(date.year, date.month, date.day));
+	}
+
+	std::vector<IntervalBuilder::Interval> closed_intervals;
+	_index.add_event(TimeConverter::to_timestamp(time), entity_id, &closed_intervals);
+
+	_indexed_events.set(int64_t(_index.count_events()));
+
+	for (const IntervalBuilder::Interval& interval : closed_intervals)
+	{
+		_stream.publish_interval(interval);
+	}
+
+	_stream.publish_event(TimeConverter::to_timestamp(time), domain_id, entity_id);
+
+	return true;
+}
+
+TTRFileWriter::domain_id Database::_domain_id(std::string_view domain, bool create)
+{
+	TRACE_SPAN("Database::_domain_id");
+
+	auto it = _domain_ids.find(domain);
+	if (it != _domain_ids.end())
+	{
+		_registry_cache_hits.increment();
+		return it->second;
+	}
+
+	_registry_lookups.increment();
+
+	std::string name(domain);
+
+	if (!_registry->domain_exists(name))
+	{
+		if (!create)
+		{
+			return (TTRFileWriter::domain_id)-1;
+		}
+
+		Logger::log_info("Adding domain: {}", name);
+		_registry->add_domain(name);
+		_registry_insertions.increment();
+	}
+
+	TTRFileWriter::domain_id id = _registry->get_domain_id(name);
+
+	if (id != (TTRFileWriter::domain_id)-1)
+	{
+		_index.add_domain(id, name);
+		_domain_ids.emplace(std::move(name), id);
+	}
+
+	return id;
+}
+
+TTRFileWriter::entity_id Database::_entity_id(TTRFileWriter::domain_id domain_id, std::string_view entity, bool create)
+{
+	TRACE_SPAN("Database::_entity_id");
+
+	if (domain_id == (TTRFileWriter::domain_id)-1)
+	{
+		return (TTRFileWriter::entity_id)-1;
+	}
+
+	if (_entity_ids.size() <= domain_id)
+	{
+		_entity_ids.resize(size_t(domain_id) + 1);
+	}
+
+	StringMap<TTRFileWriter::entity_id>& entity_ids = _entity_ids[domain_id];
+
+	auto it = entity_ids.find(entity);
+	if (it != entity_ids.end())
+	{
+		_registry_cache_hits.increment();
+		return it->second;
+	}
+
+	_registry_lookups.increment();
+
+	std::string name(entity);
+
+	if (!_registry->entity_exists(domain_id, name))
+	{
+		if (!create)
+		{
+			return (TTRFileWriter::entity_id)-1;
+		}
+
+		Logger::log_info("Adding entity: {}", name);
+		_registry->add_entity(domain_id, name);
+		_registry_insertions.increment();
+	}
+
+	TTRFileWriter::entity_id id = _registry->get_entity_id(domain_id, name);
+
+	if (id != (TTRFileWriter::entity_id)-1)
+	{
+		_index.add_entity(id, domain_id, name);
+		entity_ids.emplace(std::move(name), id);
+	}
+
+	return id;
+}
+
+bool Database::_precedes_last_event(const std::tm& time)
+{
+	TTEFileWriter::Date last_date;
+	TTEFileWriter::Event last_event;
+
+	if (!_events->get_last_date(last_date) || !_events->get_last_event(last_event))
+	{
+		return false;
+	}
+
+	int last[6] = { last_date.year, last_date.month, last_date.day, last_event.hour, last_event.minute, last_event.second };
+	int current[6] = { time.tm_year - 100, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec };
+
+	return std::lexicographical_compare(current, current + 6, last, last + 6);
 }
 
 bool Database::startup()
@@ -81,14 +315,34 @@ bool Database::startup()
 		_registry = new TTRFileWriter(PathProvider::ttr_file_path());
 	}
 
-	if (_events == nullptr)
+	std::wstring manifest_file_path = PathProvider::manifest_file_path();
+
+	if (!manifest_file_path.empty())
+	{
+		if (_manifest == nullptr && !_open_segments(manifest_file_path))
+		{
+			return false;
+		}
+
+		_index.load_segments(PathProvider::ttr_file_path(), manifest_file_path);
+	}
+	else
 	{
-		_events = new TTEFileWriter(PathProvider::tte_file_path());
+		if (_events == nullptr)
+		{
+			_events_file_path = PathProvider::tte_file_path();
+			_events = new TTEFileWriter(_events_file_path);
+		}
+
+		_index.load(PathProvider::ttr_file_path(), PathProvider::tte_file_path());
 	}
 
+	_indexed_events.set(int64_t(_index.count_events()));
+	_stream.open();
+
 	time_t now = time(nullptr);
 	std::tm local_time;
-	localtime_s(&local_time, &now);
+	Platform::local_time(now, local_time);
 
 	add_event("Runtime", "Startup", local_time);
 
@@ -99,21 +353,101 @@ bool Database::shutdown()
 {
 	time_t now = time(nullptr);
 	std::tm local_time;
-	localtime_s(&local_time, &now);
+	Platform::local_time(now, local_time);
 
 	add_event("Runtime", "Shutdown", local_time);
 
+	_stream.close();
+
 	if (_registry != nullptr)
 	{
 		delete _registry;
 		_registry = nullptr;
 	}
 
+	_domain_ids.clear();
+	_entity_ids.clear();
+
 	if (_events != nullptr)
 	{
 		delete _events;
 		_events = nullptr;
 	}
 
+	if (_manifest != nullptr)
+	{
+		delete _manifest;
+		_manifest = nullptr;
+	}
+
+	return true;
+}
+
+bool Database::_open_segments(const std::wstring& manifest_file_path)
+{
+	_manifest = new TTESegmentManifest(manifest_file_path);
+
+	if (!_manifest->load())
+	{
+		delete _manifest;
+		_manifest = nullptr;
+		return false;
+	}
+
+	std::wstring tte_file_path = PathProvider::tte_file_path();
+
+	// A single TTE file from before segmentation becomes the first, sealed segment
+	if (_manifest->segments().empty() && !tte_file_path.empty() && std::filesystem::exists(tte_file_path))
+	{
+		TTEFileReader reader(tte_file_path);
+		TTEFileReader::DateRange dates = reader.dates();
+
+		if (dates.begin() != dates.end())
+		{
+			TTEFileReader::Date first = *dates.begin();
+			TTEFileReader::Date last = *std::prev(dates.end());
+
+			Logger::log_info("Adding {} as the first segment", StringConverter::to_utf8(tte_file_path));
+
+			_manifest->add_sealed_segment(tte_file_path, TTEFileDate(first.year, first.month, first.day), TTEFileDate(last.year, last.month, last.day));
+		}
+	}
+
+	// Writes keep going to the newest segment until an event starts a new period, so duplicates are still detected across the boundary
+	if (!_manifest->segments().empty())
+	{
+		_events_file_path = _manifest->segment_path(_manifest->segments().back());
+		_events = new TTEFileWriter(_events_file_path);
+
+		return true;
+	}
+
+	time_t now = time(nullptr);
+	std::tm local_time;
+	Platform::local_time(now, local_time);
+
+	return _use_segment(TTEFileWriter::Date(local_time.tm_year - 100, local_time.tm_mon + 1, local_time.tm_mday));
+}
+
+bool Database::_use_segment(const TTEFileWriter::Date& date)
+{
+	std::wstring file_path;
+
+	if (!_manifest->writable_segment(TTEFileDate(date.year, date.month, date.day), file_path))
+	{
+		Logger::append_info("Failed to open segment");
+		return false;
+	}
+
+	if (_events != nullptr && file_path == _events_file_path)
+	{
+		return true;
+	}
+
+	delete _events;
+
+	_events_file_path = file_path;
+	_events = new TTEFileWriter(_events_file_path);
+
 	return true;
 }
\ No newline at end of file
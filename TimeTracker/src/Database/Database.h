@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
 
 #include <time.h>
 
@@ -8,22 +11,84 @@
 
 #include "TTRFile/TTRFileWriter.h"
 #include "TTEFile/TTEFileWriter.h"
+#include "TTEFile/TTEFileReader.h"
+#include "TTEFile/TTESegmentManifest.h"
 
+#include "EventIndex.h"
+#include "EventStream.h"
+
+#include "../Utils/Metrics.h"
 #include "../Utils/PathProvider.h"
+#include "../Utils/Platform.h"
+#include "../Utils/StringHash.h"
+#include "../Utils/TimeConverter.h"
+#include "../Utils/Trace.h"
 
 class Database
 {
 public:
-	static bool add_event(const std::string& domain, const std::string& entity);
-	static bool add_event(const std::string& domain, const std::string& entity, std::tm time);
+	struct Event
+	{
+		std::string_view domain;
+		std::string_view entity;
+		std::tm time;
+	};
+
+public:
+	static bool add_event(std::string_view domain, std::string_view entity);
+	static bool add_event(std::string_view domain, std::string_view entity, std::tm time);
+
+	static size_t add_events(const std::vector<Event>& events, std::vector<bool>& results);
 
 	static bool startup();
 	static bool shutdown();
 
+	static const EventIndex& index();
+	static const EventStream& stream();
+
 private:
 	static TTRFileWriter* _registry;
 	static TTEFileWriter* _events;
 
+	// Only set if PathProvider has a manifest path, events then go to one segment file per month
+	static TTESegmentManifest* _manifest;
+	static std::wstring _events_file_path;
+
 	static std::mutex _mutex;
-};
 
+	static EventIndex _index;
+	static EventStream _stream;
+
+	static constexpr size_t _stream_capacity = 4096;
+
+private:
+	static Metrics::Histogram& _add_event_latency;
+	static Metrics::Histogram& _add_events_latency;
+
+	static Metrics::Counter& _added_events;
+	static Metrics::Counter& _duplicate_events;
+	static Metrics::Counter& _rejected_events;
+	static Metrics::Counter& _failed_events;
+
+	static Metrics::Counter& _registry_cache_hits;
+	static Metrics::Counter& _registry_lookups;
+	static Metrics::Counter& _registry_insertions;
+
+	static Metrics::Gauge& _indexed_events;
+
+private:
+	static StringMap<TTRFileWriter::domain_id> _domain_ids;
+	static std::vector<StringMap<TTRFileWriter::entity_id>> _entity_ids;
+
+	static TTRFileWriter::domain_id _domain_id(std::string_view domain, bool create);
+	static TTRFileWriter::entity_id _entity_id(TTRFileWriter::domain_id domain_id, std::string_view entity, bool create);
+
+private:
+	static bool _add_event(std::string_view domain, std::string_view entity, std::tm time);
+
+	static bool _precedes_last_event(const std::tm& time);
+
+private:
+	static bool _open_segments(const std::wstring& manifest_file_path);
+	static bool _use_segment(const TTEFileWriter::Date& date);
+};
@@ -0,0 +1,491 @@
+#include "EventIndex.h"
+
+bool EventIndex::load(const std::wstring& ttr_file_path, const std::wstring& tte_file_path)
+{
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+
+	_clear();
+
+	if (!std::filesystem::exists(ttr_file_path) || !std::filesystem::exists(tte_file_path))
+	{
+		return true;
+	}
+
+	_load_registry(ttr_file_path);
+
+	TTEFileReader tte_reader(tte_file_path);
+
+	for (const TTEFileReader::Event& event : tte_reader.events())
+	{
+		_add_file_event(event);
+	}
+
+	Logger::log_info("Loaded event index: {} domains, {} entities, {} events", _domains.size(), _entities.size(), _events.size());
+
+	return true;
+}
+
+bool EventIndex::load_segments(const std::wstring& ttr_file_path, const std::wstring& manifest_file_path)
+{
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+
+	_clear();
+
+	if (!std::filesystem::exists(ttr_file_path) || !std::filesystem::exists(manifest_file_path))
+	{
+		return true;
+	}
+
+	_load_registry(ttr_file_path);
+
+	TTESegmentReader segment_reader(manifest_file_path);
+
+	segment_reader.walk_events([this](const TTEFileReader::Event& event) {
+		return _add_file_event(event);
+	});
+
+	Logger::log_info("Loaded event index: {} domains, {} entities, {} events from {} segments", _domains.size(), _entities.size(), _events.size(), segment_reader.count_segments());
+
+	return true;
+}
+
+void EventIndex::add_domain(domain_id id, std::string_view name)
+{
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	_add_domain(id, name);
+}
+
+void EventIndex::add_entity(entity_id id, domain_id domain, std::string_view name)
+{
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	_add_entity(id, domain, name);
+}
+
+void EventIndex::add_event(timestamp time, entity_id entity, std::vector<IntervalBuilder::Interval>* closed_intervals)
+{
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	_add_event(time, entity, closed_intervals);
+}
+
+size_t EventIndex::count_events() const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	return _events.size();
+}
+
+size_t EventIndex::count_events(timestamp from, timestamp to) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	return _lower_bound(to) - _lower_bound(from);
+}
+
+bool EventIndex::get_events(timestamp from, timestamp to, size_t offset, size_t limit, std::vector<Event>& events) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	auto begin = _lower_bound(from);
+	auto end = _lower_bound(to);
+
+	if (size_t(end - begin) <= offset)
+	{
+		return false;
+	}
+
+	begin += offset;
+
+	for (; begin != end && limit > 0; ++begin, --limit)
+	{
+		events.push_back(Event{ timestamp(begin->time), _entities[begin->entity].domain, begin->entity });
+	}
+
+	return begin != end;
+}
+
+void EventIndex::get_totals(timestamp from, timestamp to, timestamp now, std::vector<Total>& totals) const
+{
+	std::unordered_map<entity_id, _Duration> durations;
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_mutex);
+
+		int32_t first_day = TimeConverter::to_day(from);
+		int32_t last_day = TimeConverter::to_day(to - 1);
+
+		auto begin = _daily_totals.lower_bound(first_day);
+		auto end = _daily_totals.lower_bound(last_day + 1);
+
+		for (; begin != end; ++begin)
+		{
+			for (const auto& [entity, duration] : begin->second)
+			{
+				durations[entity].total += duration.total;
+				durations[entity].active += duration.active;
+			}
+		}
+
+		// Rolled up per day like the closed intervals, so the same days are counted
+		auto add_open_interval = [first_day, last_day, &durations](const IntervalBuilder::Interval& interval, bool active) {
+			_split_days(interval.start, interval.end, [first_day, last_day, &interval, &durations, active](int32_t day, timestamp duration) {
+				if (day >= first_day && day <= last_day)
+				{
+					(active ? durations[interval.entity].active : durations[interval.entity].total) += duration;
+				}
+			});
+		};
+
+		for (size_t i = 0; i < _domains.size(); i++)
+		{
+			IntervalBuilder::Interval interval;
+			if (!_intervals.open_interval(domain_id(i), interval) || interval.start >= now)
+			{
+				continue;
+			}
+
+			interval.end = now;
+
+			add_open_interval(interval, false);
+
+			_sessions.clip(interval, [&add_open_interval](const IntervalBuilder::Interval& active_interval) {
+				add_open_interval(active_interval, true);
+			});
+		}
+
+		for (const auto& [entity, duration] : durations)
+		{
+			totals.push_back(Total{ _entities[entity].domain, entity, duration.total, duration.active });
+		}
+	}
+
+	std::sort(totals.begin(), totals.end(), [](const Total& a, const Total& b) {
+		return a.duration > b.duration;
+	});
+}
+
+void EventIndex::get_sessions(timestamp from, timestamp to, std::vector<SessionDay>& days) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	auto begin = _daily_sessions.lower_bound(TimeConverter::to_day(from));
+	auto end = _daily_sessions.lower_bound(TimeConverter::to_day(to - 1) + 1);
+
+	for (; begin != end; ++begin)
+	{
+		days.push_back(begin->second);
+	}
+}
+
+void EventIndex::get_histogram(timestamp from, timestamp to, Histogram::Cycle cycle, timestamp bucket_size, size_t num_of_threads, Histogram& histogram) const
+{
+	// Durations are only rolled up per day, so intervals are rebuilt from a copy of the events
+	IntervalBuilder intervals;
+	std::vector<_IndexedEvent> events;
+	bool has_later_events = false;
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_mutex);
+
+		for (size_t i = 0; i < _domains.size(); i++)
+		{
+			intervals.add_domain(domain_id(i), _domains[i]);
+		}
+
+		for (size_t i = 0; i < _entities.size(); i++)
+		{
+			intervals.add_entity(entity_id(i), _entities[i].domain, _entities[i].name);
+		}
+
+		histogram = Histogram(_entities.size(), cycle, bucket_size);
+
+		auto begin = _lower_bound(from);
+		auto end = _lower_bound(to);
+
+		has_later_events = end != _events.end();
+
+		if (intervals.tracks_devices())
+		{
+			// The intervals of merged devices depend on the device of every event
+			begin = _events.begin();
+		}
+		else
+		{
+			// The intervals open at from only depend on the last event of every domain before it
+			std::vector<bool> seen(_domains.size(), false);
+			size_t pending = _domains.size();
+
+			for (auto it = begin; it != _events.begin() && pending > 0;)
+			{
+				--it;
+
+				domain_id domain = it->entity < _entities.size() ? _entities[it->entity].domain : domain_id(0);
+
+				if (domain < seen.size() && !seen[domain])
+				{
+					seen[domain] = true;
+					pending--;
+
+					events.push_back(*it);
+				}
+			}
+
+			std::reverse(events.begin(), events.end());
+		}
+
+		events.insert(events.end(), begin, end);
+	}
+
+	HistogramBuilder builder(histogram, num_of_threads);
+
+	IntervalBuilder::IntervalHandler add_interval = [from, to, &builder](const IntervalBuilder::Interval& interval)
+		{
+			builder.add_interval(interval.entity, (std::max)(interval.start, from), (std::min)(interval.end, to));
+		};
+
+	int32_t day = 0;
+	timestamp last_time = 0;
+
+	for (const _IndexedEvent& event : events)
+	{
+		timestamp time = timestamp(event.time);
+
+		if (TimeConverter::to_day(time) != day)
+		{
+			builder.end_block();
+			day = TimeConverter::to_day(time);
+		}
+
+		intervals.add_event(time, event.entity, add_interval);
+
+		if (time >= from)
+		{
+			builder.add_event(event.entity, time);
+		}
+
+		last_time = time;
+	}
+
+	// Intervals still open at the end of the index are closed at its last event
+	intervals.close(has_later_events ? to : last_time, add_interval);
+
+	builder.finish(histogram);
+}
+
+void EventIndex::get_state(std::vector<State>& states) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	for (size_t i = 0; i < _domains.size(); i++)
+	{
+		IntervalBuilder::Interval interval;
+		if (_intervals.open_interval(domain_id(i), interval))
+		{
+			states.push_back(State{ interval.domain, interval.entity, interval.start });
+		}
+	}
+}
+
+std::string EventIndex::domain_name(domain_id id) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	return id < _domains.size() ? _domains[id] : std::string();
+}
+
+std::string EventIndex::entity_name(entity_id id) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	return id < _entities.size() ? _entities[id].name : std::string();
+}
+
+EventIndex::domain_id EventIndex::domain_of(entity_id id) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	return id < _entities.size() ? _entities[id].domain : 0;
+}
+
+bool EventIndex::find_domain(std::string_view name, domain_id& id) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+
+	auto it = _domain_ids.find(name);
+	if (it == _domain_ids.end())
+	{
+		return false;
+	}
+
+	id = it->second;
+	return true;
+}
+
+void EventIndex::_clear()
+{
+	_domains.clear();
+	_domain_ids.clear();
+	_entities.clear();
+	_events.clear();
+	_last_time = 0;
+	_daily_totals.clear();
+	_daily_sessions.clear();
+
+	_intervals = IntervalBuilder();
+	_sessions = Sessionizer();
+}
+
+void EventIndex::_load_registry(const std::wstring& ttr_file_path)
+{
+	TTRFileMappedReader ttr_reader(ttr_file_path);
+
+	domain_id d_id = 0;
+	for (std::string_view domain : ttr_reader.domains())
+	{
+		_add_domain(d_id++, domain);
+	}
+
+	entity_id e_id = 0;
+	for (const TTRFileMappedReader::Entity& entity : ttr_reader.entities())
+	{
+		_add_entity(e_id++, entity.domain_id, entity.name);
+	}
+}
+
+bool EventIndex::_add_file_event(const TTEFileReader::Event& event)
+{
+	timestamp time = TimeConverter::to_timestamp(2000 + event.date.year, event.date.month, event.date.day, event.hour, event.minute, event.second);
+	_add_event(time, event.entity, nullptr);
+
+	return true;
+}
+
+void EventIndex::_add_domain(domain_id id, std::string_view name)
+{
+	if (_domains.size() <= id)
+	{
+		_domains.resize(size_t(id) + 1);
+	}
+
+	_domains[id] = std::string(name);
+	_domain_ids.insert_or_assign(std::string(name), id);
+
+	_intervals.add_domain(id, name);
+	_sessions.add_domain(id, name);
+}
+
+void EventIndex::_add_entity(entity_id id, domain_id domain, std::string_view name)
+{
+	if (_entities.size() <= id)
+	{
+		_entities.resize(size_t(id) + 1);
+	}
+
+	_entities[id] = _Entity{ domain, std::string(name) };
+
+	_intervals.add_entity(id, domain, name);
+	_sessions.add_entity(id, domain, name);
+}
+
+void EventIndex::_add_event(timestamp time, entity_id entity, std::vector<IntervalBuilder::Interval>* closed_intervals)
+{
+	if (entity >= _entities.size() || time < 0 || time > timestamp(UINT32_MAX))
+	{
+		Logger::log_warning("Event index skipped event for entity {}", entity);
+		return;
+	}
+
+	if (_events.empty() || _events.back().time <= uint32_t(time))
+	{
+		_events.push_back(_IndexedEvent{ uint32_t(time), entity });
+	}
+	else
+	{
+		// After the events of the same second, which arrived before it
+		auto position = std::upper_bound(_events.begin(), _events.end(), uint32_t(time), [](uint32_t value, const _IndexedEvent& event) {
+			return value < event.time;
+		});
+
+		_events.insert(position, _IndexedEvent{ uint32_t(time), entity });
+	}
+
+	// Intervals would get negative durations if the clock stepped back
+	time = (std::max)(time, _last_time);
+	_last_time = time;
+
+	_sessions.add_event(time, entity, [this](const Sessionizer::Session& session) {
+		_add_session(session);
+	});
+
+	_intervals.add_event(time, entity, [this, closed_intervals](const IntervalBuilder::Interval& interval) {
+		_add_interval(interval, false);
+
+		_sessions.clip(interval, [this](const IntervalBuilder::Interval& active_interval) {
+			_add_interval(active_interval, true);
+		});
+
+		if (closed_intervals != nullptr)
+		{
+			closed_intervals->push_back(interval);
+		}
+	});
+
+	// Only the open intervals can still be clipped, and none of them started before the oldest
+	timestamp oldest_start = time;
+
+	for (size_t i = 0; i < _domains.size(); i++)
+	{
+		IntervalBuilder::Interval interval;
+		if (_intervals.open_interval(domain_id(i), interval))
+		{
+			oldest_start = (std::min)(oldest_start, interval.start);
+		}
+	}
+
+	_sessions.trim(oldest_start);
+}
+
+void EventIndex::_add_interval(const IntervalBuilder::Interval& interval, bool active)
+{
+	_split_days(interval.start, interval.end, [this, &interval, active](int32_t day, timestamp duration) {
+		_Duration& total = _daily_totals[day][interval.entity];
+		(active ? total.active : total.total) += duration;
+	});
+}
+
+void EventIndex::_add_session(const Sessionizer::Session& session)
+{
+	_split_days(session.start, session.end, [this, &session](int32_t day, timestamp duration) {
+		SessionDay& total = _daily_sessions[day];
+		total.day = day;
+
+		switch (session.state)
+		{
+		case Sessionizer::State::ACTIVE:
+			total.active += duration;
+			break;
+		case Sessionizer::State::IDLE:
+			total.idle += duration;
+			break;
+		case Sessionizer::State::OFF:
+			total.off += duration;
+			break;
+		}
+	});
+}
+
+std::vector<EventIndex::_IndexedEvent>::const_iterator EventIndex::_lower_bound(timestamp time) const
+{
+	if (time <= 0)
+	{
+		return _events.begin();
+	}
+
+	if (time > timestamp(UINT32_MAX))
+	{
+		return _events.end();
+	}
+
+	return std::lower_bound(_events.begin(), _events.end(), uint32_t(time), [](const _IndexedEvent& event, uint32_t value) {
+		return event.time < value;
+	});
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <unordered_map>
+#include <shared_mutex>
+#include <filesystem>
+
+#include <stdint.h>
+
+#include "TTRFile/TTRFileMappedReader.h"
+#include "TTEFile/TTEFileReader.h"
+#include "TTEFile/TTESegmentReader.h"
+
+#include "../Analysis/Histogram.h"
+#include "../Analysis/HistogramBuilder.h"
+#include "../Analysis/IntervalBuilder.h"
+#include "../Analysis/Sessionizer.h"
+
+#include "../Utils/Logger.h"
+#include "../Utils/StringHash.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* In-memory copy of the registry and the event stream, kept up to date by the
+* Database so queries never touch the files. Durations are rolled up per day
+* as intervals close, so totals over a range cost O(days) instead of O(events).
+* The sessions of the Sessionizer are rolled up per day the same way, and the
+* durations keep their active part apart, without the idle and powered-off time.
+* 
+* Events are local civil times in arrival order, which can step back when the
+* clock is changed or daylight saving time ends. They are inserted by time, so
+* range queries stay sorted, but intervals and sessions only move forward: an
+* event older than the newest one is counted at the newest time.
+* 
+* All queries take a shared lock and only hold it while copying their result.
+*/
+
+class EventIndex
+{
+public:
+	using domain_id = uint8_t;
+	using entity_id = uint16_t;
+	using timestamp = TimeConverter::timestamp;
+
+	struct Event
+	{
+		timestamp time = 0;
+		domain_id domain = 0;
+		entity_id entity = 0;
+	};
+
+	struct Total
+	{
+		domain_id domain = 0;
+		entity_id entity = 0;
+		timestamp duration = 0;
+
+		// Part of the duration in active sessions
+		timestamp active_duration = 0;
+	};
+
+	struct SessionDay
+	{
+		// See TimeConverter::to_day
+		int32_t day = 0;
+
+		timestamp active = 0;
+		timestamp idle = 0;
+		timestamp off = 0;
+	};
+
+	struct State
+	{
+		domain_id domain = 0;
+		entity_id entity = 0;
+		timestamp since = 0;
+	};
+
+public:
+	bool load(const std::wstring& ttr_file_path, const std::wstring& tte_file_path);
+	bool load_segments(const std::wstring& ttr_file_path, const std::wstring& manifest_file_path);
+
+	void add_domain(domain_id id, std::string_view name);
+	void add_entity(entity_id id, domain_id domain, std::string_view name);
+	void add_event(timestamp time, entity_id entity, std::vector<IntervalBuilder::Interval>* closed_intervals = nullptr);
+
+public:
+	size_t count_events() const;
+	size_t count_events(timestamp from, timestamp to) const;
+	bool get_events(timestamp from, timestamp to, size_t offset, size_t limit, std::vector<Event>& events) const;
+
+	// Intervals still open are counted up to now
+	void get_totals(timestamp from, timestamp to, timestamp now, std::vector<Total>& totals) const;
+
+	// Closed sessions of the days overlapping the range, oldest first
+	void get_sessions(timestamp from, timestamp to, std::vector<SessionDay>& days) const;
+
+	// Replays the intervals of the range, the histogram is resized to the registry
+	void get_histogram(timestamp from, timestamp to, Histogram::Cycle cycle, timestamp bucket_size, size_t num_of_threads, Histogram& histogram) const;
+	void get_state(std::vector<State>& states) const;
+
+	std::string domain_name(domain_id id) const;
+	std::string entity_name(entity_id id) const;
+	domain_id domain_of(entity_id id) const;
+
+	bool find_domain(std::string_view name, domain_id& id) const;
+
+private:
+	mutable std::shared_mutex _mutex;
+
+	std::vector<std::string> _domains;
+	StringMap<domain_id> _domain_ids;
+
+	struct _Entity
+	{
+		domain_id domain = 0;
+		std::string name;
+	};
+
+	std::vector<_Entity> _entities;
+
+private:
+	struct _IndexedEvent
+	{
+		uint32_t time;
+		entity_id entity;
+	};
+
+	std::vector<_IndexedEvent> _events;
+
+	// Newest time fed to the intervals and the sessions
+	timestamp _last_time = 0;
+
+	IntervalBuilder _intervals;
+	Sessionizer _sessions;
+
+	struct _Duration
+	{
+		timestamp total = 0;
+		timestamp active = 0;
+	};
+
+	std::map<int32_t, std::unordered_map<entity_id, _Duration>> _daily_totals;
+	std::map<int32_t, SessionDay> _daily_sessions;
+
+	void _clear();
+
+	void _load_registry(const std::wstring& ttr_file_path);
+	bool _add_file_event(const TTEFileReader::Event& event);
+
+	void _add_domain(domain_id id, std::string_view name);
+	void _add_entity(entity_id id, domain_id domain, std::string_view name);
+	void _add_event(timestamp time, entity_id entity, std::vector<IntervalBuilder::Interval>* closed_intervals);
+
+	void _add_interval(const IntervalBuilder::Interval& interval, bool active);
+	void _add_session(const Sessionizer::Session& session);
+
+	template <typename Function>
+	static void _split_days(timestamp start, timestamp end, Function function);
+
+	std::vector<_IndexedEvent>::const_iterator _lower_bound(timestamp time) const;
+};
+
+template <typename Function>
+void EventIndex::_split_days(timestamp start, timestamp end, Function function)
+{
+	while (start < end)
+	{
+		int32_t day = TimeConverter::to_day(start);
+		timestamp day_end = (std::min)(end, TimeConverter::from_day(day + 1));
+
+		function(day, day_end - start);
+
+		start = day_end;
+	}
+}
\ No newline at end of file
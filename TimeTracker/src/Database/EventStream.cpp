@@ -0,0 +1,93 @@
+#include "EventStream.h"
+
+EventStream::EventStream(size_t capacity)
+	: _messages(capacity)
+{
+}
+
+void EventStream::publish_event(timestamp time, domain_id domain, entity_id entity)
+{
+	Message message;
+	message.type = MessageType::EVENT;
+	message.domain = domain;
+	message.entity = entity;
+	message.start = time;
+	message.end = time;
+
+	_publish(message);
+}
+
+void EventStream::publish_interval(const IntervalBuilder::Interval& interval)
+{
+	Message message;
+	message.type = MessageType::INTERVAL;
+	message.domain = interval.domain;
+	message.entity = interval.entity;
+	message.start = interval.start;
+	message.end = interval.end;
+
+	_publish(message);
+}
+
+uint64_t EventStream::next_sequence() const
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _next_sequence;
+}
+
+EventStream::ReadResult EventStream::read(uint64_t& cursor, std::vector<Message>& messages, size_t max_messages, std::chrono::milliseconds timeout) const
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	if (!_has_messages.wait_for(lock, timeout, [this, cursor] { return _closed || _next_sequence > cursor; }))
+	{
+		return ReadResult::TIMEOUT;
+	}
+
+	if (_next_sequence <= cursor)
+	{
+		return ReadResult::CLOSED;
+	}
+
+	if (_next_sequence - cursor > _messages.size())
+	{
+		return ReadResult::OVERRUN;
+	}
+
+	for (; cursor < _next_sequence && max_messages > 0; cursor++, max_messages--)
+	{
+		messages.push_back(_messages[cursor % _messages.size()]);
+	}
+
+	return ReadResult::MESSAGES;
+}
+
+void EventStream::open()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_closed = false;
+}
+
+void EventStream::close()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_closed = true;
+	}
+
+	_has_messages.notify_all();
+}
+
+void EventStream::_publish(Message message)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		message.sequence = _next_sequence;
+		_messages[_next_sequence % _messages.size()] = message;
+
+		_next_sequence++;
+	}
+
+	_has_messages.notify_all();
+}
\ No newline at end of file
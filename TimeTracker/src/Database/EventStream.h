@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include <stdint.h>
+
+#include "../Analysis/IntervalBuilder.h"
+
+#include "../Utils/TimeConverter.h"
+
+/*
+* Fixed-size ring buffer of committed events and closed intervals, shared by
+* all live subscribers. Publishing overwrites the oldest slot and never waits
+* for readers; a reader that falls more than one buffer behind is told so
+* through ReadResult::OVERRUN and is expected to disconnect.
+*/
+
+class EventStream
+{
+public:
+	using domain_id = uint8_t;
+	using entity_id = uint16_t;
+	using timestamp = TimeConverter::timestamp;
+
+	enum class MessageType
+	{
+		EVENT,
+		INTERVAL
+	};
+
+	struct Message
+	{
+		uint64_t sequence = 0;
+		MessageType type = MessageType::EVENT;
+
+		domain_id domain = 0;
+		entity_id entity = 0;
+
+		timestamp start = 0;
+		timestamp end = 0;
+	};
+
+	enum class ReadResult
+	{
+		MESSAGES,
+		TIMEOUT,
+		OVERRUN,
+		CLOSED
+	};
+
+public:
+	EventStream(size_t capacity);
+
+	void publish_event(timestamp time, domain_id domain, entity_id entity);
+	void publish_interval(const IntervalBuilder::Interval& interval);
+
+	uint64_t next_sequence() const;
+
+	ReadResult read(uint64_t& cursor, std::vector<Message>& messages, size_t max_messages, std::chrono::milliseconds timeout) const;
+
+	void open();
+	void close();
+
+private:
+	mutable std::mutex _mutex;
+	mutable std::condition_variable _has_messages;
+
+	std::vector<Message> _messages;
+	uint64_t _next_sequence = 0;
+
+	bool _closed = false;
+
+private:
+	void _publish(Message message);
+};
\ No newline at end of file
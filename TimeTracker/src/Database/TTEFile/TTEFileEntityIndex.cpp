@@ -0,0 +1,275 @@
+#include "TTEFileEntityIndex.h"
+
+std::wstring TTEFileEntityIndex::path_of(const std::wstring& tte_file_path)
+{
+	std::filesystem::path path(tte_file_path);
+	path.replace_extension(L".tti");
+
+	return path.wstring();
+}
+
+bool TTEFileEntityIndex::read(const std::wstring& file_path)
+{
+	clear();
+
+	std::ifstream file(std::filesystem::path(file_path), std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	char magic[4];
+	file.read(magic, 3);
+	magic[3] = '\0';
+
+	if (!file || std::string(magic) != "TTI")
+	{
+		Logger::log_warning("Invalid entity index: {}", StringConverter::to_utf8(file_path));
+		return false;
+	}
+
+	uint8_t version = 0;
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+	if (!file || version != _version)
+	{
+		Logger::log_warning("Outdated entity index, rebuilding: {}", StringConverter::to_utf8(file_path));
+		return false;
+	}
+
+	file.read(reinterpret_cast<char*>(&_num_of_blocks), sizeof(_num_of_blocks));
+	file.read(reinterpret_cast<char*>(&_last_events), sizeof(_last_events));
+	file.read(reinterpret_cast<char*>(&_blocks_hash), sizeof(_blocks_hash));
+	file.read(reinterpret_cast<char*>(&_file_size), sizeof(_file_size));
+	file.read(reinterpret_cast<char*>(&_file_write_time), sizeof(_file_write_time));
+
+	_summaries.resize(_num_of_blocks);
+
+	for (BlockSummary& summary : _summaries)
+	{
+		file.read(reinterpret_cast<char*>(&summary.first_second), sizeof(summary.first_second));
+		file.read(reinterpret_cast<char*>(&summary.last_second), sizeof(summary.last_second));
+		file.read(reinterpret_cast<char*>(&summary.num_of_entities), sizeof(summary.num_of_entities));
+	}
+
+	uint16_t num_of_entities = 0;
+	file.read(reinterpret_cast<char*>(&num_of_entities), sizeof(num_of_entities));
+
+	_entities.resize(num_of_entities);
+
+	for (RoaringBitmap& blocks : _entities)
+	{
+		if (!blocks.read(file))
+		{
+			break;
+		}
+	}
+
+	if (!file)
+	{
+		Logger::log_warning("Truncated entity index: {}", StringConverter::to_utf8(file_path));
+		clear();
+		return false;
+	}
+
+	// An index of version 1 may start with this version byte, its fields then end before the file
+	if (file.peek() != std::char_traits<char>::eof())
+	{
+		Logger::log_warning("Outdated entity index, rebuilding: {}", StringConverter::to_utf8(file_path));
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool TTEFileEntityIndex::write(const std::wstring& file_path) const
+{
+	std::filesystem::path path(file_path);
+
+	// Written next to the index and renamed over it, so readers never see a partial index
+	std::filesystem::path temp_path = path;
+	temp_path += L".tmp";
+
+	{
+		std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open())
+		{
+			Logger::log_warning("Unable to create file: {}", StringConverter::to_utf8(temp_path.wstring()));
+			return false;
+		}
+
+		file.write("TTI", 3);
+		file.write(reinterpret_cast<const char*>(&_version), sizeof(_version));
+
+		file.write(reinterpret_cast<const char*>(&_num_of_blocks), sizeof(_num_of_blocks));
+		file.write(reinterpret_cast<const char*>(&_last_events), sizeof(_last_events));
+		file.write(reinterpret_cast<const char*>(&_blocks_hash), sizeof(_blocks_hash));
+		file.write(reinterpret_cast<const char*>(&_file_size), sizeof(_file_size));
+		file.write(reinterpret_cast<const char*>(&_file_write_time), sizeof(_file_write_time));
+
+		for (uint16_t i = 0; i < _num_of_blocks; i++)
+		{
+			BlockSummary summary = i < _summaries.size() ? _summaries[i] : BlockSummary();
+
+			file.write(reinterpret_cast<const char*>(&summary.first_second), sizeof(summary.first_second));
+			file.write(reinterpret_cast<const char*>(&summary.last_second), sizeof(summary.last_second));
+			file.write(reinterpret_cast<const char*>(&summary.num_of_entities), sizeof(summary.num_of_entities));
+		}
+
+		uint16_t num_of_entities = uint16_t(_entities.size());
+		file.write(reinterpret_cast<const char*>(&num_of_entities), sizeof(num_of_entities));
+
+		for (const RoaringBitmap& blocks : _entities)
+		{
+			blocks.write(file);
+		}
+
+		if (!file.good())
+		{
+			Logger::log_warning("Failed to write file: {}", StringConverter::to_utf8(temp_path.wstring()));
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp_path, path, error);
+
+	if (error)
+	{
+		Logger::log_warning("Failed to replace entity index: {}", error.message());
+		return false;
+	}
+
+	return true;
+}
+
+void TTEFileEntityIndex::clear()
+{
+	_num_of_blocks = 0;
+	_last_events = 0;
+	_blocks_hash = empty_hash;
+
+	_file_size = 0;
+	_file_write_time = 0;
+
+	_summaries.clear();
+	_entities.clear();
+}
+
+void TTEFileEntityIndex::add(entity_id entity, uint16_t block, uint32_t second)
+{
+	if (_entities.size() <= entity)
+	{
+		_entities.resize(size_t(entity) + 1);
+	}
+
+	if (_summaries.size() <= block)
+	{
+		_summaries.resize(size_t(block) + 1);
+	}
+
+	BlockSummary& summary = _summaries[block];
+	summary.first_second = (std::min)(summary.first_second, second);
+	summary.last_second = (std::max)(summary.last_second, second);
+
+	RoaringBitmap& blocks = _entities[entity];
+
+	if (!blocks.contains(block))
+	{
+		blocks.add(block);
+		summary.num_of_entities++;
+	}
+}
+
+void TTEFileEntityIndex::cover(uint16_t num_of_blocks, uint32_t last_events, uint64_t blocks_hash, const FileStamp& stamp)
+{
+	_num_of_blocks = num_of_blocks;
+	_summaries.resize(num_of_blocks);
+
+	_last_events = last_events;
+	_blocks_hash = blocks_hash;
+
+	_file_size = uint64_t(stamp.size);
+	_file_write_time = int64_t(stamp.write_time.time_since_epoch().count());
+}
+
+void TTEFileEntityIndex::optimize()
+{
+	for (RoaringBitmap& blocks : _entities)
+	{
+		blocks.optimize();
+	}
+}
+
+uint16_t TTEFileEntityIndex::num_of_blocks() const
+{
+	return _num_of_blocks;
+}
+
+uint32_t TTEFileEntityIndex::last_events() const
+{
+	return _last_events;
+}
+
+uint64_t TTEFileEntityIndex::blocks_hash() const
+{
+	return _blocks_hash;
+}
+
+bool TTEFileEntityIndex::matches(const FileStamp& stamp) const
+{
+	if (stamp.size != _file_size)
+	{
+		return stamp.size > _file_size;
+	}
+
+	return int64_t(stamp.write_time.time_since_epoch().count()) == _file_write_time;
+}
+
+RoaringBitmap TTEFileEntityIndex::blocks(const std::vector<entity_id>& entities) const
+{
+	RoaringBitmap blocks;
+
+	for (entity_id entity : entities)
+	{
+		if (entity < _entities.size())
+		{
+			blocks |= _entities[entity];
+		}
+	}
+
+	return blocks;
+}
+
+const RoaringBitmap* TTEFileEntityIndex::blocks(entity_id entity) const
+{
+	return entity < _entities.size() ? &_entities[entity] : nullptr;
+}
+
+size_t TTEFileEntityIndex::num_of_entities() const
+{
+	return _entities.size();
+}
+
+const std::vector<TTEFileEntityIndex::BlockSummary>& TTEFileEntityIndex::summaries() const
+{
+	return _summaries;
+}
+
+uint64_t TTEFileEntityIndex::hash_block(uint64_t hash, TTEFileDate::encoded_date date, uint32_t num_of_events)
+{
+	// FNV-1a over the bytes of the block header
+	uint8_t bytes[sizeof(date) + sizeof(num_of_events)];
+	std::memcpy(bytes, &date, sizeof(date));
+	std::memcpy(bytes + sizeof(date), &num_of_events, sizeof(num_of_events));
+
+	for (uint8_t byte : bytes)
+	{
+		hash = (hash ^ byte) * 1099511628211ull;
+	}
+
+	return hash;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <cstring>
+
+#include "TTEFileDate.h"
+
+#include "../../Utils/FileStamp.h"
+#include "../../Utils/Logger.h"
+#include "../../Utils/RoaringBitmap.h"
+#include "../../Utils/StringConverter.h"
+
+/*
+* Time Tracker Entity Index
+*
+* Secondary index of a TTE file that lists, for every entity, the date blocks
+* it occurs in, and keeps a zone map of every block: the first and last second
+* of the day with events and the number of distinct entities. Selective reads
+* skip every block the index rules out without decoding it. Stored beside the
+* TTE file with the extension .tti and built lazily by TTEFileReader, which
+* extends it when the file grew and rebuilds it when the covered blocks no
+* longer match.
+*
+* The covered blocks are identified by the hash of their dates and event
+* counts, the last one counted only up to the covered events, and by the
+* stamp of the TTE file when it was indexed. A file that grew only had events
+* appended, a file of the same size with another write time was rewritten.
+*
+* An index written with another version of the layout is rebuilt.
+*
+* Layout:
+*
+* Start:
+*   - 'TTI'                3
+*   - version              1
+*   - num_of_blocks        2
+*   - last_events          4
+*   - blocks_hash          8
+*   - file_size            8
+*   - file_write_time      8
+*   - {
+*       first_second:      4
+*       last_second:       4
+*       num_of_entities:   2
+*     } * num_of_blocks
+*   - num_of_entities      2
+*   - {
+*       blocks:            RoaringBitmap of block indices
+*     } * num_of_entities
+*/
+
+class TTEFileEntityIndex
+{
+public:
+	using entity_id = uint16_t;
+
+	struct BlockSummary
+	{
+		// Seconds of the day of the earliest and the latest event
+		uint32_t first_second = UINT32_MAX;
+		uint32_t last_second = 0;
+
+		uint16_t num_of_entities = 0;
+	};
+
+public:
+	static std::wstring path_of(const std::wstring& tte_file_path);
+
+	bool read(const std::wstring& file_path);
+	bool write(const std::wstring& file_path) const;
+
+	void clear();
+
+	void add(entity_id entity, uint16_t block, uint32_t second);
+
+	// Called once the blocks up to num_of_blocks are indexed, with the events indexed in the last of them
+	void cover(uint16_t num_of_blocks, uint32_t last_events, uint64_t blocks_hash, const FileStamp& stamp);
+	void optimize();
+
+	uint16_t num_of_blocks() const;
+	uint32_t last_events() const;
+	uint64_t blocks_hash() const;
+
+	// False when the file was rewritten since it was indexed
+	bool matches(const FileStamp& stamp) const;
+
+	// Union of the blocks of the entities
+	RoaringBitmap blocks(const std::vector<entity_id>& entities) const;
+	const RoaringBitmap* blocks(entity_id entity) const;
+
+	size_t num_of_entities() const;
+
+	// One per covered block
+	const std::vector<BlockSummary>& summaries() const;
+
+	static uint64_t hash_block(uint64_t hash, TTEFileDate::encoded_date date, uint32_t num_of_events);
+	static constexpr uint64_t empty_hash = 14695981039346656037ull;
+
+private:
+	// Version 1 had no zone maps and no version byte
+	static constexpr uint8_t _version = 2;
+
+	uint16_t _num_of_blocks = 0;
+	uint32_t _last_events = 0;
+	uint64_t _blocks_hash = empty_hash;
+
+	uint64_t _file_size = 0;
+	int64_t _file_write_time = 0;
+
+	std::vector<BlockSummary> _summaries;
+	std::vector<RoaringBitmap> _entities;
+};
\ No newline at end of file
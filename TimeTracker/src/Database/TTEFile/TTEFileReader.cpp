@@ -99,10 +99,10 @@ TTEFileReader::DateRange TTEFileReader::dates(DateFilter filter)
 {
 	if (!_read_dates(filter))
 	{
-		Logger::append_info("Failed to read dates", StringConverter::to_utf8(_file_path));
+		Logger::append_info("Failed to read dates: {}", StringConverter::to_utf8(_file_path));
 	}
 
-	return DateRange(_dates.begin(), _dates.end(), _num_of_dates);
+	return DateRange(DateIterator(_dates.cbegin()), DateIterator(_dates.cend()), _num_of_dates);
 }
 
 bool TTEFileReader::date_exists(const Date& date)
@@ -303,6 +303,17 @@ TTEFileReader::EventRange TTEFileReader::events(EventFilter filter)
 	return EventRange(this, 0, _event_count(), filter);
 }
 
+bool TTEFileReader::get_event(uint64_t index, Event& event)
+{
+	if (_dates.empty() && !_read_dates(DateFilter::empty()))
+	{
+		Logger::append_info("Failed to get event");
+		return false;
+	}
+
+	return _get_event(index, event);
+}
+
 bool TTEFileReader::event_exists(const Event& event)
 {
 	return event_exists(EventFilter::create([&event](const Event& e) {
@@ -347,6 +358,274 @@ void TTEFileReader::walk_events(EventFilter filter, EventWalker function)
 	}
 }
 
+TTEFileReader::DateRange TTEFileReader::dates(const Selection& selection)
+{
+	std::vector<bool> complete;
+
+	if (!_read_selection(selection, complete))
+	{
+		Logger::append_info("Failed to read dates: {}", StringConverter::to_utf8(_file_path));
+	}
+
+	return DateRange(DateIterator(_dates.cbegin()), DateIterator(_dates.cend()), _num_of_dates);
+}
+
+TTEFileReader::EventRange TTEFileReader::events(const Selection& selection)
+{
+	return events(selection, EventFilter::empty());
+}
+
+TTEFileReader::EventRange TTEFileReader::events(const Selection& selection, EventFilter filter)
+{
+	std::vector<bool> complete;
+
+	if (!_read_selection(selection, complete))
+	{
+		Logger::append_info("Failed to read events: {}", StringConverter::to_utf8(_file_path));
+	}
+
+	// The skipped blocks hold no selected event, the others may still mix them with the rest
+	EventFilter selection_filter = EventFilter::create([this, selection, filter](const Event& event) {
+		return _is_selected(selection, event, _day_start(event.date)) && filter(event);
+	});
+
+	return EventRange(this, 0, _event_count(), selection_filter);
+}
+
+uint64_t TTEFileReader::count_events(const Selection& selection)
+{
+	TRACE_SPAN("TTEFileReader::count_events");
+
+	std::vector<bool> complete;
+
+	if (!_read_selection(selection, complete))
+	{
+		Logger::append_info("Failed to count events");
+		return 0;
+	}
+
+	uint64_t count = 0;
+
+	for (size_t i = 0; i < _dates.size(); i++)
+	{
+		const _DateBlock& block = _dates[i];
+
+		if (complete[i])
+		{
+			count += block.num_of_events;
+			continue;
+		}
+
+		TimeConverter::timestamp day_start = _day_start(block.date);
+
+		for (uint64_t j = 0; j < block.num_of_events; j++)
+		{
+			Event event;
+			if (!_get_event(block.first_event + j, event))
+			{
+				return count;
+			}
+
+			count += _is_selected(selection, event, day_start) ? 1 : 0;
+		}
+	}
+
+	return count;
+}
+
+void TTEFileReader::walk_events(const Selection& selection, EventWalker function)
+{
+	TRACE_SPAN("TTEFileReader::walk_events");
+
+	std::vector<bool> complete;
+
+	if (!_read_selection(selection, complete))
+	{
+		Logger::append_info("Failed to walk events");
+		return;
+	}
+
+	for (size_t i = 0; i < _dates.size(); i++)
+	{
+		const _DateBlock& block = _dates[i];
+		TimeConverter::timestamp day_start = _day_start(block.date);
+
+		for (uint64_t j = 0; j < block.num_of_events; j++)
+		{
+			Event event;
+			if (!_get_event(block.first_event + j, event))
+			{
+				return;
+			}
+
+			if ((complete[i] || _is_selected(selection, event, day_start)) && !function(event))
+			{
+				return;
+			}
+		}
+	}
+}
+
+void TTEFileReader::set_entity_domains(const std::vector<domain_id>& entity_domains)
+{
+	_entity_domains = entity_domains;
+	_block_domains.clear();
+}
+
+TTEFileReader::DateRange TTEFileReader::dates(const std::vector<entity_id>& entities)
+{
+	Selection selection;
+	selection.entities = entities;
+
+	return dates(selection);
+}
+
+TTEFileReader::EventRange TTEFileReader::events(const std::vector<entity_id>& entities)
+{
+	return events(entities, EventFilter::empty());
+}
+
+TTEFileReader::EventRange TTEFileReader::events(const std::vector<entity_id>& entities, EventFilter filter)
+{
+	Selection selection;
+	selection.entities = entities;
+
+	return events(selection, filter);
+}
+
+uint64_t TTEFileReader::count_events(const std::vector<entity_id>& entities)
+{
+	Selection selection;
+	selection.entities = entities;
+
+	return count_events(selection);
+}
+
+void TTEFileReader::walk_events(const std::vector<entity_id>& entities, EventWalker function)
+{
+	Selection selection;
+	selection.entities = entities;
+
+	walk_events(selection, function);
+}
+
+TTEFileReader::Cursor TTEFileReader::cursor_at_start() const
+{
+	return Cursor();
+}
+
+TTEFileReader::Cursor TTEFileReader::cursor_at_end()
+{
+	Cursor cursor;
+
+	if (!_refresh_blocks() || _blocks.empty())
+	{
+		return cursor;
+	}
+
+	cursor.date_index = uint16_t(_blocks.size() - 1);
+	cursor.event_index = _blocks.back().num_of_events;
+
+	return cursor;
+}
+
+uint64_t TTEFileReader::tail(Cursor& cursor, EventWalker function)
+{
+	TRACE_SPAN("TTEFileReader::tail");
+
+	if (!_refresh_blocks())
+	{
+		Logger::append_info("Failed to tail events");
+		return 0;
+	}
+
+	if (!_has_events_after(cursor))
+	{
+		return 0;
+	}
+
+	if (!_open())
+	{
+		Logger::append_info("Failed to tail events");
+		return 0;
+	}
+
+	TTEFileEvent::encoded_event events[_tail_chunk_size];
+
+	uint64_t num_of_walked_events = 0;
+	bool stop = false;
+
+	while (!stop && cursor.date_index < _blocks.size())
+	{
+		const _DateBlock& block = _blocks[cursor.date_index];
+
+		// Only the last block can still grow, the cursor stays there until a new block is appended
+		if (cursor.event_index >= block.num_of_events)
+		{
+			if (size_t(cursor.date_index) + 1 >= _blocks.size())
+			{
+				break;
+			}
+
+			cursor.date_index++;
+			cursor.event_index = 0;
+			continue;
+		}
+
+		uint64_t events_to_read = (std::min<uint64_t>)(block.num_of_events - cursor.event_index, _tail_chunk_size);
+
+		_file.seekg(block.start_offset + uint64_t(cursor.event_index) * sizeof(TTEFileEvent::encoded_event), std::ios::beg);
+		_file.read(reinterpret_cast<char*>(events), events_to_read * sizeof(TTEFileEvent::encoded_event));
+
+		if (!_file)
+		{
+			Logger::log_error("Failed to read events: {}", StringConverter::to_utf8(_file_path));
+			break;
+		}
+
+		for (uint64_t i = 0; i < events_to_read; i++)
+		{
+			cursor.event_index++;
+			num_of_walked_events++;
+
+			if (!function(Event(block.date, TTEFileEvent::decode(events[i]))))
+			{
+				stop = true;
+				break;
+			}
+		}
+	}
+
+	_close();
+
+	return num_of_walked_events;
+}
+
+bool TTEFileReader::wait(const Cursor& cursor, std::chrono::milliseconds timeout)
+{
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+
+	while (true)
+	{
+		// Read before checking the file, so a write in between still wakes the wait below
+		uint64_t generation = ChangeNotifier::generation();
+
+		if (_refresh_blocks() && _has_events_after(cursor))
+		{
+			return true;
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now >= deadline)
+		{
+			return false;
+		}
+
+		std::chrono::milliseconds remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+		ChangeNotifier::wait(generation, (std::min)(remaining, _tail_poll_interval));
+	}
+}
+
 bool TTEFileReader::_open()
 {
 	if (!std::filesystem::exists(_file_path))
@@ -355,7 +634,7 @@ bool TTEFileReader::_open()
 		return false;
 	}
 
-	_file.open(_file_path, std::ios::in | std::ios::binary);
+	_file.open(std::filesystem::path(_file_path), std::ios::in | std::ios::binary);
 
 	if (!_file.is_open())
 	{
@@ -381,112 +660,545 @@ bool TTEFileReader::_close()
 
 bool TTEFileReader::_read_header()
 {
-	if (!_open())
-	{
-		Logger::append_info("Failed to read header");
-		return false;
-	}
-
 	_file.seekg(0, std::ios::beg);
 
 	char magic[4];
 	_file.read(magic, 3);
 	magic[3] = '\0';
 
-	if (std::strcmp(magic, "TTE") != 0)
+	if (!_file || std::strcmp(magic, "TTE") != 0)
 	{
 		Logger::log_error("Invalid file format: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
 
-		_close();
+	_file.read(reinterpret_cast<char*>(&_num_of_dates), sizeof(_num_of_dates));
 
+	return true;
+}
+
+bool TTEFileReader::_read_dates(DateFilter filter, const RoaringBitmap* blocks)
+{
+	if (!_refresh_blocks())
+	{
+		Logger::append_info("Failed to read dates");
 		return false;
 	}
 
-	_file.read(reinterpret_cast<char*>(&_num_of_dates), sizeof(_num_of_dates));
+	std::vector<_DateBlock> dates;
+	dates.reserve(_blocks.size());
 
-	return _close();
+	uint64_t first_event = 0;
+
+	for (size_t i = 0; i < _blocks.size(); i++)
+	{
+		_DateBlock block = _blocks[i];
+
+		if ((blocks != nullptr && !blocks->contains(uint16_t(i))) || !filter(block.date))
+		{
+			continue;
+		}
+
+		block.first_event = first_event;
+		first_event += block.num_of_events;
+
+		dates.push_back(block);
+	}
+
+	// Buffered events stay valid as long as the new table only extends the old one
+	bool extends = dates.size() >= _dates.size();
+
+	for (size_t i = 0; extends && i < _dates.size(); i++)
+	{
+		extends = dates[i].start_offset == _dates[i].start_offset && dates[i].num_of_events >= _dates[i].num_of_events
+			&& (i + 1 == _dates.size() || dates[i].num_of_events == _dates[i].num_of_events);
+	}
+
+	if (!extends)
+	{
+		_encoded_event_buffer.clear();
+		_encoded_event_buffer.start_index_in_file = 0;
+		_encoded_event_buffer.stop_index_in_file = 0;
+	}
+
+	_dates = std::move(dates);
+
+	return true;
 }
 
-bool TTEFileReader::_read_dates(DateFilter filter)
+bool TTEFileReader::_refresh_blocks()
 {
+	FileStamp stamp;
+	if (!FileStamp::read(_file_path, stamp))
+	{
+		Logger::log_error("File does not exist: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	if (stamp == _stamp)
+	{
+		return true;
+	}
+
+	TRACE_SPAN("TTEFileReader::_refresh_blocks");
+
+	if (!_open())
+	{
+		return false;
+	}
+
 	if (!_read_header())
 	{
-		Logger::append_info("Failed to read dates");
+		_blocks.clear();
+		_stamp = FileStamp();
+
+		_close();
 		return false;
 	}
 
+	uint64_t offset = 5;
+
+	// The writer only appends, either to the last block or as new blocks, so a grown file is parsed from the last known block
+	if (stamp.size > _stamp.size && !_blocks.empty() && _num_of_dates >= _blocks.size())
+	{
+		_DateBlock& last_block = _blocks.back();
+
+		TTEFileDate::encoded_date encoded_date = 0;
+		uint32_t num_of_events = 0;
+
+		_file.seekg(last_block.start_offset - sizeof(num_of_events) - sizeof(encoded_date), std::ios::beg);
+		_file.read(reinterpret_cast<char*>(&encoded_date), sizeof(encoded_date));
+		_file.read(reinterpret_cast<char*>(&num_of_events), sizeof(num_of_events));
+
+		if (_file && Date(TTEFileDate::decode(encoded_date)) == last_block.date && num_of_events >= last_block.num_of_events)
+		{
+			last_block.num_of_events = num_of_events;
+			offset = last_block.start_offset + uint64_t(num_of_events) * sizeof(TTEFileEvent::encoded_event);
+		}
+		else
+		{
+			_blocks.clear();
+		}
+	}
+	else
+	{
+		_blocks.clear();
+	}
+
+	if (_blocks.empty())
+	{
+		_encoded_event_buffer.clear();
+		_encoded_event_buffer.start_index_in_file = 0;
+		_encoded_event_buffer.stop_index_in_file = 0;
+
+		_dates.clear();
+	}
+
+	bool complete = _parse_blocks(offset);
+
+	// The writer updates the count before it appends the event, so the last block can claim more events than were written
+	if (!_blocks.empty())
+	{
+		_DateBlock& last_block = _blocks.back();
+
+		uint64_t written_events = stamp.size > last_block.start_offset ? (stamp.size - last_block.start_offset) / sizeof(TTEFileEvent::encoded_event) : 0;
+
+		if (written_events < last_block.num_of_events)
+		{
+			last_block.num_of_events = uint32_t(written_events);
+			complete = false;
+		}
+	}
+
+	// A block that is still being written is parsed again on the next refresh
+	_stamp = complete ? stamp : FileStamp();
+
+	return _close();
+}
+
+bool TTEFileReader::_refresh_entity_index()
+{
+	if (!_refresh_blocks())
+	{
+		return false;
+	}
+
+	if (!_entity_index_read)
+	{
+		_entity_index.read(TTEFileEntityIndex::path_of(_file_path));
+		_entity_index_read = true;
+	}
+
+	// An index of a file that was rewritten instead of appended to is rebuilt from scratch
+	uint16_t covered = _entity_index.num_of_blocks();
+	uint64_t hash = TTEFileEntityIndex::empty_hash;
+
+	bool extends = covered <= _blocks.size();
+
+	for (uint16_t i = 0; extends && i < covered; i++)
+	{
+		uint32_t num_of_events = i + 1 == covered ? _entity_index.last_events() : _blocks[i].num_of_events;
+		extends = num_of_events <= _blocks[i].num_of_events;
+
+		TTEFileDate::encoded_date date = 0;
+		TTEFileDate(_blocks[i].date.year, _blocks[i].date.month, _blocks[i].date.day).encode(date);
+
+		hash = TTEFileEntityIndex::hash_block(hash, date, num_of_events);
+	}
+
+	FileStamp stamp;
+	if (!FileStamp::read(_file_path, stamp))
+	{
+		return false;
+	}
+
+	if (!extends || hash != _entity_index.blocks_hash() || !_entity_index.matches(stamp))
+	{
+		_entity_index.clear();
+		covered = 0;
+	}
+	else if (_entity_index_covers_blocks())
+	{
+		return true;
+	}
+
+	_block_domains.clear();
+
+	TRACE_SPAN("TTEFileReader::_refresh_entity_index");
+
 	if (!_open())
+	{
+		return false;
+	}
+
+	TTEFileEvent::encoded_event events[_tail_chunk_size];
+
+	// The last covered block may have grown, so indexing resumes inside it
+	size_t first_block = covered > 0 ? covered - 1 : 0;
+	uint64_t first_event = covered > 0 ? _entity_index.last_events() : 0;
+
+	hash = TTEFileEntityIndex::empty_hash;
+
+	for (size_t i = 0; i < _blocks.size(); i++)
+	{
+		const _DateBlock& block = _blocks[i];
+
+		TTEFileDate::encoded_date date = 0;
+		TTEFileDate(block.date.year, block.date.month, block.date.day).encode(date);
+
+		hash = TTEFileEntityIndex::hash_block(hash, date, block.num_of_events);
+
+		if (i < first_block)
+		{
+			continue;
+		}
+
+		uint64_t event_index = i == first_block ? first_event : 0;
+
+		while (event_index < block.num_of_events)
+		{
+			uint64_t events_to_read = (std::min<uint64_t>)(block.num_of_events - event_index, _tail_chunk_size);
+
+			_file.seekg(block.start_offset + event_index * sizeof(TTEFileEvent::encoded_event), std::ios::beg);
+			_file.read(reinterpret_cast<char*>(events), events_to_read * sizeof(TTEFileEvent::encoded_event));
+
+			if (!_file)
+			{
+				Logger::log_error("Failed to read events: {}", StringConverter::to_utf8(_file_path));
+
+				_entity_index.clear();
+				_close();
+				return false;
+			}
+
+			for (uint64_t j = 0; j < events_to_read; j++)
+			{
+				TTEFileEvent event = TTEFileEvent::decode(events[j]);
+				_entity_index.add(event.entity, uint16_t(i), uint32_t(event.hour) * 3600 + uint32_t(event.minute) * 60 + event.second);
+			}
+
+			event_index += events_to_read;
+		}
+	}
+
+	_close();
+
+	_entity_index.cover(uint16_t(_blocks.size()), _blocks.empty() ? 0 : _blocks.back().num_of_events, hash, stamp);
+	_entity_index.optimize();
+
+	// A read-only directory only costs the rebuild on the next open
+	_entity_index.write(TTEFileEntityIndex::path_of(_file_path));
+
+	Logger::log_info("Indexed entities of {} date blocks from block {}: {}", _blocks.size(), first_block, StringConverter::to_utf8(_file_path));
+
+	return true;
+}
+
+bool TTEFileReader::_entity_index_covers_blocks() const
+{
+	if (_entity_index.num_of_blocks() != _blocks.size())
+	{
+		return false;
+	}
+
+	return _blocks.empty() || _entity_index.last_events() == _blocks.back().num_of_events;
+}
+
+void TTEFileReader::_refresh_block_domains()
+{
+	if (_block_domains.size() == _entity_index.num_of_blocks())
+	{
+		return;
+	}
+
+	_block_domains.assign(_entity_index.num_of_blocks(), std::bitset<256>());
+
+	for (size_t entity = 0; entity < _entity_index.num_of_entities(); entity++)
+	{
+		const RoaringBitmap* blocks = _entity_index.blocks(entity_id(entity));
+
+		for (RoaringBitmap::value_type block : blocks->values())
+		{
+			// The domain of an unknown entity could be any, so its blocks are never skipped for their domains
+			if (entity < _entity_domains.size())
+				_block_domains[block].set(_entity_domains[entity]);
+			else
+				_block_domains[block].set();
+		}
+	}
+}
+
+bool TTEFileReader::_read_selection(const Selection& selection, std::vector<bool>& complete)
+{
+	complete.clear();
+
+	// Without the domains of the entities no event would match, which would look like a range without data
+	if (!selection.domains.empty() && _entity_domains.empty())
+	{
+		Logger::log_error("Selection by domain without entity domains, see set_entity_domains: {}", StringConverter::to_utf8(_file_path));
+		_dates.clear();
+		return false;
+	}
+
+	auto is_day_aligned = [](TimeConverter::timestamp time)
+		{
+			return time == (std::numeric_limits<TimeConverter::timestamp>::min)() || time == (std::numeric_limits<TimeConverter::timestamp>::max)()
+				|| time % TimeConverter::seconds_per_day == 0;
+		};
+
+	// Date blocks alone answer selections of whole days, anything finer needs the entity index
+	bool use_index = !selection.entities.empty() || !selection.domains.empty() || !is_day_aligned(selection.from) || !is_day_aligned(selection.to);
+
+	if (use_index && !_refresh_entity_index())
+	{
+		Logger::append_info("Failed to read entity index, reading every date block");
+		use_index = false;
+	}
+
+	if (!_refresh_blocks())
 	{
 		Logger::append_info("Failed to read dates");
 		return false;
 	}
 
-	_file.seekg(5, std::ios::beg);
+	if (use_index && !_entity_index_covers_blocks())
+	{
+		use_index = false;
+	}
+
+	std::vector<entity_id> entities = selection.entities;
+	std::sort(entities.begin(), entities.end());
+	entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+	RoaringBitmap entity_blocks;
+	std::bitset<256> domains;
+
+	if (use_index)
+	{
+		entity_blocks = _entity_index.blocks(entities);
+
+		for (domain_id domain : selection.domains)
+		{
+			domains.set(domain);
+		}
+
+		if (!selection.domains.empty())
+		{
+			_refresh_block_domains();
+		}
+	}
+
+	RoaringBitmap blocks;
+
+	for (size_t i = 0; i < _blocks.size(); i++)
+	{
+		TimeConverter::timestamp day_start = _day_start(_blocks[i].date);
+
+		// Without the index the whole day is assumed to hold events
+		TimeConverter::timestamp first = day_start;
+		TimeConverter::timestamp last = day_start + TimeConverter::seconds_per_day - 1;
+
+		bool is_complete = entities.empty() && selection.domains.empty();
+
+		if (use_index)
+		{
+			is_complete = true;
+
+			const TTEFileEntityIndex::BlockSummary& summary = _entity_index.summaries()[i];
+
+			if (summary.num_of_entities == 0)
+			{
+				continue;
+			}
+
+			first = day_start + summary.first_second;
+			last = day_start + summary.last_second;
+
+			if (!entities.empty())
+			{
+				if (!entity_blocks.contains(uint16_t(i)))
+				{
+					continue;
+				}
+
+				// Every entity of the block is selected once as many selected entities occur in it
+				size_t num_of_entities = 0;
+
+				for (entity_id entity : entities)
+				{
+					const RoaringBitmap* blocks_of_entity = _entity_index.blocks(entity);
+					num_of_entities += blocks_of_entity != nullptr && blocks_of_entity->contains(uint16_t(i)) ? 1 : 0;
+				}
+
+				is_complete = num_of_entities >= summary.num_of_entities;
+			}
+
+			if (!selection.domains.empty())
+			{
+				if ((_block_domains[i] & domains).none())
+				{
+					continue;
+				}
+
+				is_complete = is_complete && (_block_domains[i] & ~domains).none();
+			}
+		}
+
+		if (last < selection.from || first >= selection.to)
+		{
+			continue;
+		}
+
+		is_complete = is_complete && first >= selection.from && last < selection.to;
+
+		blocks.add(uint16_t(i));
+		complete.push_back(is_complete);
+	}
+
+	return _read_dates(DateFilter::empty(), &blocks);
+}
+
+bool TTEFileReader::_is_selected(const Selection& selection, const Event& event, TimeConverter::timestamp day_start) const
+{
+	TimeConverter::timestamp time = day_start + event.hour * 3600 + event.minute * 60 + event.second;
+
+	if (time < selection.from || time >= selection.to)
+	{
+		return false;
+	}
+
+	if (!selection.entities.empty() && std::find(selection.entities.begin(), selection.entities.end(), event.entity) == selection.entities.end())
+	{
+		return false;
+	}
+
+	if (selection.domains.empty())
+	{
+		return true;
+	}
+
+	return event.entity < _entity_domains.size() && std::find(selection.domains.begin(), selection.domains.end(), _entity_domains[event.entity]) != selection.domains.end();
+}
+
+TimeConverter::timestamp TTEFileReader::_day_start(const Date& date)
+{
+	return TimeConverter::to_timestamp(2000 + date.year, date.month, date.day, 0, 0, 0);
+}
+
+bool TTEFileReader::_has_events_after(const Cursor& cursor) const
+{
+	if (cursor.date_index >= _blocks.size())
+	{
+		return false;
+	}
+
+	return cursor.event_index < _blocks[cursor.date_index].num_of_events || size_t(cursor.date_index) + 1 < _blocks.size();
+}
+
+bool TTEFileReader::_parse_blocks(uint64_t offset)
+{
+	_blocks.reserve(_num_of_dates);
 
-	_dates.clear();
-	_dates.reserve(_num_of_dates);
+	_file.seekg(offset, std::ios::beg);
 
-	for (uint16_t i = 0; i < _num_of_dates; ++i)
+	while (_blocks.size() < _num_of_dates)
 	{
 		_DateBlock block;
 
 		TTEFileDate::encoded_date encoded_date = 0;
 		_file.read(reinterpret_cast<char*>(&encoded_date), sizeof(encoded_date));
 
-		TTEFileDate raw_date = TTEFileDate::decode(encoded_date);
-
 		uint32_t num_of_events = 0;
 		_file.read(reinterpret_cast<char*>(&num_of_events), sizeof(num_of_events));
 
-		Date date(raw_date);
+		if (!_file)
+		{
+			_file.clear();
+			_num_of_dates = uint16_t(_blocks.size());
+			return false;
+		}
 
-		block.date = date;
+		block.date = Date(TTEFileDate::decode(encoded_date));
 		block.num_of_events = num_of_events;
 		block.start_offset = _file.tellg();
 
-		if (filter(date))
-			_dates.push_back(block);
+		_blocks.push_back(block);
 
-		size_t offset = num_of_events * sizeof(TTEFileEvent::encoded_event);
-		_file.seekg(offset, std::ios::cur);
+		size_t events_size = num_of_events * sizeof(TTEFileEvent::encoded_event);
+		_file.seekg(events_size, std::ios::cur);
 	}
 
-	return _close();
+	return true;
 }
 
 uint16_t TTEFileReader::_date_index(_EventIndex event) const
 {
-	uint16_t date_index = 0;
+	if (_dates.empty())
+	{
+		return 0;
+	}
 
-	uint64_t offset = 0;
+	// Last block starting at or before the event, empty blocks share their first_event with the next block
+	auto it = std::upper_bound(_dates.begin(), _dates.end(), event, [](_EventIndex event, const _DateBlock& block) {
+		return event < block.first_event;
+	});
 
-	for (const _DateBlock& block : _dates)
+	if (it == _dates.begin())
 	{
-		offset += block.num_of_events;
-		if (event < offset)
-		{
-			return date_index;
-		}
-		++date_index;
+		return 0;
 	}
 
-	return 0;
+	return uint16_t(it - _dates.begin() - 1);
 }
 
 uint64_t TTEFileReader::_event_index(_EventIndex event) const
 {
-	uint64_t offset = 0;
-
-	for (const _DateBlock& block : _dates)
+	if (_dates.empty())
 	{
-		if (event < offset + block.num_of_events)
-		{
-			return event - offset;
-		}
-		offset += block.num_of_events;
+		return 0;
 	}
 
-	return 0;
+	return event - _dates[_date_index(event)].first_event;
 }
 
 TTEFileReader::_EventIndex TTEFileReader::_event_location(uint16_t date_index, uint64_t event_index) const
@@ -496,14 +1208,7 @@ TTEFileReader::_EventIndex TTEFileReader::_event_location(uint16_t date_index, u
 		return _event_count();
 	}
 
-	uint64_t offset = 0;
-
-	for (uint16_t i = 0; i < date_index; ++i)
-	{
-		offset += _dates[i].num_of_events;
-	}
-
-	return offset + event_index;
+	return _dates[date_index].first_event + event_index;
 }
 
 uint64_t TTEFileReader::_event_offset(_EventIndex event) const
@@ -516,36 +1221,36 @@ uint64_t TTEFileReader::_event_offset(_EventIndex event) const
 
 TTEFileReader::_EventIndex TTEFileReader::_event_count() const
 {
-	uint64_t offset = 0;
-
-	for (const _DateBlock& block : _dates)
+	if (_dates.empty())
 	{
-		offset += block.num_of_events;
+		return 0;
 	}
 
-	return offset;
+	return _dates.back().first_event + _dates.back().num_of_events;
 }
 
 bool TTEFileReader::_populate_encoded_event_buffer()
 {
+	TRACE_SPAN("TTEFileReader::_populate_encoded_event_buffer");
+
 	if (_encoded_event_buffer.full())
 	{
 		return true;
 	}
 
-	if (!_open())
+	if (_dates.empty() && !_read_dates(DateFilter::empty()))
 	{
 		Logger::append_info("Failed to fill event buffer");
 		return false;
 	}
 
-	if (_num_of_dates == 0 && !_read_dates(DateFilter::empty()))
+	if (!_open())
 	{
 		Logger::append_info("Failed to fill event buffer");
 		return false;
 	}
 
-	uint64_t events_to_read_front = min(_encoded_event_buffer.start_index_in_buffer, _encoded_event_buffer.start_index_in_file);
+	uint64_t events_to_read_front = (std::min<uint64_t>)(_encoded_event_buffer.start_index_in_buffer, _encoded_event_buffer.start_index_in_file);
 
 	_EventIndex current_location = _encoded_event_buffer.start_index_in_file - events_to_read_front;
 	uint64_t events_read_front = 0;
@@ -555,7 +1260,7 @@ bool TTEFileReader::_populate_encoded_event_buffer()
 		uint16_t date_index = _date_index(current_location);
 		uint64_t event_index = _event_index(current_location);
 
-		uint64_t events_to_read = min(events_to_read_front - events_read_front, _dates[date_index].num_of_events - event_index);
+		uint64_t events_to_read = (std::min<uint64_t>)(events_to_read_front - events_read_front, _dates[date_index].num_of_events - event_index);
 
 		uint64_t offset = _event_offset(current_location);
 
@@ -583,7 +1288,7 @@ bool TTEFileReader::_populate_encoded_event_buffer()
 
 	_encoded_event_buffer.start_index_in_file -= events_to_read_front;
 
-	uint64_t events_to_read_back = min(_encoded_event_buffer.capacity - _encoded_event_buffer.stop_index_in_buffer, _event_count() - _encoded_event_buffer.stop_index_in_file);
+	uint64_t events_to_read_back = (std::min<uint64_t>)(_encoded_event_buffer.capacity - _encoded_event_buffer.stop_index_in_buffer, _event_count() - _encoded_event_buffer.stop_index_in_file);
 
 	current_location = _encoded_event_buffer.stop_index_in_file;
 	uint64_t events_read_back = 0;
@@ -593,7 +1298,7 @@ bool TTEFileReader::_populate_encoded_event_buffer()
 		uint16_t date_index = _date_index(current_location);
 		uint64_t event_index = _event_index(current_location);
 
-		uint64_t events_to_read = min(events_to_read_back - events_read_back, _dates[date_index].num_of_events - event_index);
+		uint64_t events_to_read = (std::min<uint64_t>)(events_to_read_back - events_read_back, _dates[date_index].num_of_events - event_index);
 
 		uint64_t offset = _event_offset(current_location);
 
@@ -634,7 +1339,7 @@ bool TTEFileReader::_shift_encoded_events_right(uint64_t n)
 		return _move_encoded_events_to_end();
 	}
 
-	_encoded_event_buffer.shift_right(n, _event_count());
+	_encoded_event_buffer.shift_right(n);
 	return _populate_encoded_event_buffer();
 }
 
@@ -693,38 +1398,24 @@ bool TTEFileReader::_get_event(_EventIndex event_index, Event& event)
 		return true;
 	}
 
-	uint64_t distance_to_start = _encoded_event_buffer.start_index_in_file - event_index;
-	uint64_t distance_to_end = event_index - _encoded_event_buffer.stop_index_in_file;
+	// Refill the buffer around the requested event, keeping some events before it for backwards iteration
+	_EventIndex start = event_index > _encoded_event_buffer_backwards_capacity ? event_index - _encoded_event_buffer_backwards_capacity : 0;
 
-	uint64_t events_to_shift = min(_encoded_event_buffer_forwards_capacity, _encoded_event_buffer.size());
+	_encoded_event_buffer.clear();
+	_encoded_event_buffer.start_index_in_file = start;
+	_encoded_event_buffer.stop_index_in_file = start;
 
-	if (event_index < _encoded_event_buffer.start_index_in_file && distance_to_start < events_to_shift)
-	{
-		events_to_shift = min(events_to_shift, _encoded_event_buffer.start_index_in_file);
-		if (!_shift_encoded_events_left(events_to_shift))
-		{
-			Logger::append_info("Failed to get event");
-			return false;
-		}
-		return _get_event(event_index, event);
-	}
-	else if (event_index >= _encoded_event_buffer.stop_index_in_file && distance_to_end < events_to_shift)
+	if (!_populate_encoded_event_buffer())
 	{
-		events_to_shift = min(events_to_shift, _event_count() - _encoded_event_buffer.stop_index_in_file);
-		if (!_shift_encoded_events_right(events_to_shift))
-		{
-			Logger::append_info("Failed to get event");
-			return false;
-		}
-		return _get_event(event_index, event);
+		Logger::append_info("Failed to get event");
+		return false;
 	}
-	else
+
+	if (event_index < _encoded_event_buffer.start_index_in_file || event_index >= _encoded_event_buffer.stop_index_in_file)
 	{
-		if (!_move_encoded_events(event_index))
-		{
-			Logger::append_info("Failed to get event");
-			return false;
-		}
-		return _get_event(event_index, event);
+		Logger::log_error("Event {} could not be loaded", event_index);
+		return false;
 	}
+
+	return _get_event(event_index, event);
 }
\ No newline at end of file
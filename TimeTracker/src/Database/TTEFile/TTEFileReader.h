@@ -6,17 +6,27 @@
 #include <iterator>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <bitset>
 
 #include <stdint.h>
 #include <cstddef>
 #include <cstring>
 
 #include "TTEFileDate.h"
+#include "TTEFileEntityIndex.h"
 #include "TTEFileEvent.h"
 
+#include "../../Utils/ChangeNotifier.h"
 #include "../../Utils/Logger.h"
+#include "../../Utils/FileStamp.h"
 #include "../../Utils/Filter.h"
+#include "../../Utils/RoaringBitmap.h"
 #include "../../Utils/StringConverter.h"
+#include "../../Utils/TimeConverter.h"
+#include "../../Utils/Trace.h"
 
 class TTEFileReader
 {
@@ -193,6 +203,8 @@ public:
 	EventRange events();
 	EventRange events(EventFilter filter);
 
+	bool get_event(uint64_t index, Event& event);
+
 	bool event_exists(const Event& event);
 
 	uint64_t count_events();
@@ -201,6 +213,59 @@ public:
 
 	void walk_events(EventFilter filter, EventWalker function);
 
+public:
+	// Unlike a filter, a selection is visible to the reader, which skips the date blocks the entity index rules out
+	struct Selection
+	{
+		// Half-open range, see TimeConverter.h
+		TimeConverter::timestamp from = (std::numeric_limits<TimeConverter::timestamp>::min)();
+		TimeConverter::timestamp to = (std::numeric_limits<TimeConverter::timestamp>::max)();
+
+		// Empty for all
+		std::vector<domain_id> domains;
+		std::vector<entity_id> entities;
+	};
+
+	DateRange dates(const Selection& selection);
+
+	EventRange events(const Selection& selection);
+	EventRange events(const Selection& selection, EventFilter filter);
+
+	// Blocks the selection covers entirely are counted without reading their events
+	uint64_t count_events(const Selection& selection);
+
+	void walk_events(const Selection& selection, EventWalker function);
+
+	// TTE files do not know the domains, selections by domain need the domain of every entity and fail without them
+	void set_entity_domains(const std::vector<domain_id>& entity_domains);
+
+	// Only visit the date blocks where one of the entities occurs
+	DateRange dates(const std::vector<entity_id>& entities);
+
+	EventRange events(const std::vector<entity_id>& entities);
+	EventRange events(const std::vector<entity_id>& entities, EventFilter filter);
+
+	uint64_t count_events(const std::vector<entity_id>& entities);
+
+	void walk_events(const std::vector<entity_id>& entities, EventWalker function);
+
+public:
+	// Position after the last event consumed by tail(), in file order and ignoring filters
+	struct Cursor
+	{
+		uint16_t date_index = 0;
+		uint32_t event_index = 0;
+	};
+
+	Cursor cursor_at_start() const;
+	Cursor cursor_at_end();
+
+	// Walks the events appended after the cursor and moves the cursor past every walked event
+	uint64_t tail(Cursor& cursor, EventWalker function);
+
+	// Blocks until events were appended after the cursor, returns false on timeout
+	bool wait(const Cursor& cursor, std::chrono::milliseconds timeout);
+
 private:
 	std::wstring _file_path;
 	std::fstream _file;
@@ -219,12 +284,50 @@ private:
 		uint32_t num_of_events = 0;
 
 		uint64_t start_offset = 0;
+
+		// Index of the first event of this block in _dates
+		uint64_t first_event = 0;
 	};
 
 	uint16_t _num_of_dates = 0;
 	std::vector<_DateBlock> _dates;
 
-	bool _read_dates(DateFilter filter);
+	bool _read_dates(DateFilter filter, const RoaringBitmap* blocks = nullptr);
+
+private:
+	// Every date block in the file, parsed once and extended as the file grows
+	std::vector<_DateBlock> _blocks;
+	FileStamp _stamp;
+
+	bool _refresh_blocks();
+	bool _parse_blocks(uint64_t offset);
+
+	bool _has_events_after(const Cursor& cursor) const;
+
+	// Writers in other processes do not notify, so waits recheck the file at this interval
+	static constexpr std::chrono::milliseconds _tail_poll_interval{ 100 };
+	static constexpr uint64_t _tail_chunk_size = 1024;
+
+private:
+	TTEFileEntityIndex _entity_index;
+	bool _entity_index_read = false;
+
+	// Reads the index beside the file and indexes the blocks it does not cover yet
+	bool _refresh_entity_index();
+	bool _entity_index_covers_blocks() const;
+
+	std::vector<domain_id> _entity_domains;
+
+	// Domains present in every indexed block, derived from the entity index
+	std::vector<std::bitset<256>> _block_domains;
+
+	void _refresh_block_domains();
+
+	// Reads the date blocks the selection can match, complete is set for the blocks it matches entirely
+	bool _read_selection(const Selection& selection, std::vector<bool>& complete);
+	bool _is_selected(const Selection& selection, const Event& event, TimeConverter::timestamp day_start) const;
+
+	static TimeConverter::timestamp _day_start(const Date& date);
 
 private:
 	uint16_t _date_index(_EventIndex event) const;
@@ -258,7 +361,7 @@ private:
 		void clear();
 
 		void shift_left(uint64_t n);
-		void shift_right(uint64_t n, _EventIndex max_location);
+		void shift_right(uint64_t n);
 
 		TTEFileEvent::encoded_event& operator[](_EventIndex event);
 	};
@@ -318,10 +421,10 @@ void TTEFileReader::_EncodedEventBuffer<N>::shift_left(uint64_t n)
 		return;
 	}
 
-	uint64_t new_first_element = min(start_index_in_buffer + n, capacity - 1);
+	uint64_t new_first_element = (std::min<uint64_t>)(start_index_in_buffer + n, capacity - 1);
 	if (new_first_element < start_index_in_buffer)
 		new_first_element = capacity - 1;
-	uint64_t new_last_element = min(stop_index_in_buffer + n, capacity - 1);
+	uint64_t new_last_element = (std::min<uint64_t>)(stop_index_in_buffer + n, capacity - 1);
 	if (new_last_element < stop_index_in_buffer)
 		new_last_element = capacity - 1;
 
@@ -336,7 +439,7 @@ void TTEFileReader::_EncodedEventBuffer<N>::shift_left(uint64_t n)
 }
 
 template <uint64_t N>
-void TTEFileReader::_EncodedEventBuffer<N>::shift_right(uint64_t n, _EventIndex event_count)
+void TTEFileReader::_EncodedEventBuffer<N>::shift_right(uint64_t n)
 {
 	if (n >= size())
 	{
@@ -345,10 +448,10 @@ void TTEFileReader::_EncodedEventBuffer<N>::shift_right(uint64_t n, _EventIndex
 		return;
 	}
 
-	uint64_t new_first_element = max(start_index_in_buffer - n, 0);
+	uint64_t new_first_element = (std::max<uint64_t>)(start_index_in_buffer - n, 0);
 	if (new_first_element > start_index_in_buffer)
 		new_first_element = 0;
-	uint64_t new_last_element = max(stop_index_in_buffer - n, 0);
+	uint64_t new_last_element = (std::max<uint64_t>)(stop_index_in_buffer - n, 0);
 	if (new_last_element > stop_index_in_buffer)
 		new_last_element = 0;
 
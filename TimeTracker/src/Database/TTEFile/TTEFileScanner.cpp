@@ -0,0 +1,109 @@
+#include "TTEFileScanner.h"
+
+TTEFileScanner::TTEFileScanner(const std::wstring& file_path)
+	: _file_path(file_path), _file()
+{
+}
+
+bool TTEFileScanner::open()
+{
+	_file.open(std::filesystem::path(_file_path), std::ios::in | std::ios::binary);
+
+	if (!_file.is_open())
+	{
+		Logger::log_error("Failed to open file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	char magic[4];
+	_file.read(magic, 3);
+	magic[3] = '\0';
+
+	if (!_file || std::string(magic) != "TTE")
+	{
+		Logger::log_error("Invalid file format: {}", StringConverter::to_utf8(_file_path));
+		_file.close();
+		return false;
+	}
+
+	_file.read(reinterpret_cast<char*>(&_num_of_dates), sizeof(_num_of_dates));
+
+	_dates_read = 0;
+	_events_left = 0;
+	_failed = false;
+
+	return bool(_file);
+}
+
+void TTEFileScanner::close()
+{
+	_file.close();
+}
+
+uint16_t TTEFileScanner::num_of_dates() const
+{
+	return _num_of_dates;
+}
+
+bool TTEFileScanner::failed() const
+{
+	return _failed;
+}
+
+bool TTEFileScanner::next_block(TTEFileDate::encoded_date& date, uint32_t& num_of_events)
+{
+	if (!_file.is_open() || _dates_read >= _num_of_dates)
+	{
+		return false;
+	}
+
+	if (_events_left > 0)
+	{
+		_file.seekg(std::streamoff(_events_left) * std::streamoff(sizeof(TTEFileEvent::encoded_event)), std::ios::cur);
+		_events_left = 0;
+	}
+
+	_file.read(reinterpret_cast<char*>(&date), sizeof(date));
+	_file.read(reinterpret_cast<char*>(&num_of_events), sizeof(num_of_events));
+
+	if (!_file)
+	{
+		Logger::log_warning("Truncated date block in {}", StringConverter::to_utf8(_file_path));
+		_failed = true;
+		return false;
+	}
+
+	_dates_read++;
+	_events_left = num_of_events;
+
+	return true;
+}
+
+size_t TTEFileScanner::read_events(TTEFileEvent::encoded_event* events, size_t max_events)
+{
+	size_t events_to_read = (std::min<size_t>)(max_events, _events_left);
+
+	if (events_to_read == 0)
+	{
+		return 0;
+	}
+
+	_file.read(reinterpret_cast<char*>(events), std::streamsize(events_to_read * sizeof(TTEFileEvent::encoded_event)));
+
+	size_t events_read = size_t(_file.gcount()) / sizeof(TTEFileEvent::encoded_event);
+
+	// A truncated block ends the file
+	if (events_read < events_to_read)
+	{
+		Logger::log_warning("Truncated date block in {}", StringConverter::to_utf8(_file_path));
+		_dates_read = _num_of_dates;
+		_events_left = 0;
+		_failed = true;
+
+		return events_read;
+	}
+
+	_events_left -= uint32_t(events_read);
+
+	return events_read;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <algorithm>
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "TTEFileDate.h"
+#include "TTEFileEvent.h"
+
+#include "../../Utils/Logger.h"
+#include "../../Utils/StringConverter.h"
+
+/*
+* Forward-only reader that streams a TTE file block by block (see
+* TTEFileWriter.h for the layout). Unlike TTEFileReader it keeps no index of
+* the date blocks, so its memory does not grow with the file, and events are
+* returned still encoded. Meant for tools that process whole files once.
+*/
+
+class TTEFileScanner
+{
+public:
+	TTEFileScanner(const std::wstring& file_path);
+
+	bool open();
+	void close();
+
+	uint16_t num_of_dates() const;
+
+	// Moves to the next date block, skipping unread events of the current one. Returns false at the end of the file
+	bool next_block(TTEFileDate::encoded_date& date, uint32_t& num_of_events);
+
+	// Reads up to max_events of the current block, returns 0 once the block is exhausted
+	size_t read_events(TTEFileEvent::encoded_event* events, size_t max_events);
+
+	// True when a truncated block ended the file before all of its dates were read
+	bool failed() const;
+
+private:
+	std::wstring _file_path;
+	std::ifstream _file;
+
+	uint16_t _num_of_dates = 0;
+	uint16_t _dates_read = 0;
+
+	uint32_t _events_left = 0;
+
+	bool _failed = false;
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "TTEFileStreamWriter.h"
+
+TTEFileStreamWriter::TTEFileStreamWriter(const std::wstring& file_path)
+	: _file_path(file_path), _file()
+{
+}
+
+TTEFileStreamWriter::~TTEFileStreamWriter()
+{
+	if (_file.is_open())
+	{
+		close();
+	}
+}
+
+bool TTEFileStreamWriter::open()
+{
+	std::filesystem::path path(_file_path);
+
+	if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+	{
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!_file.is_open())
+	{
+		Logger::log_error("Unable to create file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	_num_of_dates = 0;
+	_num_of_events = 0;
+	_current_events.clear();
+
+	_file.write("TTE", 3);
+	_file.write(reinterpret_cast<const char*>(&_num_of_dates), sizeof(_num_of_dates));
+
+	return _file.good();
+}
+
+bool TTEFileStreamWriter::close()
+{
+	if (!_file.is_open())
+	{
+		return false;
+	}
+
+	bool success = _flush_date_block();
+
+	_file.seekp(3);
+	_file.write(reinterpret_cast<const char*>(&_num_of_dates), sizeof(_num_of_dates));
+
+	success = success && _file.good();
+
+	_file.close();
+
+	ChangeNotifier::notify();
+
+	if (!success)
+	{
+		Logger::log_error("Failed to write file: {}", StringConverter::to_utf8(_file_path));
+	}
+
+	return success;
+}
+
+bool TTEFileStreamWriter::add_event(const TTEFileDate& date, const TTEFileEvent& event)
+{
+	if (!_file.is_open())
+	{
+		Logger::log_error("File is not open: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	if (!(date == _current_date) || _current_events.empty())
+	{
+		if (!_flush_date_block())
+		{
+			return false;
+		}
+
+		if (_num_of_dates == UINT16_MAX)
+		{
+			Logger::log_error("Too many dates for a single file: {}", StringConverter::to_utf8(_file_path));
+			return false;
+		}
+
+		_current_date = date;
+	}
+
+	TTEFileEvent::encoded_event encoded_event;
+	event.encode(encoded_event);
+
+	_current_events.push_back(encoded_event);
+	_num_of_events++;
+
+	return true;
+}
+
+uint16_t TTEFileStreamWriter::num_of_dates() const
+{
+	return _num_of_dates;
+}
+
+uint64_t TTEFileStreamWriter::num_of_events() const
+{
+	return _num_of_events;
+}
+
+bool TTEFileStreamWriter::_flush_date_block()
+{
+	if (_current_events.empty())
+	{
+		return true;
+	}
+
+	TTEFileDate::encoded_date encoded_date;
+	_current_date.encode(encoded_date);
+
+	uint32_t num_of_events = uint32_t(_current_events.size());
+
+	_file.write(reinterpret_cast<const char*>(&encoded_date), sizeof(encoded_date));
+	_file.write(reinterpret_cast<const char*>(&num_of_events), sizeof(num_of_events));
+	_file.write(reinterpret_cast<const char*>(_current_events.data()), num_of_events * sizeof(TTEFileEvent::encoded_event));
+
+	_current_events.clear();
+	_num_of_dates++;
+
+	return _file.good();
+}
\ No newline at end of file
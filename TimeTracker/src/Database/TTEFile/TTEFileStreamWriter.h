@@ -0,0 +1,52 @@
+#pragma once
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "TTEFileDate.h"
+#include "TTEFileEvent.h"
+
+#include "../../Utils/ChangeNotifier.h"
+#include "../../Utils/Logger.h"
+#include "../../Utils/StringConverter.h"
+
+/*
+* Writes a complete TTE file front to back (see TTEFileWriter.h for the layout).
+* 
+* Unlike TTEFileWriter, which reopens the file and walks every date block for
+* each event, events are buffered for the current date and written in one go
+* when the date changes. The header is patched in close(). Events must be
+* added in chronological order.
+*/
+
+class TTEFileStreamWriter
+{
+public:
+	TTEFileStreamWriter(const std::wstring& file_path);
+	~TTEFileStreamWriter();
+
+	bool open();
+	bool close();
+
+	bool add_event(const TTEFileDate& date, const TTEFileEvent& event);
+
+	uint16_t num_of_dates() const;
+	uint64_t num_of_events() const;
+
+private:
+	std::wstring _file_path;
+	std::ofstream _file;
+
+private:
+	TTEFileDate _current_date;
+	std::vector<TTEFileEvent::encoded_event> _current_events;
+
+	uint16_t _num_of_dates = 0;
+	uint64_t _num_of_events = 0;
+
+	bool _flush_date_block();
+};
\ No newline at end of file
@@ -168,6 +168,11 @@ bool TTEFileWriter::Event::check_validity() const
 
 // TTEFile
 
+Metrics::Histogram& TTEFileWriter::_add_event_latency = Metrics::histogram("timetracker_tte_writer_add_event_seconds", "Latency of appending an event to the events file", 1e-9);
+
+Metrics::Counter& TTEFileWriter::_written_events = Metrics::counter("timetracker_tte_writer_events_total", "Events appended to the events file");
+Metrics::Counter& TTEFileWriter::_written_dates = Metrics::counter("timetracker_tte_writer_dates_total", "Date blocks started in the events file");
+
 TTEFileWriter::TTEFileWriter(const std::wstring& file_path)
 	: _file_path(file_path)
 {
@@ -183,6 +188,10 @@ TTEFileWriter::~TTEFileWriter()
 
 bool TTEFileWriter::add_event(const Date& date, const Event& event)
 {
+	TRACE_SPAN("TTEFileWriter::add_event");
+
+	Metrics::Timer timer(_add_event_latency);
+
 	if (!_file.is_open() && !_open())
 	{
 		return false;
@@ -241,10 +250,16 @@ bool TTEFileWriter::add_event(const Date& date, const Event& event)
 		_file.write(reinterpret_cast<const char*>(&num_of_events), sizeof(num_of_events));
 
 		_file.write(reinterpret_cast<const char*>(&encoded_event), sizeof(encoded_event));
+
+		_written_dates.increment();
 	}
 
 	_close();
 
+	_written_events.increment();
+
+	ChangeNotifier::notify();
+
 	return true;
 }
 
@@ -276,6 +291,8 @@ size_t TTEFileWriter::get_num_of_dates()
 
 bool TTEFileWriter::get_last_event(Event& event)
 {
+	TRACE_SPAN("TTEFileWriter::get_last_event");
+
 	size_t num_of_dates = get_num_of_dates();
 
 	if (num_of_dates == 0)
@@ -309,6 +326,8 @@ bool TTEFileWriter::get_last_event(Event& event)
 
 bool TTEFileWriter::get_last_date(Date& date)
 {
+	TRACE_SPAN("TTEFileWriter::get_last_date");
+
 	size_t num_of_dates = get_num_of_dates();
 
 	if (num_of_dates == 0)
@@ -332,6 +351,8 @@ bool TTEFileWriter::get_last_date(Date& date)
 
 bool TTEFileWriter::_open()
 {
+	TRACE_SPAN("TTEFileWriter::_open");
+
 	if (!std::filesystem::exists(_file_path))
 	{
 		if (!_create())
@@ -340,7 +361,7 @@ bool TTEFileWriter::_open()
 		}
 	}
 
-	_file.open(_file_path, std::ios::in | std::ios::out | std::ios::binary);
+	_file.open(std::filesystem::path(_file_path), std::ios::in | std::ios::out | std::ios::binary);
 
 	if (!_file.is_open())
 	{
@@ -353,6 +374,8 @@ bool TTEFileWriter::_open()
 
 bool TTEFileWriter::_close()
 {
+	TRACE_SPAN("TTEFileWriter::_close");
+
 	_file.close();
 	if (_file.is_open())
 	{
@@ -369,7 +392,7 @@ bool TTEFileWriter::_create()
 		std::filesystem::create_directories(std::filesystem::path(_file_path).parent_path());
 	}
 
-	_file.open(_file_path, std::ios::out | std::ios::binary);
+	_file.open(std::filesystem::path(_file_path), std::ios::out | std::ios::binary);
 
 	if (!_file.is_open())
 	{
@@ -389,6 +412,8 @@ bool TTEFileWriter::_create()
 
 const TTEFileWriter::_DateBlock TTEFileWriter::_last_date_block()
 {
+	TRACE_SPAN("TTEFileWriter::_last_date_block");
+
 	_DateBlock last_date_block;
 	bool was_open = _file.is_open();
 
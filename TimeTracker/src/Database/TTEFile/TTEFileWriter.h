@@ -7,7 +7,10 @@
 #include <stdint.h>
 #include <time.h>
 
+#include "../../Utils/ChangeNotifier.h"
 #include "../../Utils/Logger.h"
+#include "../../Utils/Metrics.h"
+#include "../../Utils/Trace.h"
 
 /*
 * Time Tracker Event File
@@ -80,6 +83,12 @@ private:
 	std::wstring _file_path;
 	std::fstream _file;
 
+private:
+	static Metrics::Histogram& _add_event_latency;
+
+	static Metrics::Counter& _written_events;
+	static Metrics::Counter& _written_dates;
+
 private:
 	bool _open();
 	bool _close();
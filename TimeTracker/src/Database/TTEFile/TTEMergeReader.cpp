@@ -0,0 +1,216 @@
+#include "TTEMergeReader.h"
+
+TTEMergeReader::TTEMergeReader(const std::vector<std::wstring>& file_paths)
+{
+	for (const std::wstring& file_path : file_paths)
+	{
+		_inputs.push_back(std::make_unique<_Input>(file_path));
+	}
+}
+
+size_t TTEMergeReader::num_of_inputs() const
+{
+	return _inputs.size();
+}
+
+TTEMergeReader::Event TTEMergeReader::EventIterator::operator*() const
+{
+	return _reader->_current();
+}
+
+TTEMergeReader::EventIterator& TTEMergeReader::EventIterator::operator++()
+{
+	if (_reader != nullptr && !_reader->_advance())
+	{
+		_reader = nullptr;
+	}
+
+	return *this;
+}
+
+TTEMergeReader::EventIterator TTEMergeReader::EventIterator::operator++(int)
+{
+	EventIterator it = *this;
+	++(*this);
+	return it;
+}
+
+bool TTEMergeReader::EventIterator::operator==(const EventIterator& other) const
+{
+	return _reader == other._reader;
+}
+
+size_t TTEMergeReader::EventIterator::input() const
+{
+	return _reader->_heap.front();
+}
+
+TTEMergeReader::EventIterator::EventIterator(TTEMergeReader* reader)
+	: _reader(reader)
+{
+}
+
+TTEMergeReader::EventRange::EventRange(TTEMergeReader* reader)
+	: _reader(reader)
+{
+}
+
+TTEMergeReader::EventIterator TTEMergeReader::EventRange::begin() const
+{
+	return EventIterator(_reader != nullptr && !_reader->_heap.empty() ? _reader : nullptr);
+}
+
+TTEMergeReader::EventIterator TTEMergeReader::EventRange::end() const
+{
+	return EventIterator(nullptr);
+}
+
+TTEMergeReader::EventRange TTEMergeReader::events()
+{
+	return events(EventFilter::empty());
+}
+
+TTEMergeReader::EventRange TTEMergeReader::events(EventFilter filter)
+{
+	_start(filter);
+
+	return EventRange(this);
+}
+
+uint64_t TTEMergeReader::count_events()
+{
+	return count_events(EventFilter::empty());
+}
+
+uint64_t TTEMergeReader::count_events(EventFilter filter)
+{
+	uint64_t count = 0;
+
+	walk_events(
+		filter,
+		[&count](const Event&)
+		{
+			++count;
+			return true;
+		}
+	);
+
+	return count;
+}
+
+void TTEMergeReader::walk_events(EventFilter filter, EventWalker function)
+{
+	TRACE_SPAN("TTEMergeReader::walk_events");
+
+	for (const Event& event : events(filter))
+	{
+		if (!function(event))
+		{
+			break;
+		}
+	}
+}
+
+TTEMergeReader::_Input::_Input(const std::wstring& file_path)
+	: reader(file_path), cursor(reader.cursor_at_start())
+{
+	lookahead.reserve(_lookahead_size);
+}
+
+bool TTEMergeReader::_Input::fill()
+{
+	if (next < lookahead.size())
+	{
+		return true;
+	}
+
+	lookahead.clear();
+	next = 0;
+
+	reader.tail(cursor, [this](const Event& event) {
+		lookahead.push_back(event);
+		return lookahead.size() < _lookahead_size;
+	});
+
+	return !lookahead.empty();
+}
+
+void TTEMergeReader::_start(EventFilter filter)
+{
+	_filter = filter;
+	_heap.clear();
+
+	for (size_t i = 0; i < _inputs.size(); i++)
+	{
+		_Input& input = *_inputs[i];
+
+		input.cursor = input.reader.cursor_at_start();
+		input.lookahead.clear();
+		input.next = 0;
+
+		if (input.fill())
+		{
+			_heap.push_back(i);
+		}
+	}
+
+	auto later = [this](size_t a, size_t b) { return _later(a, b); };
+	std::make_heap(_heap.begin(), _heap.end(), later);
+
+	// The range starts at the first event that passes the filter
+	if (!_heap.empty() && !_filter(_current()))
+	{
+		_advance();
+	}
+}
+
+bool TTEMergeReader::_advance()
+{
+	auto later = [this](size_t a, size_t b) { return _later(a, b); };
+
+	while (!_heap.empty())
+	{
+		std::pop_heap(_heap.begin(), _heap.end(), later);
+
+		_Input& input = *_inputs[_heap.back()];
+		input.next++;
+
+		if (input.fill())
+			std::push_heap(_heap.begin(), _heap.end(), later);
+		else
+			_heap.pop_back();
+
+		if (!_heap.empty() && _filter(_current()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const TTEMergeReader::Event& TTEMergeReader::_current() const
+{
+	const _Input& input = *_inputs[_heap.front()];
+
+	return input.lookahead[input.next];
+}
+
+bool TTEMergeReader::_later(size_t a, size_t b) const
+{
+	const _Input& input_a = *_inputs[a];
+	const _Input& input_b = *_inputs[b];
+
+	uint64_t key_a = _key(input_a.lookahead[input_a.next]);
+	uint64_t key_b = _key(input_b.lookahead[input_b.next]);
+
+	return key_a != key_b ? key_a > key_b : a > b;
+}
+
+uint64_t TTEMergeReader::_key(const Event& event)
+{
+	uint64_t date = (uint64_t(event.date.year) << 9) | (uint64_t(event.date.month) << 5) | uint64_t(event.date.day);
+	uint64_t second = uint64_t(event.hour) * 3600 + uint64_t(event.minute) * 60 + event.second;
+
+	return (date << 17) | second;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "TTEFileReader.h"
+
+#include "../../Utils/Logger.h"
+#include "../../Utils/Trace.h"
+
+/*
+* Reads the events of several TTE files as one stream in time order, e.g. the
+* main file next to segments or the file of another device.
+* 
+* Every input keeps a cursor into its file and a lookahead buffer that is
+* refilled a chunk at a time, so every file is still read sequentially no
+* matter how the inputs interleave. A heap over the next event of every input
+* picks the earliest one, ties go to the earlier input so the merge is stable.
+* 
+* Unlike TTEFileReader::EventRange the merged range can only be iterated
+* forwards and once, every call to events() starts a new pass over the inputs.
+*/
+
+class TTEMergeReader
+{
+public:
+	using Date = TTEFileReader::Date;
+	using Event = TTEFileReader::Event;
+	using EventFilter = TTEFileReader::EventFilter;
+	using EventWalker = TTEFileReader::EventWalker;
+
+public:
+	TTEMergeReader(const std::vector<std::wstring>& file_paths);
+
+	size_t num_of_inputs() const;
+
+public:
+	class EventIterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Event;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Event*;
+		using reference = Event&;
+
+	public:
+		Event operator*() const;
+
+		EventIterator& operator++();
+		EventIterator operator++(int);
+
+		bool operator==(const EventIterator& other) const;
+
+		// Index of the file the current event was read from
+		size_t input() const;
+
+	private:
+		EventIterator(TTEMergeReader* reader);
+
+		// Null once the merged stream is exhausted
+		TTEMergeReader* _reader;
+
+		friend class TTEMergeReader;
+	};
+
+	struct EventRange
+	{
+	public:
+		EventIterator begin() const;
+		EventIterator end() const;
+
+	private:
+		EventRange(TTEMergeReader* reader);
+
+		TTEMergeReader* _reader;
+
+		friend class TTEMergeReader;
+	};
+
+public:
+	EventRange events();
+	EventRange events(EventFilter filter);
+
+	uint64_t count_events();
+	uint64_t count_events(EventFilter filter);
+
+	void walk_events(EventFilter filter, EventWalker function);
+
+private:
+	struct _Input
+	{
+		TTEFileReader reader;
+		TTEFileReader::Cursor cursor;
+
+		std::vector<Event> lookahead;
+		size_t next = 0;
+
+		_Input(const std::wstring& file_path);
+
+		// Refills the lookahead once it is consumed, false at the end of the file
+		bool fill();
+	};
+
+	std::vector<std::unique_ptr<_Input>> _inputs;
+
+	// Inputs with events left, the earliest next event on top
+	std::vector<size_t> _heap;
+
+	EventFilter _filter = EventFilter::empty();
+
+	static constexpr size_t _lookahead_size = 1024;
+
+private:
+	void _start(EventFilter filter);
+
+	// Moves to the next event that passes the filter, false at the end of the stream
+	bool _advance();
+
+	const Event& _current() const;
+
+	bool _later(size_t a, size_t b) const;
+	static uint64_t _key(const Event& event);
+};
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "TTESegmentManifest.h"
+
+TTESegmentManifest::TTESegmentManifest(const std::wstring& file_path, Period period)
+	: _file_path(file_path), _period(period), _segments()
+{
+}
+
+bool TTESegmentManifest::load()
+{
+	TRACE_SPAN("TTESegmentManifest::load");
+
+	_segments.clear();
+
+	if (!exists())
+	{
+		return true;
+	}
+
+	std::ifstream file(std::filesystem::path(_file_path), std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		Logger::log_error("Failed to open file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	char magic[4];
+	file.read(magic, 3);
+	magic[3] = '\0';
+
+	if (!file || std::string(magic) != "TTM")
+	{
+		Logger::log_error("Invalid file format: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	uint8_t period = 0;
+	file.read(reinterpret_cast<char*>(&period), sizeof(period));
+
+	uint16_t num_of_segments = 0;
+	file.read(reinterpret_cast<char*>(&num_of_segments), sizeof(num_of_segments));
+
+	if (!file || (period != uint8_t(Period::MONTH) && period != uint8_t(Period::QUARTER) && period != uint8_t(Period::YEAR)))
+	{
+		Logger::log_error("Invalid segment period {} in manifest: {}", period, StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	_period = Period(period);
+
+	for (uint16_t i = 0; i < num_of_segments; i++)
+	{
+		Segment segment;
+
+		file.read(reinterpret_cast<char*>(&segment.period_start), sizeof(segment.period_start));
+		file.read(reinterpret_cast<char*>(&segment.first_date), sizeof(segment.first_date));
+		file.read(reinterpret_cast<char*>(&segment.last_date), sizeof(segment.last_date));
+
+		uint8_t sealed = 0;
+		file.read(reinterpret_cast<char*>(&sealed), sizeof(sealed));
+		segment.sealed = sealed != 0;
+
+		uint8_t len = 0;
+		file.read(reinterpret_cast<char*>(&len), sizeof(len));
+
+		std::string name(len, '\0');
+		file.read(name.data(), len);
+
+		segment.file_name = StringConverter::to_utf16(name);
+
+		_segments.push_back(segment);
+	}
+
+	if (!file)
+	{
+		Logger::log_error("Truncated manifest: {}", StringConverter::to_utf8(_file_path));
+		_segments.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool TTESegmentManifest::save()
+{
+	TRACE_SPAN("TTESegmentManifest::save");
+
+	std::filesystem::path path(_file_path);
+
+	if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+	{
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	// Written next to the manifest and renamed over it, so readers never see a partial manifest
+	std::filesystem::path temp_path = path;
+	temp_path += L".tmp";
+
+	{
+		std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open())
+		{
+			Logger::log_error("Unable to create file: {}", StringConverter::to_utf8(temp_path.wstring()));
+			return false;
+		}
+
+		file.write("TTM", 3);
+
+		uint8_t period = uint8_t(_period);
+		file.write(reinterpret_cast<const char*>(&period), sizeof(period));
+
+		uint16_t num_of_segments = uint16_t(_segments.size());
+		file.write(reinterpret_cast<const char*>(&num_of_segments), sizeof(num_of_segments));
+
+		for (const Segment& segment : _segments)
+		{
+			file.write(reinterpret_cast<const char*>(&segment.period_start), sizeof(segment.period_start));
+			file.write(reinterpret_cast<const char*>(&segment.first_date), sizeof(segment.first_date));
+			file.write(reinterpret_cast<const char*>(&segment.last_date), sizeof(segment.last_date));
+
+			uint8_t sealed = segment.sealed ? 1 : 0;
+			file.write(reinterpret_cast<const char*>(&sealed), sizeof(sealed));
+
+			std::string name = StringConverter::to_utf8(segment.file_name);
+
+			uint8_t len = uint8_t(name.size());
+			file.write(reinterpret_cast<const char*>(&len), sizeof(len));
+			file.write(name.data(), len);
+		}
+
+		if (!file.good())
+		{
+			Logger::log_error("Failed to write file: {}", StringConverter::to_utf8(temp_path.wstring()));
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp_path, path, error);
+
+	if (error)
+	{
+		Logger::log_error("Failed to replace manifest: {}", error.message());
+		return false;
+	}
+
+	return true;
+}
+
+bool TTESegmentManifest::exists() const
+{
+	return std::filesystem::exists(_file_path);
+}
+
+TTESegmentManifest::Period TTESegmentManifest::period() const
+{
+	return _period;
+}
+
+const std::vector<TTESegmentManifest::Segment>& TTESegmentManifest::segments() const
+{
+	return _segments;
+}
+
+std::wstring TTESegmentManifest::segment_path(const Segment& segment) const
+{
+	return (std::filesystem::path(_file_path).parent_path() / segment.file_name).wstring();
+}
+
+void TTESegmentManifest::segments(const TTEFileDate& from, const TTEFileDate& to, std::vector<Segment>& segments) const
+{
+	encoded_date encoded_from = _encode(from);
+	encoded_date encoded_to = _encode(to);
+
+	for (const Segment& segment : _segments)
+	{
+		// The writable segment may already hold events past its recorded range
+		if (!segment.sealed)
+		{
+			if (segment.period_start <= encoded_to)
+			{
+				segments.push_back(segment);
+			}
+
+			continue;
+		}
+
+		if (segment.first_date == 0 || segment.last_date < encoded_from || segment.first_date > encoded_to)
+		{
+			continue;
+		}
+
+		segments.push_back(segment);
+	}
+}
+
+bool TTESegmentManifest::add_sealed_segment(const std::wstring& file_path, const TTEFileDate& first_date, const TTEFileDate& last_date)
+{
+	Segment segment;
+
+	segment.file_name = std::filesystem::relative(file_path, std::filesystem::path(_file_path).parent_path()).wstring();
+	segment.period_start = _period_start(first_date);
+	segment.first_date = _encode(first_date);
+	segment.last_date = _encode(last_date);
+	segment.sealed = true;
+
+	if (segment.file_name.empty())
+	{
+		Logger::log_error("Segment is not next to the manifest: {}", StringConverter::to_utf8(file_path));
+		return false;
+	}
+
+	for (Segment& other : _segments)
+	{
+		other.sealed = true;
+	}
+
+	_segments.push_back(segment);
+
+	return save();
+}
+
+bool TTESegmentManifest::writable_segment(const TTEFileDate& date, std::wstring& file_path)
+{
+	encoded_date period_start = _period_start(date);
+
+	if (!_segments.empty() && !_segments.back().sealed && _segments.back().period_start >= period_start)
+	{
+		file_path = segment_path(_segments.back());
+		return true;
+	}
+
+	for (Segment& segment : _segments)
+	{
+		segment.sealed = true;
+	}
+
+	Segment segment;
+	segment.file_name = _segment_file_name(TTEFileDate::decode(period_start));
+	segment.period_start = period_start;
+
+	_segments.push_back(segment);
+
+	Logger::log_info("Starting segment: {}", StringConverter::to_utf8(segment.file_name));
+
+	file_path = segment_path(segment);
+
+	return save();
+}
+
+bool TTESegmentManifest::record_event(const TTEFileDate& date)
+{
+	if (_segments.empty() || _segments.back().sealed)
+	{
+		Logger::log_error("No writable segment");
+		return false;
+	}
+
+	Segment& segment = _segments.back();
+	encoded_date encoded = _encode(date);
+
+	if (segment.first_date != 0 && segment.last_date >= encoded)
+	{
+		return true;
+	}
+
+	if (segment.first_date == 0)
+	{
+		segment.first_date = encoded;
+	}
+
+	segment.last_date = encoded;
+
+	return save();
+}
+
+TTESegmentManifest::encoded_date TTESegmentManifest::_period_start(const TTEFileDate& date) const
+{
+	uint8_t months = uint8_t(_period);
+	uint8_t month = uint8_t((date.month - 1) / months * months + 1);
+
+	return _encode(TTEFileDate(date.year, month, 1));
+}
+
+std::wstring TTESegmentManifest::_segment_file_name(const TTEFileDate& period_start) const
+{
+	std::wstring stem = std::filesystem::path(_file_path).stem().wstring();
+
+	if (_period == Period::YEAR)
+	{
+		return StringConverter::to_utf16(Format::format("{}-{:04}.tte", StringConverter::to_utf8(stem), 2000 + period_start.year));
+	}
+
+	return StringConverter::to_utf16(Format::format("{}-{:04}-{:02}.tte", StringConverter::to_utf8(stem), 2000 + period_start.year, period_start.month));
+}
+
+TTESegmentManifest::encoded_date TTESegmentManifest::_encode(const TTEFileDate& date)
+{
+	encoded_date encoded = 0;
+	date.encode(encoded);
+
+	return encoded;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "TTEFileDate.h"
+
+#include "../../Utils/Format.h"
+#include "../../Utils/Logger.h"
+#include "../../Utils/StringConverter.h"
+#include "../../Utils/Trace.h"
+
+/*
+* Time Tracker Segment Manifest
+* 
+* Events can be split into one TTE file per period (a month by default), the
+* manifest lists these segments in chronological order. Only the last
+* segment is written to, every earlier one is sealed and never changes again,
+* so it can be compressed, archived or rewritten offline. Readers use the
+* date range of each segment to open only the files a query needs.
+* 
+* File names are relative to the directory of the manifest. Dates are
+* encoded as in TTE files, which keeps them ordered.
+* 
+* Layout:
+* 
+* Start:
+*   - 'TTM'                3
+*   - period               1
+*   - num_of_segments      2
+*   - {
+*       period_start:      2
+*       first_date:        2
+*       last_date:         2
+*       sealed:            1
+*       {len: 1, name: len}
+*     }                    [num_of_segments]
+*/
+
+class TTESegmentManifest
+{
+public:
+	using encoded_date = TTEFileDate::encoded_date;
+
+	enum class Period : uint8_t
+	{
+		MONTH = 1,
+		QUARTER = 3,
+		YEAR = 12
+	};
+
+	struct Segment
+	{
+		std::wstring file_name;
+
+		encoded_date period_start = 0;
+
+		// Range of the events in the segment, both 0 while it is empty
+		encoded_date first_date = 0;
+		encoded_date last_date = 0;
+
+		bool sealed = false;
+	};
+
+public:
+	TTESegmentManifest(const std::wstring& file_path, Period period = Period::MONTH);
+
+	bool load();
+	bool save();
+
+	bool exists() const;
+
+	Period period() const;
+
+	const std::vector<Segment>& segments() const;
+	std::wstring segment_path(const Segment& segment) const;
+
+	// Segments with events between from and to, both inclusive
+	void segments(const TTEFileDate& from, const TTEFileDate& to, std::vector<Segment>& segments) const;
+
+	// Adds an existing file, e.g. a single TTE file written before segmentation, and seals it
+	bool add_sealed_segment(const std::wstring& file_path, const TTEFileDate& first_date, const TTEFileDate& last_date);
+
+	// Path of the segment new events on the date go to. Starts and saves a new segment if the date is in a later period
+	bool writable_segment(const TTEFileDate& date, std::wstring& file_path);
+
+	// Extends the date range of the writable segment, saves the manifest if it changed
+	bool record_event(const TTEFileDate& date);
+
+private:
+	std::wstring _file_path;
+	Period _period;
+
+	std::vector<Segment> _segments;
+
+private:
+	encoded_date _period_start(const TTEFileDate& date) const;
+	std::wstring _segment_file_name(const TTEFileDate& period_start) const;
+
+	static encoded_date _encode(const TTEFileDate& date);
+};
\ No newline at end of file
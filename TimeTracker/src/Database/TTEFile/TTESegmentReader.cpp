@@ -0,0 +1,109 @@
+#include "TTESegmentReader.h"
+
+TTESegmentReader::TTESegmentReader(const std::wstring& manifest_file_path)
+	: _manifest(manifest_file_path)
+{
+}
+
+bool TTESegmentReader::reload()
+{
+	_loaded = false;
+	return _load();
+}
+
+size_t TTESegmentReader::count_segments()
+{
+	_load();
+
+	return _manifest.segments().size();
+}
+
+std::vector<std::wstring> TTESegmentReader::segment_paths(const Date& from, const Date& to)
+{
+	std::vector<std::wstring> paths;
+
+	if (!_load())
+	{
+		return paths;
+	}
+
+	std::vector<TTESegmentManifest::Segment> segments;
+	_manifest.segments(TTEFileDate(from.year, from.month, from.day), TTEFileDate(to.year, to.month, to.day), segments);
+
+	for (const TTESegmentManifest::Segment& segment : segments)
+	{
+		paths.push_back(_manifest.segment_path(segment));
+	}
+
+	return paths;
+}
+
+void TTESegmentReader::walk_events(EventWalker function)
+{
+	if (!_load())
+	{
+		return;
+	}
+
+	for (const TTESegmentManifest::Segment& segment : _manifest.segments())
+	{
+		TTEFileReader reader(_manifest.segment_path(segment));
+
+		bool stop = false;
+
+		reader.walk_events(TTEFileReader::EventFilter::empty(), [&function, &stop](const Event& event) {
+			stop = !function(event);
+			return !stop;
+		});
+
+		if (stop)
+		{
+			break;
+		}
+	}
+}
+
+void TTESegmentReader::walk_events(const Date& from, const Date& to, EventWalker function)
+{
+	TRACE_SPAN("TTESegmentReader::walk_events");
+
+	// Whole days, so the readers skip the date blocks outside the range without their entity index
+	TTEFileReader::Selection selection;
+	selection.from = TimeConverter::to_timestamp(2000 + from.year, from.month, from.day, 0, 0, 0);
+	selection.to = TimeConverter::to_timestamp(2000 + to.year, to.month, to.day, 0, 0, 0) + TimeConverter::seconds_per_day;
+
+	for (const std::wstring& path : segment_paths(from, to))
+	{
+		TTEFileReader reader(path);
+
+		bool stop = false;
+
+		reader.walk_events(selection, [&function, &stop](const Event& event) {
+			stop = !function(event);
+			return !stop;
+		});
+
+		if (stop)
+		{
+			break;
+		}
+	}
+}
+
+bool TTESegmentReader::_load()
+{
+	if (_loaded)
+	{
+		return true;
+	}
+
+	if (!_manifest.load())
+	{
+		Logger::append_info("Failed to read segment manifest");
+		return false;
+	}
+
+	_loaded = true;
+
+	return true;
+}
\ No newline at end of file
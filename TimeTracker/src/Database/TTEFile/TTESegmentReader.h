@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "TTEFileDate.h"
+#include "TTEFileReader.h"
+#include "TTESegmentManifest.h"
+
+#include "../../Utils/Logger.h"
+#include "../../Utils/StringConverter.h"
+#include "../../Utils/TimeConverter.h"
+#include "../../Utils/Trace.h"
+
+/*
+* Reads the events of a segmented database (see TTESegmentManifest.h) in
+* chronological order. Queries over a date range only open the segments whose
+* dates overlap it. The manifest is read on first use and again on reload().
+*/
+
+class TTESegmentReader
+{
+public:
+	using Date = TTEFileReader::Date;
+	using Event = TTEFileReader::Event;
+	using EventWalker = TTEFileReader::EventWalker;
+
+public:
+	TTESegmentReader(const std::wstring& manifest_file_path);
+
+	bool reload();
+
+	size_t count_segments();
+
+	// Paths of the segments with events between from and to, both inclusive
+	std::vector<std::wstring> segment_paths(const Date& from, const Date& to);
+
+	void walk_events(EventWalker function);
+	void walk_events(const Date& from, const Date& to, EventWalker function);
+
+private:
+	TTESegmentManifest _manifest;
+
+	bool _loaded = false;
+
+	bool _load();
+};
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "TTRFileMappedReader.h"
+
+TTRFileMappedReader::TTRFileMappedReader(const std::wstring& file_path)
+	: _file_path(file_path)
+{
+}
+
+bool TTRFileMappedReader::reload()
+{
+	_loaded = false;
+	return _load();
+}
+
+bool TTRFileMappedReader::refresh()
+{
+	FileStamp stamp;
+	if (_loaded && FileStamp::read(_file_path, stamp, _stamped_head_size) && stamp == _stamp)
+	{
+		return true;
+	}
+
+	return reload();
+}
+
+const std::vector<std::string_view>& TTRFileMappedReader::domains()
+{
+	_load();
+	return _domains;
+}
+
+const std::vector<TTRFileMappedReader::Entity>& TTRFileMappedReader::entities()
+{
+	_load();
+	return _entities;
+}
+
+size_t TTRFileMappedReader::count_domains()
+{
+	_load();
+	return _domains.size();
+}
+
+size_t TTRFileMappedReader::count_entities()
+{
+	_load();
+	return _entities.size();
+}
+
+TTRFileMappedReader::domain_id TTRFileMappedReader::get_domain_id(std::string_view domain)
+{
+	_load();
+
+	auto it = _domain_ids.find(domain);
+	if (it == _domain_ids.end())
+	{
+		return (domain_id)-1;
+	}
+
+	return it->second;
+}
+
+TTRFileMappedReader::entity_id TTRFileMappedReader::get_entity_id(domain_id id, std::string_view entity)
+{
+	_load();
+
+	if (id >= _entity_ids.size())
+	{
+		return (entity_id)-1;
+	}
+
+	auto it = _entity_ids[id].find(entity);
+	if (it == _entity_ids[id].end())
+	{
+		return (entity_id)-1;
+	}
+
+	return it->second;
+}
+
+std::string_view TTRFileMappedReader::get_domain_name(domain_id id)
+{
+	_load();
+
+	if (id >= _domains.size())
+	{
+		return std::string_view();
+	}
+
+	return _domains[id];
+}
+
+std::string_view TTRFileMappedReader::get_entity(entity_id id)
+{
+	_load();
+
+	if (id >= _entities.size())
+	{
+		return std::string_view();
+	}
+
+	return _entities[id].name;
+}
+
+std::string_view TTRFileMappedReader::get_domain(entity_id id)
+{
+	_load();
+
+	if (id >= _entities.size())
+	{
+		return std::string_view();
+	}
+
+	return get_domain_name(_entities[id].domain_id);
+}
+
+TTRFileMappedReader::domain_id TTRFileMappedReader::get_entity_domain(entity_id id)
+{
+	_load();
+
+	if (id >= _entities.size())
+	{
+		return (domain_id)-1;
+	}
+
+	return _entities[id].domain_id;
+}
+
+bool TTRFileMappedReader::_load()
+{
+	if (_loaded)
+	{
+		return true;
+	}
+
+	TRACE_SPAN("TTRFileMappedReader::_load");
+
+	_domains.clear();
+	_entities.clear();
+	_domain_ids.clear();
+	_entity_ids.clear();
+
+	// Stamped before mapping, a write in between only causes one more reload
+	if (!FileStamp::read(_file_path, _stamp, _stamped_head_size))
+	{
+		_stamp = FileStamp();
+	}
+
+	if (!_file.open(_file_path))
+	{
+		Logger::log_error("Failed to map file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	// Marked as loaded even if the file is malformed, so it is not mapped again on every call
+	_loaded = true;
+
+	if (!_build_tables())
+	{
+		Logger::log_error("Invalid file format: {}", StringConverter::to_utf8(_file_path));
+
+		_domains.clear();
+		_entities.clear();
+		_domain_ids.clear();
+		_entity_ids.clear();
+
+		return false;
+	}
+
+	return true;
+}
+
+bool TTRFileMappedReader::_build_tables()
+{
+	if (_file.size() < 15 || std::memcmp(_file.data(), "TTR", 3) != 0)
+	{
+		return false;
+	}
+
+	size_t offset = 3;
+
+	uint32_t offset_to_domains_start, offset_to_domains_end, offset_to_entities;
+
+	if (!_read(offset, offset_to_domains_start) || !_read(offset, offset_to_domains_end) || !_read(offset, offset_to_entities))
+	{
+		return false;
+	}
+
+	offset = offset_to_domains_start;
+
+	uint8_t num_of_domains;
+	if (!_read(offset, num_of_domains))
+	{
+		return false;
+	}
+
+	_domains.reserve(num_of_domains);
+	_entity_ids.resize(num_of_domains);
+
+	for (domain_id i = 0; i < num_of_domains; i++)
+	{
+		std::string_view name;
+		if (!_read_name(offset, name))
+		{
+			return false;
+		}
+
+		_domains.push_back(name);
+		_domain_ids.emplace(name, i);
+	}
+
+	offset = offset_to_entities;
+
+	uint16_t num_of_entities;
+	if (!_read(offset, num_of_entities))
+	{
+		return false;
+	}
+
+	_entities.reserve(num_of_entities);
+
+	for (entity_id i = 0; i < num_of_entities; i++)
+	{
+		Entity entity;
+
+		if (!_read(offset, entity.domain_id) || !_read_name(offset, entity.name))
+		{
+			return false;
+		}
+
+		if (entity.domain_id >= num_of_domains)
+		{
+			return false;
+		}
+
+		_entities.push_back(entity);
+		_entity_ids[entity.domain_id].emplace(entity.name, i);
+	}
+
+	return true;
+}
+
+bool TTRFileMappedReader::_read_name(size_t& offset, std::string_view& name) const
+{
+	uint8_t len;
+	if (!_read(offset, len) || offset + len > _file.size())
+	{
+		return false;
+	}
+
+	name = std::string_view(_file.data() + offset, len);
+	offset += len;
+
+	return true;
+}
\ No newline at end of file
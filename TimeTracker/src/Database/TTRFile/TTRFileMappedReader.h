@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+#include <stdint.h>
+#include <cstring>
+
+#include "../../Utils/Logger.h"
+#include "../../Utils/FileStamp.h"
+#include "../../Utils/MappedFile.h"
+#include "../../Utils/StringConverter.h"
+#include "../../Utils/Trace.h"
+
+/*
+* Read-only view of a TTR file (see TTRFileWriter.h for the layout).
+* 
+* The file is mapped into memory on first use and a table of domains and
+* entities is built in one pass. Names are returned as std::string_views
+* into the mapping, and all lookups by ID or name are O(1). The views stay
+* valid until reload() or destruction.
+* 
+* Changes made to the file after it was mapped are only visible after
+* reload(). refresh() reloads only if the size, the write time or the header
+* of the file changed since it was mapped, so it can be called before every
+* query.
+*/
+
+class TTRFileMappedReader
+{
+public:
+	using domain_id = uint8_t;
+	using entity_id = uint16_t;
+
+	struct Entity
+	{
+		TTRFileMappedReader::domain_id domain_id;
+		std::string_view name;
+	};
+
+public:
+	TTRFileMappedReader(const std::wstring& file_path);
+
+	bool reload();
+	bool refresh();
+
+	const std::vector<std::string_view>& domains();
+	const std::vector<Entity>& entities();
+
+	size_t count_domains();
+	size_t count_entities();
+
+	// Return -1 if the name is not in the registry
+	domain_id get_domain_id(std::string_view domain);
+	entity_id get_entity_id(domain_id id, std::string_view entity);
+
+	// Return an empty view if the ID is not in the registry
+	std::string_view get_domain_name(domain_id id);
+	std::string_view get_entity(entity_id id);
+
+	// Domain of an entity, as TTRFileReader::get_domain
+	std::string_view get_domain(entity_id id);
+	domain_id get_entity_domain(entity_id id);
+
+private:
+	std::wstring _file_path;
+	MappedFile _file;
+
+	bool _loaded = false;
+	FileStamp _stamp;
+
+	// Header and domain count, add_domain rewrites both without changing the size
+	static constexpr size_t _stamped_head_size = 16;
+
+private:
+	std::vector<std::string_view> _domains;
+	std::vector<Entity> _entities;
+
+	std::unordered_map<std::string_view, domain_id> _domain_ids;
+	std::vector<std::unordered_map<std::string_view, entity_id>> _entity_ids;
+
+private:
+	bool _load();
+	bool _build_tables();
+
+	template <typename T>
+	bool _read(size_t& offset, T& value) const;
+	bool _read_name(size_t& offset, std::string_view& name) const;
+};
+
+template <typename T>
+bool TTRFileMappedReader::_read(size_t& offset, T& value) const
+{
+	if (offset + sizeof(T) > _file.size())
+	{
+		return false;
+	}
+
+	std::memcpy(&value, _file.data() + offset, sizeof(T));
+	offset += sizeof(T);
+
+	return true;
+}
\ No newline at end of file
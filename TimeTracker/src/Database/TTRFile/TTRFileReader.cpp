@@ -1,7 +1,7 @@
 #include "TTRFileReader.h"
 
 TTRFileReader::TTRFileReader(const std::wstring& file_path)
-	: _file_path(file_path), _file()
+	: _file_path(file_path), _file(), _header{ 0, 0, 0 }, _num_of_domains(0), _num_of_entities(0)
 {
 }
 
@@ -99,15 +99,15 @@ bool TTRFileReader::domain_exists(DomainFilter filter)
 
 void TTRFileReader::walk_domains(DomainFilter filter, DomainWalker function)
 {
-	if (!_read_domains(filter))
+	if (!_refresh())
 	{
 		Logger::append_info("Failed to walk domains from file: {}", StringConverter::to_utf8(_file_path));
 		return;
 	}
 
-	for (domain_id i = 0; i < _num_of_domains; i++)
+	for (size_t i = 0; i < _all_domains.size(); i++)
 	{
-		if (!function(i, _domains[i]))
+		if (filter(domain_id(i), _all_domains[i]) && !function(domain_id(i), _all_domains[i]))
 		{
 			break;
 		}
@@ -220,42 +220,22 @@ TTRFileReader::entity_id TTRFileReader::get_entity_id(const std::string& entity,
 
 std::string TTRFileReader::get_entity(entity_id id)
 {
-	std::string entity = "";
-
-	walk_entities(
-		EntityFilter::empty(),
-		[id, &entity](entity_id current_id, const Entity& e)
-		{
-			if (id == current_id)
-			{
-				entity = e.name;
-				return false;
-			}
-			return true;
-		}
-	);
+	if (!_refresh() || id >= _all_entities.size())
+	{
+		return "";
+	}
 
-	return entity;
+	return _all_entities[id].name;
 }
 
 std::string TTRFileReader::get_domain(entity_id id)
 {
-	std::string domain = "";
-
-	walk_entities(
-		EntityFilter::empty(),
-		[id, &domain, this](entity_id current_id, const Entity& e)
-		{
-			if (id == current_id)
-			{
-				domain = _domains[e.domain_id];
-				return false;
-			}
-			return true;
-		}
-	);
+	if (!_refresh() || id >= _all_entities.size() || _all_entities[id].domain_id >= _all_domains.size())
+	{
+		return "";
+	}
 
-	return domain;
+	return _all_domains[_all_entities[id].domain_id];
 }
 
 uint16_t TTRFileReader::count_entities(EntityFilter filter)
@@ -281,21 +261,15 @@ bool TTRFileReader::entity_exists(EntityFilter filter)
 
 void TTRFileReader::walk_entities(EntityFilter filter, EntityWalker function)
 {
-	if (!_read_domains(DomainFilter::empty()))
+	if (!_refresh())
 	{
 		Logger::append_info("Failed to walk entities from file: {}", StringConverter::to_utf8(_file_path));
 		return;
 	}
 
-	if (!_read_entities(filter))
+	for (size_t i = 0; i < _all_entities.size(); i++)
 	{
-		Logger::append_info("Failed to walk entities from file: {}", StringConverter::to_utf8(_file_path));
-		return;
-	}
-
-	for (entity_id i = 0; i < _num_of_entities; i++)
-	{
-		if (!function(i, _entities[i]))
+		if (filter(entity_id(i), _all_entities[i]) && !function(entity_id(i), _all_entities[i]))
 		{
 			break;
 		}
@@ -310,7 +284,7 @@ bool TTRFileReader::_open()
 		return false;
 	}
 
-	_file.open(_file_path, std::ios::in | std::ios::binary);
+	_file.open(std::filesystem::path(_file_path), std::ios::in | std::ios::binary);
 
 	if (!_file.is_open())
 	{
@@ -336,24 +310,15 @@ bool TTRFileReader::_close()
 
 bool TTRFileReader::_read_header()
 {
-	if (!_open())
-	{
-		Logger::append_info("Failed to read header");
-		return false;
-	}
-
 	_file.seekg(0, std::ios::beg);
 
 	char magic[4];
 	_file.read(magic, 3);
 	magic[3] = '\0';
 
-	if (std::strcmp(magic, "TTR") != 0)
+	if (!_file || std::strcmp(magic, "TTR") != 0)
 	{
 		Logger::log_error("Invalid file format: {}", StringConverter::to_utf8(_file_path));
-
-		_close();
-
 		return false;
 	}
 
@@ -361,28 +326,124 @@ bool TTRFileReader::_read_header()
 	_file.read(reinterpret_cast<char*>(&_header.offset_to_domains_end), sizeof(_header.offset_to_domains_end));
 	_file.read(reinterpret_cast<char*>(&_header.offset_to_entities), sizeof(_header.offset_to_entities));
 
-	return _close();
+	return bool(_file);
 }
 
 bool TTRFileReader::_read_domains(DomainFilter filter)
 {
-	if (!_read_header())
+	if (!_refresh())
 	{
 		Logger::append_info("Failed to read domains");
 		return false;
 	}
 
+	if (filter.is_empty() && _domains_generation == _generation)
+	{
+		return true;
+	}
+
+	_domains.clear();
+
+	for (size_t i = 0; i < _all_domains.size(); i++)
+	{
+		if (filter(domain_id(i), _all_domains[i]))
+			_domains.push_back(_all_domains[i]);
+	}
+
+	_domains_generation = filter.is_empty() ? _generation : 0;
+
+	return true;
+}
+
+bool TTRFileReader::_read_entities(EntityFilter filter)
+{
+	if (!_refresh())
+	{
+		Logger::append_info("Failed to read entities");
+		return false;
+	}
+
+	if (filter.is_empty() && _entities_generation == _generation)
+	{
+		return true;
+	}
+
+	_entities.clear();
+
+	for (size_t i = 0; i < _all_entities.size(); i++)
+	{
+		if (filter(entity_id(i), _all_entities[i]))
+			_entities.push_back(_all_entities[i]);
+	}
+
+	_entities_generation = filter.is_empty() ? _generation : 0;
+
+	return true;
+}
+
+bool TTRFileReader::_refresh()
+{
+	FileStamp stamp;
+	if (!FileStamp::read(_file_path, stamp, _stamped_head_size))
+	{
+		Logger::log_error("File does not exist: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	if (stamp == _stamp)
+	{
+		return true;
+	}
+
+	TRACE_SPAN("TTRFileReader::_refresh");
+
 	if (!_open())
 	{
-		Logger::append_info("Failed to read domains");
 		return false;
 	}
 
+	_generation++;
+
+	Header header = _header;
+
+	if (!_read_header() || !_parse_domains())
+	{
+		_all_domains.clear();
+		_all_entities.clear();
+		_stamp = FileStamp();
+
+		_close();
+		return false;
+	}
+
+	uint64_t offset = _header.offset_to_entities + sizeof(_num_of_entities);
+
+	// Domains are rewritten in place, entities are only ever appended, so a grown file is parsed from the last known entity
+	if (stamp.size >= _stamp.size && header.offset_to_entities == _header.offset_to_entities && !_all_entities.empty())
+	{
+		offset = _entities_end;
+	}
+	else
+	{
+		_all_entities.clear();
+	}
+
+	bool complete = _parse_entities(offset);
+
+	// An entity that is still being written is parsed again on the next refresh
+	_stamp = complete ? stamp : FileStamp();
+
+	return _close();
+}
+
+bool TTRFileReader::_parse_domains()
+{
 	_file.seekg(_header.offset_to_domains_start);
 
 	_file.read(reinterpret_cast<char*>(&_num_of_domains), sizeof(_num_of_domains));
 
-	_domains.clear();
+	_all_domains.clear();
+	_all_domains.reserve(_num_of_domains);
 
 	for (domain_id i = 0; i < _num_of_domains; i++)
 	{
@@ -393,34 +454,29 @@ bool TTRFileReader::_read_domains(DomainFilter filter)
 		domain.resize(domain_len);
 		_file.read(domain.data(), domain_len);
 
-		if (filter(i, domain))
-			_domains.push_back(domain);
+		_all_domains.push_back(domain);
 	}
 
-	return _close();
+	return bool(_file);
 }
 
-bool TTRFileReader::_read_entities(EntityFilter filter)
+bool TTRFileReader::_parse_entities(uint64_t offset)
 {
-	if (!_read_header())
-	{
-		Logger::append_info("Failed to read entities");
-		return false;
-	}
+	_file.seekg(_header.offset_to_entities);
 
-	if (!_open())
+	_file.read(reinterpret_cast<char*>(&_num_of_entities), sizeof(_num_of_entities));
+
+	if (_num_of_entities < _all_entities.size())
 	{
-		Logger::append_info("Failed to read entities");
-		return false;
+		_all_entities.clear();
+		offset = _header.offset_to_entities + sizeof(_num_of_entities);
 	}
 
-	_file.seekg(_header.offset_to_entities);
+	_all_entities.reserve(_num_of_entities);
 
-	_file.read(reinterpret_cast<char*>(&_num_of_entities), sizeof(_num_of_entities));
+	_file.seekg(offset);
 
-	_entities.clear();
-
-	for (entity_id i = 0; i < _num_of_entities; i++)
+	while (_all_entities.size() < _num_of_entities)
 	{
 		Entity entity;
 
@@ -432,9 +488,16 @@ bool TTRFileReader::_read_entities(EntityFilter filter)
 		entity.name.resize(entity_len);
 		_file.read(entity.name.data(), entity_len);
 
-		if (filter(i, entity))
-			_entities.push_back(entity);
+		if (!_file)
+		{
+			_file.clear();
+			_num_of_entities = uint16_t(_all_entities.size());
+			return false;
+		}
+
+		_all_entities.push_back(entity);
+		_entities_end = _file.tellg();
 	}
 
-	return _close();
+	return true;
 }
\ No newline at end of file
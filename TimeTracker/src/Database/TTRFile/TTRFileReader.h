@@ -11,8 +11,10 @@
 #include <cstddef>
 
 #include "../../Utils/Logger.h"
+#include "../../Utils/FileStamp.h"
 #include "../../Utils/Filter.h"
 #include "../../Utils/StringConverter.h"
+#include "../../Utils/Trace.h"
 
 class TTRFileReader
 {
@@ -63,7 +65,7 @@ public:
 public:
 	struct Entity
 	{
-		domain_id domain_id;
+		TTRFileReader::domain_id domain_id;
 		std::string name;
 	};
 
@@ -136,4 +138,25 @@ private:
 	std::vector<Entity> _entities;
 
 	bool _read_entities(EntityFilter filter);
+
+private:
+	// Every domain and entity in the file, parsed once and extended as the file grows
+	std::vector<std::string> _all_domains;
+	std::vector<Entity> _all_entities;
+
+	uint64_t _entities_end = 0;
+
+	FileStamp _stamp;
+
+	// Header and domain count, add_domain rewrites both without changing the size
+	static constexpr size_t _stamped_head_size = 16;
+
+	// Bumped whenever the cache changes, _domains and _entities remember the generation they were copied from
+	uint64_t _generation = 1;
+	uint64_t _domains_generation = 0;
+	uint64_t _entities_generation = 0;
+
+	bool _refresh();
+	bool _parse_domains();
+	bool _parse_entities(uint64_t offset);
 };
\ No newline at end of file
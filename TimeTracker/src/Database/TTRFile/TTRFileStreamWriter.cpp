@@ -0,0 +1,111 @@
+#include "TTRFileStreamWriter.h"
+
+TTRFileStreamWriter::TTRFileStreamWriter(const std::wstring& file_path)
+	: _file_path(file_path)
+{
+}
+
+bool TTRFileStreamWriter::add_domain(std::string_view domain, domain_id& id)
+{
+	if (_domains.size() >= max_domains || domain.size() > UINT8_MAX)
+	{
+		Logger::log_error("Unable to add domain: {}", domain);
+		return false;
+	}
+
+	id = domain_id(_domains.size());
+	_domains.emplace_back(domain);
+
+	return true;
+}
+
+bool TTRFileStreamWriter::add_entity(domain_id domain, std::string_view entity, entity_id& id)
+{
+	if (_entities.size() >= max_entities || entity.size() > UINT8_MAX || domain >= _domains.size())
+	{
+		Logger::log_error("Unable to add entity: {}", entity);
+		return false;
+	}
+
+	id = entity_id(_entities.size());
+	_entities.push_back(_Entity{ domain, std::string(entity) });
+
+	return true;
+}
+
+size_t TTRFileStreamWriter::num_of_domains() const
+{
+	return _domains.size();
+}
+
+size_t TTRFileStreamWriter::num_of_entities() const
+{
+	return _entities.size();
+}
+
+bool TTRFileStreamWriter::write()
+{
+	std::filesystem::path path(_file_path);
+
+	if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+	{
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		Logger::log_error("Unable to create file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	uint32_t domains_size = 0;
+	for (const std::string& domain : _domains)
+	{
+		domains_size += uint32_t(domain.size()) + 1;
+	}
+
+	uint32_t offset_to_current_domain = 15;
+	uint32_t offset_to_domains_end = 16 + domains_size;
+	uint32_t offset_to_entities = 16 + (std::max)(uint32_t(DOMAINS_MIN_BLOCK_SIZE), domains_size);
+
+	file.write("TTR", 3);
+	file.write(reinterpret_cast<const char*>(&offset_to_current_domain), sizeof(offset_to_current_domain));
+	file.write(reinterpret_cast<const char*>(&offset_to_domains_end), sizeof(offset_to_domains_end));
+	file.write(reinterpret_cast<const char*>(&offset_to_entities), sizeof(offset_to_entities));
+
+	uint8_t num_of_domains = uint8_t(_domains.size());
+	file.write(reinterpret_cast<const char*>(&num_of_domains), sizeof(num_of_domains));
+
+	for (const std::string& domain : _domains)
+	{
+		uint8_t len = uint8_t(domain.size());
+		file.write(reinterpret_cast<const char*>(&len), sizeof(len));
+		file.write(domain.data(), len);
+	}
+
+	std::string padding(offset_to_entities - offset_to_domains_end, '#');
+	file.write(padding.data(), padding.size());
+
+	uint16_t num_of_entities = uint16_t(_entities.size());
+	file.write(reinterpret_cast<const char*>(&num_of_entities), sizeof(num_of_entities));
+
+	for (const _Entity& entity : _entities)
+	{
+		uint8_t len = uint8_t(entity.name.size());
+		file.write(reinterpret_cast<const char*>(&entity.domain), sizeof(entity.domain));
+		file.write(reinterpret_cast<const char*>(&len), sizeof(len));
+		file.write(entity.name.data(), len);
+	}
+
+	bool success = file.good();
+	file.close();
+
+	if (!success)
+	{
+		Logger::log_error("Failed to write file: {}", StringConverter::to_utf8(_file_path));
+	}
+
+	return success;
+}
\ No newline at end of file
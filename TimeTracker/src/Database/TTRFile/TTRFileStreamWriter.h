@@ -0,0 +1,54 @@
+#pragma once
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+#include "TTRFileWriter.h"
+
+#include "../../Utils/Logger.h"
+#include "../../Utils/StringConverter.h"
+
+/*
+* Builds a complete TTR registry in memory and writes it in one pass
+* (see TTRFileWriter.h for the layout). IDs are assigned in insertion order,
+* so the caller can use the returned IDs for events before the file exists.
+*/
+
+class TTRFileStreamWriter
+{
+public:
+	using domain_id = TTRFileWriter::domain_id;
+	using entity_id = TTRFileWriter::entity_id;
+
+	static constexpr size_t max_domains = 0xFF;
+	static constexpr size_t max_entities = 0x7FFF;
+
+public:
+	TTRFileStreamWriter(const std::wstring& file_path);
+
+	bool add_domain(std::string_view domain, domain_id& id);
+	bool add_entity(domain_id domain, std::string_view entity, entity_id& id);
+
+	size_t num_of_domains() const;
+	size_t num_of_entities() const;
+
+	bool write();
+
+private:
+	std::wstring _file_path;
+
+	std::vector<std::string> _domains;
+
+	struct _Entity
+	{
+		domain_id domain;
+		std::string name;
+	};
+
+	std::vector<_Entity> _entities;
+};
\ No newline at end of file
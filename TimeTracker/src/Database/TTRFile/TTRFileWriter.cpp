@@ -1,5 +1,11 @@
 #include "TTRFileWriter.h"
 
+Metrics::Histogram& TTRFileWriter::_add_latency = Metrics::histogram("timetracker_ttr_writer_add_seconds", "Latency of adding a domain or entity to the registry file", 1e-9);
+Metrics::Histogram& TTRFileWriter::_lookup_latency = Metrics::histogram("timetracker_ttr_writer_lookup_seconds", "Latency of looking up a domain or entity id in the registry file", 1e-9);
+
+Metrics::Counter& TTRFileWriter::_added_domains = Metrics::counter("timetracker_ttr_writer_entries_total", "Entries added to the registry file", "type=\"domain\"");
+Metrics::Counter& TTRFileWriter::_added_entities = Metrics::counter("timetracker_ttr_writer_entries_total", "Entries added to the registry file", "type=\"entity\"");
+
 TTRFileWriter::TTRFileWriter(const std::wstring& file_path)
 	: _file_path(file_path), _file()
 {
@@ -15,6 +21,10 @@ TTRFileWriter::~TTRFileWriter()
 
 bool TTRFileWriter::add_domain(const std::string& domain)
 {
+	TRACE_SPAN("TTRFileWriter::add_domain");
+
+	Metrics::Timer timer(_add_latency);
+
 	if (!_file.is_open() && !_open())
 	{
 		return false;
@@ -59,11 +69,17 @@ bool TTRFileWriter::add_domain(const std::string& domain)
 
 	_close();
 
+	_added_domains.increment();
+
 	return true;
 }
 
 TTRFileWriter::domain_id TTRFileWriter::get_domain_id(const std::string& domain)
 {
+	TRACE_SPAN("TTRFileWriter::get_domain_id");
+
+	Metrics::Timer timer(_lookup_latency);
+
 	if (!_file.is_open() && !_open())
 	{
 		return false;
@@ -104,6 +120,10 @@ bool TTRFileWriter::domain_exists(const std::string& domain)
 
 bool TTRFileWriter::add_entity(domain_id id, const std::string& entity)
 {
+	TRACE_SPAN("TTRFileWriter::add_entity");
+
+	Metrics::Timer timer(_add_latency);
+
 	if (!_file.is_open() && !_open())
 	{
 		return false;
@@ -139,11 +159,17 @@ bool TTRFileWriter::add_entity(domain_id id, const std::string& entity)
 
 	_file.write(entity.c_str(), len);
 
+	_added_entities.increment();
+
 	return true;
 }
 
 TTRFileWriter::entity_id TTRFileWriter::get_entity_id(domain_id id, const std::string& entity)
 {
+	TRACE_SPAN("TTRFileWriter::get_entity_id");
+
+	Metrics::Timer timer(_lookup_latency);
+
 	if (!_file.is_open() && !_open())
 	{
 		return false;
@@ -186,6 +212,8 @@ bool TTRFileWriter::entity_exists(domain_id id, const std::string& entity)
 
 bool TTRFileWriter::_open()
 {
+	TRACE_SPAN("TTRFileWriter::_open");
+
 	if (!std::filesystem::exists(_file_path))
 	{
 		if (!_create())
@@ -194,7 +222,7 @@ bool TTRFileWriter::_open()
 		}
 	}
 
-	_file.open(_file_path, std::ios::in | std::ios::out | std::ios::binary);
+	_file.open(std::filesystem::path(_file_path), std::ios::in | std::ios::out | std::ios::binary);
 
 	if (!_file.is_open())
 	{
@@ -207,6 +235,8 @@ bool TTRFileWriter::_open()
 
 bool TTRFileWriter::_close()
 {
+	TRACE_SPAN("TTRFileWriter::_close");
+
 	_file.close();
 
 	if (_file.is_open())
@@ -225,14 +255,11 @@ bool TTRFileWriter::_create()
 		std::filesystem::create_directories(std::filesystem::path(_file_path).parent_path());
 	}
 
-	_file.open(_file_path, std::ios::out | std::ios::binary);
+	_file.open(std::filesystem::path(_file_path), std::ios::out | std::ios::binary);
 
 	if (!_file.is_open())
 	{
-		char error_buffer[256];
-		strerror_s(error_buffer, 256, errno);
-
-		Logger::log_error("Failed to create file: {}", error_buffer);
+		Logger::log_error("Failed to create file: {}", Platform::error_message(errno));
 		return false;
 	}
 
@@ -264,6 +291,8 @@ bool TTRFileWriter::_create()
 
 bool TTRFileWriter::_read_info()
 {
+	TRACE_SPAN("TTRFileWriter::_read_info");
+
 	_file.seekg(0);
 
 	char header[4];
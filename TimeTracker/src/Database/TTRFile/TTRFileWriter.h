@@ -9,6 +9,9 @@
 #include <cstddef>
 
 #include "../../Utils/Logger.h"
+#include "../../Utils/Metrics.h"
+#include "../../Utils/Platform.h"
+#include "../../Utils/Trace.h"
 
 /*
 * Time Tracker Registry File
@@ -54,6 +57,13 @@ private:
 	std::wstring _file_path;
 	std::fstream _file;
 
+private:
+	static Metrics::Histogram& _add_latency;
+	static Metrics::Histogram& _lookup_latency;
+
+	static Metrics::Counter& _added_domains;
+	static Metrics::Counter& _added_entities;
+
 private:
 	bool _open();
 	bool _close();
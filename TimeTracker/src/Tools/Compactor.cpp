@@ -0,0 +1,378 @@
+#include "Compactor.h"
+
+Compactor::Compactor(const Options& options)
+	: _options(options)
+{
+}
+
+bool Compactor::compact(const std::wstring& ttr_file_path, const std::wstring& tte_file_path,
+	const std::wstring& output_ttr_file_path, const std::wstring& output_tte_file_path, Statistics& statistics)
+{
+	statistics = Statistics();
+
+	TTRFileMappedReader registry(ttr_file_path);
+
+	if (!registry.reload())
+	{
+		Logger::append_info("Failed to compact registry");
+		return false;
+	}
+
+	statistics.input_bytes = _file_size(ttr_file_path) + _file_size(tte_file_path);
+	statistics.input_domains = registry.count_domains();
+	statistics.input_entities = registry.count_entities();
+
+	if (_options.measure_scans)
+	{
+		statistics.input_scan_seconds = _measure_scan(tte_file_path);
+	}
+
+	// First pass, count the surviving events of every entity
+	std::vector<uint64_t> counts(registry.count_entities(), 0);
+
+	bool success = _scan(tte_file_path, counts.size(),
+		[&counts](TTEFileDate::encoded_date, TTEFileEvent::encoded_event event)
+		{
+			counts[TTEFileEvent::decode(event).entity]++;
+			return true;
+		},
+		&statistics
+	);
+
+	if (!success)
+	{
+		Logger::append_info("Failed to compact events");
+		return false;
+	}
+
+	std::wstring temp_ttr_file_path = _temp_path(output_ttr_file_path);
+	std::wstring temp_tte_file_path = _temp_path(output_tte_file_path);
+
+	std::vector<TTEFileEvent::entity_id> remap;
+
+	if (!_build_registry(registry, counts, temp_ttr_file_path, remap, statistics))
+	{
+		Logger::append_info("Failed to compact registry");
+		return false;
+	}
+
+	// Second pass, write the events with their new IDs
+	TTEFileStreamWriter writer(temp_tte_file_path);
+
+	if (!writer.open())
+	{
+		std::filesystem::remove(temp_ttr_file_path);
+		return false;
+	}
+
+	success = _scan(tte_file_path, counts.size(),
+		[&writer, &remap](TTEFileDate::encoded_date date, TTEFileEvent::encoded_event encoded)
+		{
+			TTEFileEvent event = TTEFileEvent::decode(encoded);
+			event.entity = remap[event.entity];
+
+			return writer.add_event(TTEFileDate::decode(date), event);
+		},
+		nullptr
+	);
+
+	success = writer.close() && success;
+
+	statistics.output_dates = writer.num_of_dates();
+	statistics.output_events = writer.num_of_events();
+
+	if (!success)
+	{
+		Logger::append_info("Failed to write compacted events");
+		std::filesystem::remove(temp_ttr_file_path);
+		std::filesystem::remove(temp_tte_file_path);
+		return false;
+	}
+
+	// The new IDs only match the new events, so the pair is replaced together or not at all
+	if (!_replace_pair(temp_ttr_file_path, output_ttr_file_path, temp_tte_file_path, output_tte_file_path))
+	{
+		Logger::append_info("Failed to replace the output files");
+		return false;
+	}
+
+	statistics.output_bytes = _file_size(output_ttr_file_path) + _file_size(output_tte_file_path);
+
+	if (_options.measure_scans)
+	{
+		statistics.output_scan_seconds = _measure_scan(output_tte_file_path);
+	}
+
+	return true;
+}
+
+bool Compactor::_scan(const std::wstring& tte_file_path, size_t num_of_entities, _EventHandler handler, Statistics* statistics)
+{
+	TTEFileScanner scanner(tte_file_path);
+
+	if (!scanner.open())
+	{
+		return false;
+	}
+
+	if (statistics != nullptr)
+	{
+		statistics->input_dates = scanner.num_of_dates();
+	}
+
+	std::vector<TTEFileEvent::encoded_event> events(_chunk_size);
+
+	TTEFileDate::encoded_date date = 0;
+	uint32_t num_of_events = 0;
+
+	TTEFileEvent::entity_id last_entity = _no_entity;
+
+	while (scanner.next_block(date, num_of_events))
+	{
+		bool valid_date = _is_valid(date);
+
+		size_t events_read = 0;
+		while ((events_read = scanner.read_events(events.data(), events.size())) > 0)
+		{
+			for (size_t i = 0; i < events_read; i++)
+			{
+				if (statistics != nullptr)
+				{
+					statistics->input_events++;
+				}
+
+				if (!valid_date || !_is_valid(events[i], num_of_entities))
+				{
+					if (statistics != nullptr)
+					{
+						statistics->invalid_events++;
+					}
+
+					continue;
+				}
+
+				TTEFileEvent::entity_id entity = TTEFileEvent::decode(events[i]).entity;
+
+				if (_options.drop_duplicates && entity == last_entity)
+				{
+					if (statistics != nullptr)
+					{
+						statistics->duplicate_events++;
+					}
+
+					continue;
+				}
+
+				last_entity = entity;
+
+				if (!handler(date, events[i]))
+				{
+					scanner.close();
+					return false;
+				}
+			}
+		}
+	}
+
+	scanner.close();
+
+	return true;
+}
+
+bool Compactor::_build_registry(TTRFileMappedReader& registry, const std::vector<uint64_t>& counts,
+	const std::wstring& ttr_file_path, std::vector<TTEFileEvent::entity_id>& remap, Statistics& statistics)
+{
+	std::vector<TTEFileEvent::entity_id> order;
+
+	for (size_t i = 0; i < counts.size(); i++)
+	{
+		if (counts[i] > 0)
+		{
+			order.push_back(TTEFileEvent::entity_id(i));
+		}
+	}
+
+	if (_options.remap_by_frequency)
+	{
+		std::stable_sort(order.begin(), order.end(), [&counts](TTEFileEvent::entity_id a, TTEFileEvent::entity_id b) {
+			return counts[a] > counts[b];
+		});
+	}
+
+	// Domains are numbered in the order their first entity appears, so they follow the same ranking
+	std::vector<TTRFileStreamWriter::domain_id> domain_remap(registry.count_domains(), TTRFileStreamWriter::domain_id(-1));
+
+	TTRFileStreamWriter writer(ttr_file_path);
+
+	for (TTEFileEvent::entity_id entity : order)
+	{
+		TTRFileMappedReader::domain_id domain = registry.get_entity_domain(entity);
+
+		if (domain >= domain_remap.size())
+		{
+			Logger::log_error("Entity {} refers to unknown domain {}", entity, domain);
+			return false;
+		}
+
+		if (domain_remap[domain] == TTRFileStreamWriter::domain_id(-1) && !writer.add_domain(registry.get_domain_name(domain), domain_remap[domain]))
+		{
+			return false;
+		}
+	}
+
+	remap.assign(counts.size(), _no_entity);
+
+	for (TTEFileEvent::entity_id entity : order)
+	{
+		TTRFileStreamWriter::entity_id id = 0;
+
+		if (!writer.add_entity(domain_remap[registry.get_entity_domain(entity)], registry.get_entity(entity), id))
+		{
+			return false;
+		}
+
+		remap[entity] = id;
+	}
+
+	statistics.output_domains = writer.num_of_domains();
+	statistics.output_entities = writer.num_of_entities();
+
+	return writer.write();
+}
+
+bool Compactor::_is_valid(TTEFileDate::encoded_date date)
+{
+	uint8_t month = uint8_t((date >> 5) & 0x0F);
+	uint8_t day = uint8_t(date & 0x1F);
+
+	return month >= 1 && month <= 12 && day >= 1;
+}
+
+bool Compactor::_is_valid(TTEFileEvent::encoded_event event, size_t num_of_entities)
+{
+	// Failed encodes leave the event zeroed
+	if (event == 0)
+	{
+		return false;
+	}
+
+	// Checked on the raw fields, decoding an invalid event logs an error
+	uint32_t entity = event >> 17;
+	uint32_t hour = (event >> 12) & 0x1F;
+	uint32_t minute = (event >> 6) & 0x3F;
+	uint32_t second = event & 0x3F;
+
+	return entity < num_of_entities && hour <= 23 && minute <= 59 && second <= 59;
+}
+
+double Compactor::_measure_scan(const std::wstring& tte_file_path)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	TTEFileReader reader(tte_file_path);
+
+	uint64_t checksum = 0;
+	for (const TTEFileReader::Event& event : reader.events())
+	{
+		checksum += event.entity;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	Logger::log_info("Scanned {} (checksum {})", StringConverter::to_utf8(tte_file_path), checksum);
+
+	return seconds;
+}
+
+uint64_t Compactor::_file_size(const std::wstring& file_path)
+{
+	std::error_code error;
+	uintmax_t size = std::filesystem::file_size(file_path, error);
+
+	return error ? 0 : uint64_t(size);
+}
+
+std::wstring Compactor::_temp_path(const std::wstring& file_path)
+{
+	return file_path + L".compact";
+}
+
+std::wstring Compactor::_backup_path(const std::wstring& file_path)
+{
+	return file_path + L".backup";
+}
+
+bool Compactor::_replace(const std::wstring& temp_path, const std::wstring& file_path)
+{
+	std::error_code error;
+	std::filesystem::rename(temp_path, file_path, error);
+
+	if (error)
+	{
+		Logger::log_error("Failed to replace {}: {}", StringConverter::to_utf8(file_path), error.message());
+		return false;
+	}
+
+	return true;
+}
+
+bool Compactor::_replace_pair(const std::wstring& temp_ttr_file_path, const std::wstring& ttr_file_path,
+	const std::wstring& temp_tte_file_path, const std::wstring& tte_file_path)
+{
+	const std::wstring temp_paths[2] = { temp_ttr_file_path, temp_tte_file_path };
+	const std::wstring file_paths[2] = { ttr_file_path, tte_file_path };
+
+	std::error_code error;
+
+	bool success = true;
+	bool backed_up[2] = { false, false };
+	bool replaced[2] = { false, false };
+
+	// The old pair is moved aside first, so either pair can be restored whole
+	for (size_t i = 0; i < 2 && success; i++)
+	{
+		if (std::filesystem::exists(file_paths[i], error))
+		{
+			success = _replace(file_paths[i], _backup_path(file_paths[i]));
+			backed_up[i] = success;
+		}
+	}
+
+	for (size_t i = 0; i < 2 && success; i++)
+	{
+		success = _replace(temp_paths[i], file_paths[i]);
+		replaced[i] = success;
+	}
+
+	if (success)
+	{
+		for (size_t i = 0; i < 2; i++)
+		{
+			if (backed_up[i])
+			{
+				std::filesystem::remove(_backup_path(file_paths[i]), error);
+			}
+		}
+
+		return true;
+	}
+
+	for (size_t i = 0; i < 2; i++)
+	{
+		if (backed_up[i])
+		{
+			if (!_replace(_backup_path(file_paths[i]), file_paths[i]))
+			{
+				Logger::append_info("The previous file is kept at {}", StringConverter::to_utf8(_backup_path(file_paths[i])));
+			}
+		}
+		else if (replaced[i])
+		{
+			std::filesystem::remove(file_paths[i], error);
+		}
+
+		std::filesystem::remove(temp_paths[i], error);
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+
+#include <stdint.h>
+
+#include "../Database/TTEFile/TTEFileDate.h"
+#include "../Database/TTEFile/TTEFileEvent.h"
+#include "../Database/TTEFile/TTEFileReader.h"
+#include "../Database/TTEFile/TTEFileScanner.h"
+#include "../Database/TTEFile/TTEFileStreamWriter.h"
+#include "../Database/TTRFile/TTRFileMappedReader.h"
+#include "../Database/TTRFile/TTRFileStreamWriter.h"
+
+#include "../Utils/Logger.h"
+#include "../Utils/StringConverter.h"
+
+/*
+* Rewrites a TTE/TTR pair offline:
+* 
+*   - Events that are zeroed, out of range or refer to unknown entities are
+*     dropped, as are consecutive events of the same entity.
+*   - Date blocks without events are dropped and adjacent blocks of the same
+*     date are merged.
+*   - Entities and domains no event refers to are dropped from the registry.
+*     The rest are renumbered by event count, so the most frequent entities
+*     get the smallest IDs.
+* 
+* The input is streamed twice, once to count and once to write, so memory
+* only depends on the size of the registry. Both outputs are written next to
+* their destination and renamed over it, so the output paths may be the
+* input paths. The previous pair is kept as .backup files until both renames
+* succeeded, and restored if either fails, so a registry is never left next
+* to events of the other pair.
+*/
+
+class Compactor
+{
+public:
+	struct Options
+	{
+		bool drop_duplicates = true;
+		bool remap_by_frequency = true;
+
+		// Time a full scan of the input and the output
+		bool measure_scans = true;
+	};
+
+	struct Statistics
+	{
+		uint64_t input_bytes = 0;
+		uint64_t output_bytes = 0;
+
+		uint64_t input_events = 0;
+		uint64_t output_events = 0;
+		uint64_t invalid_events = 0;
+		uint64_t duplicate_events = 0;
+
+		uint16_t input_dates = 0;
+		uint16_t output_dates = 0;
+
+		size_t input_domains = 0;
+		size_t output_domains = 0;
+		size_t input_entities = 0;
+		size_t output_entities = 0;
+
+		// Seconds for a full TTEFileReader scan, 0 if not measured
+		double input_scan_seconds = 0.0;
+		double output_scan_seconds = 0.0;
+	};
+
+public:
+	Compactor(const Options& options);
+
+	bool compact(const std::wstring& ttr_file_path, const std::wstring& tte_file_path,
+		const std::wstring& output_ttr_file_path, const std::wstring& output_tte_file_path, Statistics& statistics);
+
+private:
+	Options _options;
+
+	static constexpr size_t _chunk_size = 4096;
+
+	static constexpr TTEFileEvent::entity_id _no_entity = 0xFFFF;
+
+private:
+	using _EventHandler = std::function<bool(TTEFileDate::encoded_date, TTEFileEvent::encoded_event)>;
+
+	// Streams the events that survive compaction, with their original entity IDs
+	bool _scan(const std::wstring& tte_file_path, size_t num_of_entities, _EventHandler handler, Statistics* statistics);
+
+	bool _build_registry(TTRFileMappedReader& registry, const std::vector<uint64_t>& counts,
+		const std::wstring& ttr_file_path, std::vector<TTEFileEvent::entity_id>& remap, Statistics& statistics);
+
+	static bool _is_valid(TTEFileDate::encoded_date date);
+	static bool _is_valid(TTEFileEvent::encoded_event event, size_t num_of_entities);
+
+	static double _measure_scan(const std::wstring& tte_file_path);
+	static uint64_t _file_size(const std::wstring& file_path);
+
+	static std::wstring _temp_path(const std::wstring& file_path);
+	static std::wstring _backup_path(const std::wstring& file_path);
+
+	static bool _replace(const std::wstring& temp_path, const std::wstring& file_path);
+	static bool _replace_pair(const std::wstring& temp_ttr_file_path, const std::wstring& ttr_file_path,
+		const std::wstring& temp_tte_file_path, const std::wstring& tte_file_path);
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "Exporter.h"
+
+Exporter::Exporter(const Options& options)
+	: _options(options)
+{
+}
+
+bool Exporter::export_arrow(const std::wstring& ttr_file_path, const std::wstring& tte_file_path, const std::wstring& output_file_path, Statistics& statistics)
+{
+	statistics = Statistics();
+
+	auto start = std::chrono::steady_clock::now();
+
+	TTRFileMappedReader registry(ttr_file_path);
+
+	if (!registry.reload())
+	{
+		Logger::append_info("Failed to export registry");
+		return false;
+	}
+
+	const std::vector<TTRFileMappedReader::Entity>& entities = registry.entities();
+
+	ArrowFileWriter::Column domain_column{ "domain", ArrowFileWriter::Type::DICTIONARY, {} };
+	ArrowFileWriter::Column entity_column{ "entity", ArrowFileWriter::Type::DICTIONARY, {} };
+
+	for (std::string_view domain : registry.domains())
+	{
+		domain_column.dictionary.emplace_back(domain);
+	}
+
+	for (const TTRFileMappedReader::Entity& entity : entities)
+	{
+		entity_column.dictionary.emplace_back(entity.name);
+	}
+
+	bool intervals = _options.mode == Mode::INTERVALS;
+
+	std::vector<ArrowFileWriter::Column> columns = { { "timestamp", ArrowFileWriter::Type::TIMESTAMP, {} } };
+	if (intervals)
+	{
+		columns.push_back({ "duration", ArrowFileWriter::Type::DURATION, {} });
+	}
+	columns.push_back(std::move(domain_column));
+	columns.push_back(std::move(entity_column));
+
+	size_t domain_index = intervals ? 2 : 1;
+	size_t entity_index = domain_index + 1;
+
+	ArrowFileWriter writer(output_file_path, columns, _options.batch_size);
+
+	if (!writer.open())
+	{
+		return false;
+	}
+
+	bool success = true;
+
+	IntervalBuilder builder;
+
+	for (size_t i = 0; i < registry.domains().size(); i++)
+	{
+		builder.add_domain(IntervalBuilder::domain_id(i), registry.domains()[i]);
+	}
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		builder.add_entity(IntervalBuilder::entity_id(i), entities[i].domain_id, entities[i].name);
+	}
+
+	IntervalBuilder::IntervalHandler add_interval = [&](const IntervalBuilder::Interval& interval)
+		{
+			writer.set(0, interval.start + _unix_epoch_offset);
+			writer.set(1, interval.end - interval.start);
+			writer.set(domain_index, interval.domain);
+			writer.set(entity_index, interval.entity);
+
+			success = writer.end_row() && success;
+		};
+
+	TTEFileScanner scanner(tte_file_path);
+
+	if (!scanner.open())
+	{
+		return false;
+	}
+
+	std::vector<TTEFileEvent::encoded_event> events(_chunk_size);
+
+	TTEFileDate::encoded_date encoded_date = 0;
+	uint32_t num_of_events = 0;
+
+	TimeConverter::timestamp last_time = 0;
+
+	while (success && scanner.next_block(encoded_date, num_of_events))
+	{
+		TTEFileDate date = TTEFileDate::decode(encoded_date);
+
+		size_t size = 0;
+		while (success && (size = scanner.read_events(events.data(), events.size())) > 0)
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				TTEFileEvent event = TTEFileEvent::decode(events[i]);
+				statistics.input_events++;
+
+				if (events[i] == 0 || event.entity >= entities.size())
+				{
+					statistics.skipped_events++;
+					continue;
+				}
+
+				last_time = TimeConverter::to_timestamp(2000 + date.year, date.month, date.day, event.hour, event.minute, event.second);
+
+				if (intervals)
+				{
+					builder.add_event(last_time, event.entity, add_interval);
+					continue;
+				}
+
+				writer.set(0, last_time + _unix_epoch_offset);
+				writer.set(domain_index, entities[event.entity].domain_id);
+				writer.set(entity_index, event.entity);
+
+				success = writer.end_row() && success;
+			}
+		}
+	}
+
+	if (intervals)
+	{
+		builder.close(last_time, add_interval);
+	}
+
+	success = writer.close() && success;
+
+	statistics.rows = writer.num_of_rows();
+	statistics.batches = writer.num_of_batches();
+	statistics.bytes = writer.num_of_bytes();
+	statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return success;
+}
\ No newline at end of file
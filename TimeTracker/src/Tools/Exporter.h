@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <stdint.h>
+
+#include "../Analysis/IntervalBuilder.h"
+
+#include "../Database/TTEFile/TTEFileDate.h"
+#include "../Database/TTEFile/TTEFileEvent.h"
+#include "../Database/TTEFile/TTEFileScanner.h"
+#include "../Database/TTRFile/TTRFileMappedReader.h"
+
+#include "../Utils/ArrowFileWriter.h"
+#include "../Utils/Logger.h"
+#include "../Utils/StringConverter.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* Exports a TTE/TTR pair to an Arrow IPC file, with one row per event or per
+* interval built by IntervalBuilder:
+* 
+*   - EVENTS      timestamp, domain, entity
+*   - INTERVALS   timestamp, duration, domain, entity
+* 
+* Timestamps are local time in seconds since 1970-01-01 without a time zone,
+* durations are in seconds. The domain and entity columns are dictionary
+* encoded, their dictionaries are the domain and entity tables of the
+* registry, so the column values are the IDs stored in the TTE file.
+* 
+* The events are streamed and written in batches, so memory only depends on
+* the batch size and the size of the registry.
+*/
+
+class Exporter
+{
+public:
+	enum class Mode
+	{
+		EVENTS,
+		INTERVALS
+	};
+
+	struct Options
+	{
+		Mode mode = Mode::EVENTS;
+
+		size_t batch_size = 65536;
+	};
+
+	struct Statistics
+	{
+		uint64_t input_events = 0;
+		uint64_t skipped_events = 0;
+
+		uint64_t rows = 0;
+		uint64_t batches = 0;
+		uint64_t bytes = 0;
+
+		double seconds = 0.0;
+	};
+
+public:
+	Exporter(const Options& options);
+
+	bool export_arrow(const std::wstring& ttr_file_path, const std::wstring& tte_file_path, const std::wstring& output_file_path, Statistics& statistics);
+
+private:
+	Options _options;
+
+	// TimeConverter counts from 2000-01-01, Arrow from 1970-01-01
+	static constexpr TimeConverter::timestamp _unix_epoch_offset = 946684800;
+
+	static constexpr size_t _chunk_size = 1024;
+};
\ No newline at end of file
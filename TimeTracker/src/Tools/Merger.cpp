@@ -0,0 +1,517 @@
+#include "Merger.h"
+
+Merger::Merger(const Options& options)
+	: _options(options)
+{
+}
+
+bool Merger::merge(const std::vector<Input>& inputs, const std::wstring& output_ttr_file_path, const std::wstring& output_tte_file_path, Statistics& statistics)
+{
+	statistics = Statistics();
+
+	// Written next to the outputs and renamed over them, so a failed merge leaves no partial pair
+	std::wstring temp_ttr_file_path = _temp_path(output_ttr_file_path);
+	std::wstring temp_tte_file_path = _temp_path(output_tte_file_path);
+
+	if (!merge_registries(inputs, temp_ttr_file_path))
+	{
+		Logger::append_info("Failed to merge registries");
+		std::filesystem::remove(temp_ttr_file_path);
+		return false;
+	}
+
+	TTEFileStreamWriter writer(temp_tte_file_path);
+
+	if (!writer.open())
+	{
+		std::filesystem::remove(temp_ttr_file_path);
+		return false;
+	}
+
+	bool check_totals = _options.check_totals;
+
+	std::vector<_Replay> input_replays(check_totals ? inputs.size() : 0, _Replay(*this));
+	_Replay output_replay(*this);
+
+	size_t last_input = inputs.size();
+
+	auto write_event = [&writer, &output_replay, check_totals](const TTEFileDate& date, const TTEFileEvent& event)
+		{
+			if (check_totals)
+			{
+				output_replay.add_event(date, event);
+			}
+
+			return writer.add_event(date, event);
+		};
+
+	bool success = merge_events(inputs,
+		[&](size_t input, const TTEFileDate& date, const TTEFileEvent& event)
+		{
+			// Switches the readers of the output to the intervals of this device
+			if (_options.tag_devices && input != last_input)
+			{
+				if (!write_event(date, TTEFileEvent(_device_entities[input], event.hour, event.minute, event.second)))
+				{
+					return false;
+				}
+
+				statistics.device_events++;
+			}
+
+			last_input = input;
+
+			if (check_totals)
+			{
+				input_replays[input].add_event(date, event);
+			}
+
+			return write_event(date, event);
+		},
+		statistics
+	);
+
+	success = writer.close() && success;
+
+	statistics.output_events = writer.num_of_events();
+	statistics.output_dates = writer.num_of_dates();
+	statistics.output_domains = _domains.size();
+	statistics.output_entities = _entities.size();
+
+	if (success && check_totals && !_check_totals(inputs, input_replays, output_replay))
+	{
+		Logger::append_info("Merged totals differ from the inputs");
+		success = false;
+	}
+
+	if (!success)
+	{
+		std::filesystem::remove(temp_ttr_file_path);
+		std::filesystem::remove(temp_tte_file_path);
+		return false;
+	}
+
+	// The merged IDs only match the merged events, so the pair is replaced together or not at all
+	if (!_replace_pair(temp_ttr_file_path, output_ttr_file_path, temp_tte_file_path, output_tte_file_path))
+	{
+		Logger::append_info("Failed to replace the output files");
+		return false;
+	}
+
+	return true;
+}
+
+bool Merger::merge_registries(const std::vector<Input>& inputs, const std::wstring& output_ttr_file_path)
+{
+	_remaps.assign(inputs.size(), Remap());
+	_domains.clear();
+	_entities.clear();
+	_device_entities.clear();
+	_device_domain = domain_id(-1);
+
+	TTRFileStreamWriter writer(output_ttr_file_path);
+
+	StringMap<domain_id> domain_ids;
+	std::vector<StringMap<entity_id>> entity_ids;
+
+	auto add_domain = [&](std::string_view name, domain_id& id)
+		{
+			auto it = domain_ids.find(name);
+			if (it != domain_ids.end())
+			{
+				id = it->second;
+				return true;
+			}
+
+			if (!writer.add_domain(name, id))
+			{
+				return false;
+			}
+
+			domain_ids.emplace(std::string(name), id);
+			entity_ids.emplace_back();
+			_domains.emplace_back(name);
+
+			return true;
+		};
+
+	auto add_entity = [&](domain_id domain, std::string_view name, entity_id& id)
+		{
+			auto it = entity_ids[domain].find(name);
+			if (it != entity_ids[domain].end())
+			{
+				id = it->second;
+				return true;
+			}
+
+			if (!writer.add_entity(domain, name, id))
+			{
+				return false;
+			}
+
+			entity_ids[domain].emplace(std::string(name), id);
+			_entities.emplace_back(domain, std::string(name));
+
+			return true;
+		};
+
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		TTRFileMappedReader registry(inputs[i].ttr_file_path);
+
+		if (!registry.reload())
+		{
+			Logger::log_error("Failed to read registry of {}", inputs[i].device);
+			return false;
+		}
+
+		Remap& remap = _remaps[i];
+
+		for (std::string_view domain : registry.domains())
+		{
+			domain_id id = 0;
+			if (!add_domain(domain, id))
+			{
+				return false;
+			}
+
+			remap.domains.push_back(id);
+		}
+
+		for (const TTRFileMappedReader::Entity& entity : registry.entities())
+		{
+			entity_id id = entity_id(-1);
+
+			if (entity.domain_id < remap.domains.size() && !add_entity(remap.domains[entity.domain_id], entity.name, id))
+			{
+				return false;
+			}
+
+			remap.entities.push_back(id);
+		}
+	}
+
+	if (_options.tag_devices)
+	{
+		domain_id device = 0;
+		if (!add_domain(device_domain, device))
+		{
+			return false;
+		}
+
+		_device_domain = device;
+
+		for (const Input& input : inputs)
+		{
+			entity_id id = 0;
+			if (!add_entity(device, input.device, id))
+			{
+				return false;
+			}
+
+			_device_entities.push_back(id);
+		}
+	}
+
+	return writer.write();
+}
+
+bool Merger::merge_events(const std::vector<Input>& inputs, EventHandler handler, Statistics& statistics)
+{
+	if (_remaps.size() != inputs.size())
+	{
+		Logger::log_error("Registries must be merged before the events");
+		return false;
+	}
+
+	statistics.input_events.assign(inputs.size(), 0);
+
+	std::vector<std::unique_ptr<_Cursor>> cursors;
+
+	for (const Input& input : inputs)
+	{
+		cursors.push_back(std::make_unique<_Cursor>(input.tte_file_path));
+	}
+
+	// Ordered by time, ties go to the earlier input so the merge is stable
+	using _HeapEntry = std::pair<uint64_t, size_t>;
+	std::priority_queue<_HeapEntry, std::vector<_HeapEntry>, std::greater<_HeapEntry>> heap;
+
+	for (size_t i = 0; i < cursors.size(); i++)
+	{
+		if (cursors[i]->advance())
+		{
+			heap.emplace(cursors[i]->key(), i);
+		}
+	}
+
+	while (!heap.empty())
+	{
+		size_t input = heap.top().second;
+		heap.pop();
+
+		_Cursor& cursor = *cursors[input];
+
+		TTEFileEvent event = TTEFileEvent::decode(cursor.events[cursor.next]);
+		statistics.input_events[input]++;
+
+		const std::vector<entity_id>& remap = _remaps[input].entities;
+
+		if (event.entity < remap.size() && remap[event.entity] != entity_id(-1))
+		{
+			event.entity = remap[event.entity];
+
+			if (!handler(input, TTEFileDate::decode(cursor.date), event))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			Logger::log_warning("Skipping event of unknown entity {} from {}", event.entity, inputs[input].device);
+		}
+
+		cursor.next++;
+
+		if (cursor.advance())
+		{
+			heap.emplace(cursor.key(), input);
+		}
+	}
+
+	return true;
+}
+
+const std::vector<Merger::Remap>& Merger::remaps() const
+{
+	return _remaps;
+}
+
+bool Merger::write_remaps(const std::vector<Input>& inputs, const std::wstring& file_path) const
+{
+	std::ofstream file(std::filesystem::path(file_path), std::ios::out | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		Logger::log_error("Unable to create file: {}", StringConverter::to_utf8(file_path));
+		return false;
+	}
+
+	file << "device,input_id,merged_id,domain,entity\n";
+
+	for (size_t i = 0; i < _remaps.size() && i < inputs.size(); i++)
+	{
+		for (size_t id = 0; id < _remaps[i].entities.size(); id++)
+		{
+			entity_id merged = _remaps[i].entities[id];
+
+			if (merged == entity_id(-1))
+			{
+				continue;
+			}
+
+			const auto& [domain, entity] = _entities[merged];
+
+			file << inputs[i].device << ',' << id << ',' << merged << ',' << _domains[domain] << ',' << entity << '\n';
+		}
+	}
+
+	return file.good();
+}
+
+Merger::_Replay::_Replay(const Merger& merger)
+	: durations(merger._domains.size(), 0)
+{
+	for (size_t i = 0; i < merger._domains.size(); i++)
+	{
+		intervals.add_domain(domain_id(i), merger._domains[i]);
+	}
+
+	for (size_t i = 0; i < merger._entities.size(); i++)
+	{
+		intervals.add_entity(entity_id(i), merger._entities[i].first, merger._entities[i].second);
+	}
+}
+
+void Merger::_Replay::add_event(const TTEFileDate& date, const TTEFileEvent& event)
+{
+	last_time = TimeConverter::to_timestamp(2000 + date.year, date.month, date.day, event.hour, event.minute, event.second);
+
+	intervals.add_event(last_time, event.entity, [this](const IntervalBuilder::Interval& interval) {
+		_add_interval(interval);
+	});
+}
+
+void Merger::_Replay::close()
+{
+	close(last_time);
+}
+
+void Merger::_Replay::close(TimeConverter::timestamp time)
+{
+	intervals.close(time, [this](const IntervalBuilder::Interval& interval) {
+		_add_interval(interval);
+	});
+}
+
+void Merger::_Replay::_add_interval(const IntervalBuilder::Interval& interval)
+{
+	durations[interval.domain] += interval.end - interval.start;
+}
+
+bool Merger::_check_totals(const std::vector<Input>& inputs, std::vector<_Replay>& input_replays, _Replay& output_replay) const
+{
+	std::vector<TimeConverter::timestamp> expected(_domains.size(), 0);
+
+	// The output has no end per device, the intervals left open by an input run to its end
+	for (_Replay& replay : input_replays)
+	{
+		replay.close(output_replay.last_time);
+
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			expected[i] += replay.durations[i];
+		}
+	}
+
+	output_replay.close();
+
+	bool success = true;
+
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		// Device time is only in the output
+		if (domain_id(i) == _device_domain || expected[i] == output_replay.durations[i])
+		{
+			continue;
+		}
+
+		Logger::log_error("Merged {} time of {} inputs is {}s instead of {}s", _domains[i], inputs.size(), output_replay.durations[i], expected[i]);
+		success = false;
+	}
+
+	return success;
+}
+
+std::wstring Merger::_temp_path(const std::wstring& file_path)
+{
+	return file_path + L".merge";
+}
+
+std::wstring Merger::_backup_path(const std::wstring& file_path)
+{
+	return file_path + L".backup";
+}
+
+bool Merger::_replace(const std::wstring& temp_path, const std::wstring& file_path)
+{
+	std::error_code error;
+	std::filesystem::rename(temp_path, file_path, error);
+
+	if (error)
+	{
+		Logger::log_error("Failed to replace {}: {}", StringConverter::to_utf8(file_path), error.message());
+		return false;
+	}
+
+	return true;
+}
+
+bool Merger::_replace_pair(const std::wstring& temp_ttr_file_path, const std::wstring& ttr_file_path,
+	const std::wstring& temp_tte_file_path, const std::wstring& tte_file_path)
+{
+	const std::wstring temp_paths[2] = { temp_ttr_file_path, temp_tte_file_path };
+	const std::wstring file_paths[2] = { ttr_file_path, tte_file_path };
+
+	std::error_code error;
+
+	bool success = true;
+	bool backed_up[2] = { false, false };
+	bool replaced[2] = { false, false };
+
+	// An earlier output is moved aside first, so it can be restored whole
+	for (size_t i = 0; i < 2 && success; i++)
+	{
+		if (std::filesystem::exists(file_paths[i], error))
+		{
+			success = _replace(file_paths[i], _backup_path(file_paths[i]));
+			backed_up[i] = success;
+		}
+	}
+
+	for (size_t i = 0; i < 2 && success; i++)
+	{
+		success = _replace(temp_paths[i], file_paths[i]);
+		replaced[i] = success;
+	}
+
+	if (success)
+	{
+		for (size_t i = 0; i < 2; i++)
+		{
+			if (backed_up[i])
+			{
+				std::filesystem::remove(_backup_path(file_paths[i]), error);
+			}
+		}
+
+		return true;
+	}
+
+	for (size_t i = 0; i < 2; i++)
+	{
+		if (backed_up[i])
+		{
+			if (!_replace(_backup_path(file_paths[i]), file_paths[i]))
+			{
+				Logger::append_info("The previous file is kept at {}", StringConverter::to_utf8(_backup_path(file_paths[i])));
+			}
+		}
+		else if (replaced[i])
+		{
+			std::filesystem::remove(file_paths[i], error);
+		}
+
+		std::filesystem::remove(temp_paths[i], error);
+	}
+
+	return false;
+}
+
+Merger::_Cursor::_Cursor(const std::wstring& file_path)
+	: scanner(file_path), events(_chunk_size)
+{
+	done = !scanner.open();
+}
+
+bool Merger::_Cursor::advance()
+{
+	while (!done && next >= size)
+	{
+		next = 0;
+		size = scanner.read_events(events.data(), events.size());
+
+		if (size > 0)
+		{
+			break;
+		}
+
+		uint32_t num_of_events = 0;
+		if (!scanner.next_block(date, num_of_events))
+		{
+			scanner.close();
+			done = true;
+		}
+	}
+
+	return !done;
+}
+
+uint64_t Merger::_Cursor::key() const
+{
+	TTEFileEvent event = TTEFileEvent::decode(events[next]);
+
+	uint64_t second = uint64_t(event.hour) * 3600 + uint64_t(event.minute) * 60 + event.second;
+
+	return (uint64_t(date) << 17) | second;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <functional>
+#include <fstream>
+#include <filesystem>
+
+#include <stdint.h>
+
+#include "../Database/TTEFile/TTEFileDate.h"
+#include "../Database/TTEFile/TTEFileEvent.h"
+#include "../Database/TTEFile/TTEFileScanner.h"
+#include "../Database/TTEFile/TTEFileStreamWriter.h"
+#include "../Database/TTRFile/TTRFileMappedReader.h"
+#include "../Database/TTRFile/TTRFileStreamWriter.h"
+
+#include "../Analysis/IntervalBuilder.h"
+
+#include "../Utils/Logger.h"
+#include "../Utils/StringConverter.h"
+#include "../Utils/StringHash.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* Merges the databases of several devices into one TTE/TTR pair.
+* 
+* The registries are joined on domain and entity names, which yields one remap
+* table per input from its IDs to the merged IDs. The events are then k-way
+* merged by time in a single streaming pass, reading every input through a
+* fixed size buffer, so memory depends on the number of inputs and the size of
+* the registries but not on the length of the history.
+* 
+* The devices may have been used at the same time, their events interleave in
+* the output. When tag_devices is set, the output gets a Device domain with one
+* entity per input, and an event of it is written whenever the next event comes
+* from another input. IntervalBuilder keeps the intervals of every device apart
+* by these events, so the events of one device never close the intervals of
+* another. Without them, the intervals of overlapping devices close each other.
+* 
+* With check_totals, the intervals of every input and of the output are built
+* during the merge, and the merge fails unless the time per domain of the
+* output, without the Device domain, is the sum of the inputs. The intervals an
+* input leaves open run to the end of the output in both.
+* 
+* The pair is written next to the outputs and renamed over them once the merge
+* succeeded, so a failed merge leaves the outputs untouched.
+*/
+
+class Merger
+{
+public:
+	using domain_id = TTRFileStreamWriter::domain_id;
+	using entity_id = TTRFileStreamWriter::entity_id;
+
+	struct Input
+	{
+		std::string device;
+
+		std::wstring ttr_file_path;
+		std::wstring tte_file_path;
+	};
+
+	struct Options
+	{
+		bool tag_devices = true;
+		bool check_totals = true;
+	};
+
+	struct Statistics
+	{
+		std::vector<uint64_t> input_events;
+
+		uint64_t output_events = 0;
+		uint64_t device_events = 0;
+		uint16_t output_dates = 0;
+
+		size_t output_domains = 0;
+		size_t output_entities = 0;
+	};
+
+	// Input IDs to merged IDs, -1 for entities of an unreadable domain
+	struct Remap
+	{
+		std::vector<domain_id> domains;
+		std::vector<entity_id> entities;
+	};
+
+	using EventHandler = std::function<bool(size_t input, const TTEFileDate& date, const TTEFileEvent& event)>;
+
+	static constexpr std::string_view device_domain = "Device";
+
+public:
+	Merger(const Options& options);
+
+	bool merge(const std::vector<Input>& inputs, const std::wstring& output_ttr_file_path, const std::wstring& output_tte_file_path, Statistics& statistics);
+
+	// Joins the registries and writes the merged one
+	bool merge_registries(const std::vector<Input>& inputs, const std::wstring& output_ttr_file_path);
+
+	// Streams the events of all inputs in time order, with the merged entity IDs
+	bool merge_events(const std::vector<Input>& inputs, EventHandler handler, Statistics& statistics);
+
+	const std::vector<Remap>& remaps() const;
+
+	bool write_remaps(const std::vector<Input>& inputs, const std::wstring& file_path) const;
+
+private:
+	Options _options;
+
+	std::vector<Remap> _remaps;
+
+	// Names of the merged registry, to write the remap table
+	std::vector<std::string> _domains;
+	std::vector<std::pair<domain_id, std::string>> _entities;
+
+	// Device entity of every input, only with tag_devices
+	std::vector<entity_id> _device_entities;
+	domain_id _device_domain = domain_id(-1);
+
+private:
+	static constexpr size_t _chunk_size = 1024;
+
+	struct _Cursor
+	{
+		TTEFileScanner scanner;
+
+		TTEFileDate::encoded_date date = 0;
+
+		std::vector<TTEFileEvent::encoded_event> events;
+		size_t next = 0;
+		size_t size = 0;
+
+		bool done = false;
+
+		_Cursor(const std::wstring& file_path);
+
+		// Moves to the next event, loading the next chunk or block when needed
+		bool advance();
+
+		uint64_t key() const;
+	};
+
+	// Time per merged domain of one event stream
+	struct _Replay
+	{
+		IntervalBuilder intervals;
+		std::vector<TimeConverter::timestamp> durations;
+
+		TimeConverter::timestamp last_time = 0;
+
+		_Replay(const Merger& merger);
+
+		void add_event(const TTEFileDate& date, const TTEFileEvent& event);
+		void close();
+		void close(TimeConverter::timestamp time);
+
+	private:
+		void _add_interval(const IntervalBuilder::Interval& interval);
+	};
+
+	bool _check_totals(const std::vector<Input>& inputs, std::vector<_Replay>& input_replays, _Replay& output_replay) const;
+
+	static std::wstring _temp_path(const std::wstring& file_path);
+	static std::wstring _backup_path(const std::wstring& file_path);
+
+	static bool _replace(const std::wstring& temp_path, const std::wstring& file_path);
+	static bool _replace_pair(const std::wstring& temp_ttr_file_path, const std::wstring& ttr_file_path,
+		const std::wstring& temp_tte_file_path, const std::wstring& tte_file_path);
+};
\ No newline at end of file
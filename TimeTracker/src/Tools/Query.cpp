@@ -0,0 +1,937 @@
+#include "Query.h"
+
+Query::Query(const Options& options)
+	: _options(options)
+{
+	for (Group group : _options.group_by)
+	{
+		_group_domain |= group == Group::DOMAIN;
+		_group_entity |= group == Group::ENTITY;
+		_group_hour |= group == Group::HOUR;
+		_group_weekday |= group == Group::WEEKDAY;
+		_group_day |= group == Group::DAY;
+	}
+
+	if (!Histogram::valid_bucket_size(_options.bucket_size))
+	{
+		Logger::log_warning("Invalid bucket size {}, using hours", _options.bucket_size);
+		_options.bucket_size = 3600;
+	}
+
+	// Sketches only rank entities, time buckets would multiply the summaries
+	_use_sketches = _options.sketch_capacity > 0 && _group_entity && !_group_hour && !_group_weekday && !_group_day;
+
+	if (_options.sketch_capacity > 0 && !_use_sketches)
+	{
+		Logger::log_warning("Sketches need a grouping by entity without hour, weekday or day, aggregating exactly");
+	}
+
+	// Days are not a cycle, with them the groups stay in the hash map
+	_use_histogram = !_use_sketches && (_group_hour || _group_weekday) && !_group_day;
+}
+
+bool Query::run(const std::wstring& ttr_file_path, const std::wstring& tte_file_path, std::vector<Row>& rows, Statistics& statistics)
+{
+	statistics = Statistics();
+
+	if (!_load_registry(ttr_file_path))
+	{
+		Logger::append_info("Failed to query registry");
+		return false;
+	}
+
+	if (!_seed({ tte_file_path }, statistics) || !_scan(tte_file_path, statistics))
+	{
+		Logger::append_info("Failed to query events");
+		return false;
+	}
+
+	_finish(rows, statistics);
+
+	return true;
+}
+
+bool Query::run_segments(const std::wstring& ttr_file_path, const std::wstring& manifest_file_path, std::vector<Row>& rows, Statistics& statistics)
+{
+	statistics = Statistics();
+
+	if (!_load_registry(ttr_file_path))
+	{
+		Logger::append_info("Failed to query registry");
+		return false;
+	}
+
+	auto to_date = [](timestamp time)
+		{
+			int year, month, day;
+			TimeConverter::to_date(TimeConverter::to_day(time), year, month, day);
+
+			year = (std::clamp)(year, 2000, 2127);
+
+			return TTESegmentReader::Date(uint8_t(year - 2000), uint8_t(month), uint8_t(day));
+		};
+
+	// Both dates are inclusive for the segment reader
+	TTESegmentReader::Date from = _options.from <= 0 ? TTESegmentReader::Date(0, 1, 1) : to_date(_options.from);
+	TTESegmentReader::Date to = _options.to == (std::numeric_limits<timestamp>::max)() ? TTESegmentReader::Date(127, 12, 31) : to_date(_options.to - 1);
+
+	TTESegmentReader reader(manifest_file_path);
+
+	// An interval reaching into the range may have started in any earlier segment
+	if (!_seed(reader.segment_paths(TTESegmentReader::Date(0, 1, 1), from), statistics))
+	{
+		Logger::append_info("Failed to query segments before the range");
+		return false;
+	}
+
+	for (const std::wstring& path : reader.segment_paths(from, to))
+	{
+		if (_done)
+		{
+			break;
+		}
+
+		if (!_scan(path, statistics))
+		{
+			Logger::append_info("Failed to query segment: {}", StringConverter::to_utf8(path));
+			return false;
+		}
+	}
+
+	// Segments after the last day of the range also close the intervals still open at its end
+	if (!_done && _options.to != (std::numeric_limits<timestamp>::max)())
+	{
+		timestamp next_day = TimeConverter::from_day(TimeConverter::to_day(_options.to - 1) + 1);
+		_done = !reader.segment_paths(to_date(next_day), TTESegmentReader::Date(127, 12, 31)).empty();
+	}
+
+	_finish(rows, statistics);
+
+	return true;
+}
+
+void Query::write(const std::vector<Row>& rows, Output output, std::ostream& stream) const
+{
+	std::vector<std::string> header;
+	for (Group group : _options.group_by)
+	{
+		header.push_back(group == Group::DOMAIN ? "domain" : group == Group::ENTITY ? "entity" : group == Group::HOUR ? "hour" : group == Group::WEEKDAY ? "weekday" : "day");
+	}
+
+	std::vector<std::vector<std::string>> cells;
+	for (const Row& row : rows)
+	{
+		std::vector<std::string>& line = cells.emplace_back();
+
+		for (Group group : _options.group_by)
+		{
+			line.push_back(_key_name(group, row));
+		}
+	}
+
+	if (output == Output::JSON)
+	{
+		stream << "[";
+
+		for (size_t i = 0; i < rows.size(); i++)
+		{
+			stream << (i == 0 ? "{" : ",{");
+
+			for (size_t j = 0; j < header.size(); j++)
+			{
+				stream << "\"" << header[j] << "\":" << (_options.group_by[j] == Group::HOUR && _options.bucket_size == 3600 ? std::to_string(rows[i].hour) : StringConverter::to_json(cells[i][j])) << ",";
+			}
+
+			stream << "\"events\":" << rows[i].events << ",\"seconds\":" << rows[i].duration;
+
+			if (_use_sketches)
+			{
+				stream << ",\"error\":" << rows[i].error;
+			}
+
+			stream << "}";
+		}
+
+		stream << "]" << std::endl;
+		return;
+	}
+
+	if (output == Output::CSV)
+	{
+		auto escape = [](const std::string& value)
+			{
+				if (value.find_first_of(",\"\r\n") == std::string::npos)
+				{
+					return value;
+				}
+
+				std::string escaped = "\"";
+				for (char c : value)
+				{
+					escaped += c == '"' ? "\"\"" : std::string(1, c);
+				}
+
+				return escaped + "\"";
+			};
+
+		for (const std::string& name : header)
+		{
+			stream << name << ",";
+		}
+		stream << (_use_sketches ? "events,seconds,error\n" : "events,seconds\n");
+
+		for (size_t i = 0; i < rows.size(); i++)
+		{
+			for (const std::string& value : cells[i])
+			{
+				stream << escape(value) << ",";
+			}
+			stream << rows[i].events << "," << rows[i].duration;
+
+			if (_use_sketches)
+			{
+				stream << "," << rows[i].error;
+			}
+
+			stream << "\n";
+		}
+
+		stream.flush();
+		return;
+	}
+
+	header.push_back("events");
+	header.push_back("duration");
+
+	if (_use_sketches)
+	{
+		header.push_back("error");
+	}
+
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		cells[i].push_back(std::to_string(rows[i].events));
+		cells[i].push_back(_duration_string(rows[i].duration));
+
+		if (_use_sketches)
+		{
+			cells[i].push_back(_options.sort == Sort::EVENTS ? std::to_string(rows[i].error) : _duration_string(rows[i].error));
+		}
+	}
+
+	size_t first_numeric = header.size() - (_use_sketches ? 3 : 2);
+
+	std::vector<size_t> widths(header.size(), 0);
+	for (size_t j = 0; j < header.size(); j++)
+	{
+		widths[j] = header[j].size();
+
+		for (const std::vector<std::string>& line : cells)
+		{
+			widths[j] = (std::max)(widths[j], line[j].size());
+		}
+	}
+
+	auto write_line = [&stream, &widths, first_numeric](const std::vector<std::string>& line)
+		{
+			for (size_t j = 0; j < line.size(); j++)
+			{
+				// Counts and durations are right aligned
+				bool numeric = j >= first_numeric;
+
+				std::string padding(widths[j] - line[j].size(), ' ');
+				stream << (j == 0 ? "" : "  ") << (numeric ? padding + line[j] : line[j] + (j + 1 == line.size() ? "" : padding));
+			}
+
+			stream << "\n";
+		};
+
+	write_line(header);
+
+	for (const std::vector<std::string>& line : cells)
+	{
+		write_line(line);
+	}
+
+	stream.flush();
+}
+
+bool Query::parse_group(std::string_view name, Group& group)
+{
+	if (name == "domain")
+		group = Group::DOMAIN;
+	else if (name == "entity")
+		group = Group::ENTITY;
+	else if (name == "hour")
+		group = Group::HOUR;
+	else if (name == "weekday")
+		group = Group::WEEKDAY;
+	else if (name == "day")
+		group = Group::DAY;
+	else
+		return false;
+
+	return true;
+}
+
+bool Query::_load_registry(const std::wstring& ttr_file_path)
+{
+	TTRFileMappedReader registry(ttr_file_path);
+
+	if (!registry.reload())
+	{
+		return false;
+	}
+
+	_domain_names.clear();
+	_entity_names.clear();
+	_entity_domains.clear();
+	_groups.clear();
+	_sketches.clear();
+
+	_histogram_builder.reset();
+	_histogram.reset();
+
+	_builder = IntervalBuilder();
+	_last_time = 0;
+	_done = false;
+
+	for (std::string_view domain : registry.domains())
+	{
+		_builder.add_domain(domain_id(_domain_names.size()), domain);
+		_domain_names.emplace_back(domain);
+
+		if (_use_sketches)
+		{
+			_sketches.emplace_back(_options.sketch_capacity);
+		}
+	}
+
+	for (const TTRFileMappedReader::Entity& entity : registry.entities())
+	{
+		_builder.add_entity(entity_id(_entity_names.size()), entity.domain_id, entity.name);
+		_entity_names.emplace_back(entity.name);
+		_entity_domains.push_back(entity.domain_id);
+	}
+
+	if (_use_histogram)
+	{
+		Histogram::Cycle cycle = _group_weekday ? Histogram::Cycle::WEEK : Histogram::Cycle::DAY;
+		timestamp bucket_size = _group_hour ? _options.bucket_size : TimeConverter::seconds_per_day;
+
+		_histogram = std::make_unique<Histogram>(_entity_names.size(), cycle, bucket_size);
+		_histogram_builder = std::make_unique<HistogramBuilder>(*_histogram, _options.threads);
+	}
+
+	_selected_domains.clear();
+	if (!_options.domains.empty())
+	{
+		_selected_domains.assign(_domain_names.size(), false);
+
+		for (const std::string& name : _options.domains)
+		{
+			auto it = std::find(_domain_names.begin(), _domain_names.end(), name);
+
+			if (it == _domain_names.end())
+			{
+				Logger::log_warning("Unknown domain: {}", name);
+				continue;
+			}
+
+			_selected_domains[it - _domain_names.begin()] = true;
+		}
+	}
+
+	// Entity names are only unique within their domain, a name selects all of them
+	_selected_entities.clear();
+	if (!_options.entities.empty())
+	{
+		_selected_entities.assign(_entity_names.size(), false);
+
+		StringMap<bool> names;
+		for (const std::string& name : _options.entities)
+		{
+			names.emplace(name, false);
+		}
+
+		for (size_t i = 0; i < _entity_names.size(); i++)
+		{
+			auto it = names.find(_entity_names[i]);
+
+			if (it != names.end())
+			{
+				_selected_entities[i] = true;
+				it->second = true;
+			}
+		}
+
+		for (const auto& [name, found] : names)
+		{
+			if (!found)
+			{
+				Logger::log_warning("Unknown entity: {}", name);
+			}
+		}
+	}
+
+	return true;
+}
+
+std::vector<Query::domain_id> Query::_read_domains() const
+{
+	std::vector<domain_id> domains;
+
+	if (_selected_domains.empty() && _selected_entities.empty())
+	{
+		return domains;
+	}
+
+	std::vector<bool> read(_domain_names.size(), false);
+
+	for (size_t entity = 0; entity < _entity_names.size(); entity++)
+	{
+		if (_is_selected(entity_id(entity)))
+		{
+			read[_entity_domains[entity]] = true;
+		}
+	}
+
+	for (size_t domain = 0; domain < read.size(); domain++)
+	{
+		if (read[domain] || _builder.affects_other_domains(domain_id(domain)))
+		{
+			domains.push_back(domain_id(domain));
+		}
+	}
+
+	return domains;
+}
+
+bool Query::_seed(const std::vector<std::wstring>& tte_file_paths, Statistics& statistics)
+{
+	if (_options.from <= 0)
+	{
+		return true;
+	}
+
+	IntervalBuilder::IntervalHandler add_interval = [this, &statistics](const IntervalBuilder::Interval& interval)
+		{
+			_add_interval(interval, statistics);
+		};
+
+	// The intervals of merged devices depend on which device every event came from, so all earlier events are replayed
+	if (_builder.tracks_devices())
+	{
+		TTEFileReader::Selection selection;
+		selection.to = _options.from;
+		selection.domains = _read_domains();
+
+		for (const std::wstring& path : tte_file_paths)
+		{
+			if (!std::filesystem::exists(path))
+			{
+				return false;
+			}
+
+			TTEFileReader reader(path);
+			reader.set_entity_domains(_entity_domains);
+
+			reader.walk_events(selection,
+				[this, &statistics, &add_interval](const TTEFileReader::Event& event)
+				{
+					if (event.entity < _entity_names.size())
+					{
+						statistics.scanned_events++;
+
+						_last_time = TimeConverter::to_timestamp(2000 + event.date.year, event.date.month, event.date.day, event.hour, event.minute, event.second);
+						_builder.add_event(_last_time, event.entity, add_interval);
+					}
+
+					return true;
+				}
+			);
+		}
+
+		return true;
+	}
+
+	std::vector<domain_id> pending = _read_domains();
+
+	if (pending.empty())
+	{
+		for (size_t domain = 0; domain < _domain_names.size(); domain++)
+		{
+			pending.push_back(domain_id(domain));
+		}
+	}
+
+	struct Seed
+	{
+		timestamp time;
+		entity_id entity;
+	};
+
+	std::vector<Seed> seeds;
+
+	for (auto it = tte_file_paths.rbegin(); it != tte_file_paths.rend() && !pending.empty(); ++it)
+	{
+		if (!std::filesystem::exists(*it))
+		{
+			return false;
+		}
+
+		TTEFileReader reader(*it);
+		reader.set_entity_domains(_entity_domains);
+
+		for (size_t i = 0; i < pending.size();)
+		{
+			TTEFileReader::Selection selection;
+			selection.to = _options.from;
+			selection.domains = { pending[i] };
+
+			// The last date block with events of the domain holds its last event
+			bool has_date = false;
+			TTEFileReader::Date last_date;
+
+			for (const TTEFileReader::Date& date : reader.dates(selection))
+			{
+				has_date = true;
+				last_date = date;
+			}
+
+			bool found = false;
+			Seed seed{};
+
+			if (has_date)
+			{
+				selection.from = TimeConverter::to_timestamp(2000 + last_date.year, last_date.month, last_date.day, 0, 0, 0);
+
+				reader.walk_events(selection,
+					[this, &found, &seed](const TTEFileReader::Event& event)
+					{
+						if (event.entity < _entity_names.size())
+						{
+							seed.time = TimeConverter::to_timestamp(2000 + event.date.year, event.date.month, event.date.day, event.hour, event.minute, event.second);
+							seed.entity = event.entity;
+							found = true;
+						}
+
+						return true;
+					}
+				);
+			}
+
+			if (found)
+			{
+				seeds.push_back(seed);
+				pending.erase(pending.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	std::stable_sort(seeds.begin(), seeds.end(),
+		[](const Seed& a, const Seed& b)
+		{
+			return a.time < b.time;
+		}
+	);
+
+	// Only the intervals still open at the start of the range are counted
+	for (const Seed& seed : seeds)
+	{
+		statistics.scanned_events++;
+
+		_last_time = seed.time;
+		_builder.add_event(seed.time, seed.entity, add_interval);
+	}
+
+	return true;
+}
+
+bool Query::_scan(const std::wstring& tte_file_path, Statistics& statistics)
+{
+	if (!std::filesystem::exists(tte_file_path))
+	{
+		return false;
+	}
+
+	TTEFileReader reader(tte_file_path);
+	reader.set_entity_domains(_entity_domains);
+
+	TTEFileReader::Selection selection;
+	selection.from = _options.from;
+	selection.to = _options.to;
+	selection.domains = _read_domains();
+
+	TTEFileReader::DateRange dates = reader.dates(selection);
+	uint16_t dates_read = uint16_t(std::distance(dates.begin(), dates.end()));
+
+	IntervalBuilder::IntervalHandler add_interval = [this, &statistics](const IntervalBuilder::Interval& interval)
+		{
+			_add_interval(interval, statistics);
+		};
+
+	bool has_date = false;
+	TTEFileReader::Date last_date;
+
+	reader.walk_events(selection,
+		[this, &statistics, &add_interval, &has_date, &last_date](const TTEFileReader::Event& event)
+		{
+			if (event.entity >= _entity_names.size())
+			{
+				return true;
+			}
+
+			if (_use_histogram && has_date && !(event.date == last_date))
+			{
+				_histogram_builder->end_block();
+			}
+
+			has_date = true;
+			last_date = event.date;
+
+			timestamp time = TimeConverter::to_timestamp(2000 + event.date.year, event.date.month, event.date.day, event.hour, event.minute, event.second);
+
+			statistics.scanned_events++;
+
+			_last_time = time;
+			_builder.add_event(time, event.entity, add_interval);
+
+			if (_is_selected(event.entity))
+			{
+				if (_use_sketches)
+					_add_sketched_event(event.entity);
+				else if (_use_histogram)
+					_histogram_builder->add_event(event.entity, time);
+				else
+					_group(event.entity, time).events++;
+
+				statistics.matched_events++;
+			}
+
+			return true;
+		}
+	);
+
+	if (_use_histogram)
+	{
+		_histogram_builder->end_block();
+	}
+
+	// Data after the range closes the intervals still open at its end
+	if (_options.to != (std::numeric_limits<timestamp>::max)())
+	{
+		TTEFileReader::Selection after;
+		after.from = _options.to;
+
+		TTEFileReader::DateRange later = reader.dates(after);
+		_done = later.begin() != later.end();
+	}
+
+	statistics.skipped_dates += reader.count_dates() - dates_read;
+
+	return true;
+}
+
+void Query::_finish(std::vector<Row>& rows, Statistics& statistics)
+{
+	// Intervals still open at the end of the data are closed at the last event
+	_builder.close(_done ? _options.to : _last_time,
+		[this, &statistics](const IntervalBuilder::Interval& interval)
+		{
+			_add_interval(interval, statistics);
+		}
+	);
+
+	rows.clear();
+
+	if (_use_histogram)
+	{
+		_histogram_builder->finish(*_histogram);
+
+		statistics.histogram_threads = _histogram_builder->num_of_threads();
+		statistics.histogram_batches = _histogram_builder->num_of_batches();
+
+		_add_histogram_rows(*_histogram);
+	}
+
+	if (_use_sketches)
+	{
+		_sketched_rows(rows, statistics);
+	}
+	else
+	{
+		rows.reserve(_groups.size());
+
+		for (const auto& [key, row] : _groups)
+		{
+			rows.push_back(row);
+		}
+	}
+
+	statistics.groups = rows.size();
+
+	auto key = [](const Row& row)
+		{
+			return std::make_tuple(row.day, row.weekday, row.hour, row.domain, row.entity);
+		};
+
+	std::sort(rows.begin(), rows.end(),
+		[this, &key](const Row& a, const Row& b)
+		{
+			if (_options.sort == Sort::DURATION && a.duration != b.duration)
+				return a.duration > b.duration;
+			if (_options.sort == Sort::EVENTS && a.events != b.events)
+				return a.events > b.events;
+
+			return key(a) < key(b);
+		}
+	);
+
+	if (_options.top > 0 && rows.size() > _options.top)
+	{
+		rows.resize(_options.top);
+	}
+
+	_groups.clear();
+
+	_histogram_builder.reset();
+	_histogram.reset();
+}
+
+bool Query::_is_selected(entity_id entity) const
+{
+	if (!_selected_entities.empty() && !_selected_entities[entity])
+	{
+		return false;
+	}
+
+	return _selected_domains.empty() || _selected_domains[_entity_domains[entity]];
+}
+
+Query::Row& Query::_group(entity_id entity, timestamp time)
+{
+	Row key;
+
+	if (_group_domain || _group_entity)
+	{
+		key.domain = _entity_domains[entity];
+	}
+
+	if (_group_entity)
+	{
+		key.entity = entity;
+	}
+
+	if (_group_hour || _group_weekday || _group_day)
+	{
+		int32_t day = TimeConverter::to_day(time);
+
+		// 2000-01-01 was a Saturday
+		key.hour = _group_hour ? int32_t((time - TimeConverter::from_day(day)) / _options.bucket_size) : 0;
+		key.weekday = _group_weekday ? ((day + 5) % 7 + 7) % 7 : 0;
+		key.day = _group_day ? day : 0;
+	}
+
+	return _group(key);
+}
+
+Query::Row& Query::_group(const Row& key)
+{
+	// Hours are at most 86400 one second buckets, days fit 26 bits until the year 180000
+	uint64_t packed = uint64_t(key.domain) | (uint64_t(key.entity) << 8) | (uint64_t(key.hour) << 24)
+		| (uint64_t(key.weekday) << 41) | (uint64_t(uint32_t(key.day)) << 44);
+
+	return _groups.try_emplace(packed, key).first->second;
+}
+
+void Query::_add_interval(const IntervalBuilder::Interval& interval, Statistics& statistics)
+{
+	if (interval.entity >= _entity_names.size() || !_is_selected(interval.entity))
+	{
+		return;
+	}
+
+	timestamp start = (std::max)(interval.start, _options.from);
+	timestamp end = (std::min)(interval.end, _options.to);
+
+	if (end <= start)
+	{
+		return;
+	}
+
+	statistics.intervals++;
+
+	if (_use_sketches)
+	{
+		_add_sketched_duration(interval.entity, end - start);
+		return;
+	}
+
+	if (_use_histogram)
+	{
+		_histogram_builder->add_interval(interval.entity, start, end);
+		return;
+	}
+
+	if (!_group_hour && !_group_weekday && !_group_day)
+	{
+		_group(interval.entity, start).duration += end - start;
+		return;
+	}
+
+	while (start < end)
+	{
+		timestamp day_start = TimeConverter::from_day(TimeConverter::to_day(start));
+		timestamp boundary = _group_hour ? day_start + ((start - day_start) / _options.bucket_size + 1) * _options.bucket_size : day_start + TimeConverter::seconds_per_day;
+
+		timestamp stop = (std::min)(end, boundary);
+
+		_group(interval.entity, start).duration += stop - start;
+		start = stop;
+	}
+}
+
+Query::_DomainSketch::_DomainSketch(size_t capacity)
+	: top(capacity)
+{
+}
+
+void Query::_add_sketched_event(entity_id entity)
+{
+	_DomainSketch& sketch = _sketches[_entity_domains[entity]];
+
+	sketch.events.add(entity, 1);
+
+	if (_options.sort == Sort::EVENTS)
+	{
+		sketch.top.add(entity, 1);
+	}
+}
+
+void Query::_add_sketched_duration(entity_id entity, timestamp duration)
+{
+	_DomainSketch& sketch = _sketches[_entity_domains[entity]];
+
+	sketch.durations.add(entity, duration);
+
+	if (_options.sort != Sort::EVENTS)
+	{
+		sketch.top.add(entity, duration);
+	}
+}
+
+void Query::_sketched_rows(std::vector<Row>& rows, Statistics& statistics) const
+{
+	statistics.approximate = true;
+
+	for (size_t domain = 0; domain < _sketches.size(); domain++)
+	{
+		const _DomainSketch& sketch = _sketches[domain];
+
+		statistics.sketch_bytes += sketch.durations.size_in_bytes() + sketch.events.size_in_bytes()
+			+ sketch.top.capacity() * (sizeof(SpaceSaving::Counter) + 2 * sizeof(size_t));
+
+		for (const SpaceSaving::Counter& counter : sketch.top.top(sketch.top.capacity()))
+		{
+			Row row;
+			row.domain = domain_id(domain);
+			row.entity = entity_id(counter.key);
+
+			int64_t duration = sketch.durations.estimate(counter.key);
+			int64_t events = sketch.events.estimate(counter.key);
+
+			// Both summaries overestimate, so the smaller estimate is the tighter one
+			if (_options.sort == Sort::EVENTS)
+				events = (std::min)(events, counter.count);
+			else
+				duration = (std::min)(duration, counter.count);
+
+			row.duration = duration;
+			row.events = uint64_t(events);
+
+			// The Space-Saving count minus its error never exceeds the true value
+			row.error = (_options.sort == Sort::EVENTS ? events : duration) - (counter.count - counter.error);
+
+			rows.push_back(row);
+		}
+	}
+}
+
+void Query::_add_histogram_rows(const Histogram& histogram)
+{
+	int32_t buckets_per_day = int32_t(TimeConverter::seconds_per_day / histogram.bucket_size());
+
+	for (size_t entity = 0; entity < histogram.num_of_entities(); entity++)
+	{
+		if (!histogram.has_data(entity_id(entity)))
+		{
+			continue;
+		}
+
+		for (size_t bucket = 0; bucket < histogram.num_of_buckets(); bucket++)
+		{
+			timestamp duration = histogram.duration(entity_id(entity), bucket);
+			uint64_t events = histogram.events(entity_id(entity), bucket);
+
+			if (duration == 0 && events == 0)
+			{
+				continue;
+			}
+
+			Row key;
+			key.domain = _group_domain || _group_entity ? _entity_domains[entity] : 0;
+			key.entity = _group_entity ? entity_id(entity) : 0;
+			key.hour = _group_hour ? int32_t(bucket) % buckets_per_day : 0;
+			key.weekday = _group_weekday ? int32_t(bucket) / buckets_per_day : 0;
+
+			Row& row = _group(key);
+			row.duration += duration;
+			row.events += events;
+		}
+	}
+}
+
+std::string Query::_key_name(Group group, const Row& row) const
+{
+	switch (group)
+	{
+	case Group::DOMAIN:
+		return row.domain < _domain_names.size() ? _domain_names[row.domain] : std::to_string(row.domain);
+	case Group::ENTITY:
+		return row.entity < _entity_names.size() ? _entity_names[row.entity] : std::to_string(row.entity);
+	case Group::HOUR:
+	{
+		if (_options.bucket_size == 3600)
+		{
+			return Format::format("{:02}", row.hour);
+		}
+
+		timestamp start = row.hour * _options.bucket_size;
+		return Format::format("{:02}:{:02}", start / 3600, start / 60 % 60);
+	}
+	case Group::WEEKDAY:
+	{
+		const char* const names[] = { "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun" };
+		return row.weekday >= 0 && row.weekday < 7 ? names[row.weekday] : std::to_string(row.weekday);
+	}
+	case Group::DAY:
+	{
+		int year, month, day;
+		TimeConverter::to_date(row.day, year, month, day);
+
+		return Format::format("{:04}-{:02}-{:02}", year, month, day);
+	}
+	}
+
+	return std::string();
+}
+
+std::string Query::_duration_string(timestamp duration)
+{
+	return Format::format("{}:{:02}:{:02}", duration / 3600, duration / 60 % 60, duration % 60);
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <tuple>
+#include <algorithm>
+#include <iterator>
+#include <ostream>
+#include <filesystem>
+#include <memory>
+
+#include <stdint.h>
+
+#include "../Analysis/CountMinSketch.h"
+#include "../Analysis/Histogram.h"
+#include "../Analysis/HistogramBuilder.h"
+#include "../Analysis/IntervalBuilder.h"
+#include "../Analysis/SpaceSaving.h"
+
+#include "../Database/TTEFile/TTEFileDate.h"
+#include "../Database/TTEFile/TTEFileEvent.h"
+#include "../Database/TTEFile/TTEFileReader.h"
+#include "../Database/TTEFile/TTESegmentReader.h"
+#include "../Database/TTRFile/TTRFileMappedReader.h"
+
+#include "../Utils/Format.h"
+#include "../Utils/Logger.h"
+#include "../Utils/StringConverter.h"
+#include "../Utils/StringHash.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* Aggregates the events of a database in a single streaming pass.
+* 
+* Every event that passes the filters is counted, and the intervals built by
+* IntervalBuilder add their duration, clipped to the time range and split at
+* hour and day boundaries when grouping by them. Rows are aggregated in a
+* hash map keyed by the packed group key, so memory only depends on the
+* number of groups.
+* 
+* The range and the domains are handed to TTEFileReader as a selection, so its
+* zone maps skip the date blocks outside of them. Domains whose events close or
+* resume the intervals of others are always read. Before the range, only the
+* last event of every read domain seeds the interval builder, so intervals that
+* started before the range are still counted, also when they started in an
+* earlier segment of a segmented database (<input>.ttm). Merged databases keep
+* intervals per device, so their earlier events are all replayed instead. Of the segments after
+* the start of the range, only those that overlap it are opened.
+* 
+* With a sketch capacity, queries grouped by entity keep a Space-Saving
+* summary of that many entities per domain instead of a row per entity, and
+* Count-Min sketches of the durations and event counts to tighten the
+* estimates. Memory is then bounded no matter how many entities the registry
+* holds, every row reports how much its ranked value may be overestimated.
+* 
+* Grouping by hour or weekday without day accumulates into a dense Histogram
+* instead of the hash map, on several threads when asked to. Hours are
+* buckets of bucket_size seconds, so an hour may also be a quarter hour.
+*/
+
+class Query
+{
+public:
+	using timestamp = TimeConverter::timestamp;
+	using domain_id = IntervalBuilder::domain_id;
+	using entity_id = IntervalBuilder::entity_id;
+
+	enum class Group
+	{
+		DOMAIN,
+		ENTITY,
+		HOUR,
+		WEEKDAY,
+		DAY
+	};
+
+	enum class Sort
+	{
+		DURATION,
+		EVENTS,
+		KEY
+	};
+
+	enum class Output
+	{
+		TEXT,
+		CSV,
+		JSON
+	};
+
+	struct Options
+	{
+		// Half-open range [from, to)
+		timestamp from = (std::numeric_limits<timestamp>::min)();
+		timestamp to = (std::numeric_limits<timestamp>::max)();
+
+		// Names, empty to select all
+		std::vector<std::string> domains;
+		std::vector<std::string> entities;
+
+		std::vector<Group> group_by;
+
+		Sort sort = Sort::DURATION;
+
+		// 0 for all rows
+		size_t top = 0;
+
+		// Entities tracked per domain when grouping by entity, 0 to aggregate exactly
+		size_t sketch_capacity = 0;
+
+		// Width of the hour buckets, must evenly divide a day
+		timestamp bucket_size = 3600;
+
+		// Workers of the histogram, 0 for one per core
+		size_t threads = 1;
+	};
+
+	struct Row
+	{
+		domain_id domain = 0;
+		entity_id entity = 0;
+		// Bucket of the day when grouping by hour, 0 is Monday for weekdays
+		int32_t hour = 0;
+		int32_t weekday = 0;
+		int32_t day = 0;
+
+		uint64_t events = 0;
+		timestamp duration = 0;
+
+		// Upper bound of the overestimate of the sorted value, only set by sketches
+		int64_t error = 0;
+	};
+
+	struct Statistics
+	{
+		uint64_t scanned_events = 0;
+		uint64_t matched_events = 0;
+		uint64_t intervals = 0;
+
+		uint16_t skipped_dates = 0;
+		size_t groups = 0;
+
+		bool approximate = false;
+		size_t sketch_bytes = 0;
+
+		// Workers and batches of the histogram, 0 when aggregating in the hash map
+		size_t histogram_threads = 0;
+		uint64_t histogram_batches = 0;
+	};
+
+public:
+	Query(const Options& options);
+
+	bool run(const std::wstring& ttr_file_path, const std::wstring& tte_file_path, std::vector<Row>& rows, Statistics& statistics);
+
+	// Reads the events from the segments of a manifest
+	bool run_segments(const std::wstring& ttr_file_path, const std::wstring& manifest_file_path, std::vector<Row>& rows, Statistics& statistics);
+
+	void write(const std::vector<Row>& rows, Output output, std::ostream& stream) const;
+
+	static bool parse_group(std::string_view name, Group& group);
+
+private:
+	Options _options;
+
+	std::vector<std::string> _domain_names;
+	std::vector<std::string> _entity_names;
+	std::vector<domain_id> _entity_domains;
+
+	// Indexed by ID, empty when not filtering
+	std::vector<bool> _selected_domains;
+	std::vector<bool> _selected_entities;
+
+	bool _group_domain = false;
+	bool _group_entity = false;
+	bool _group_hour = false;
+	bool _group_weekday = false;
+	bool _group_day = false;
+
+	std::unordered_map<uint64_t, Row> _groups;
+
+	struct _DomainSketch
+	{
+		SpaceSaving top;
+
+		CountMinSketch durations;
+		CountMinSketch events;
+
+		_DomainSketch(size_t capacity);
+	};
+
+	bool _use_sketches = false;
+	std::vector<_DomainSketch> _sketches;
+
+	bool _use_histogram = false;
+	std::unique_ptr<Histogram> _histogram;
+	std::unique_ptr<HistogramBuilder> _histogram_builder;
+
+	IntervalBuilder _builder;
+	timestamp _last_time = 0;
+	bool _done = false;
+
+private:
+	bool _load_registry(const std::wstring& ttr_file_path);
+
+	// Domains the builder has to see, empty for all
+	std::vector<domain_id> _read_domains() const;
+
+	// Feeds the builder the last event of every read domain before the range, searching the files backwards
+	bool _seed(const std::vector<std::wstring>& tte_file_paths, Statistics& statistics);
+	bool _scan(const std::wstring& tte_file_path, Statistics& statistics);
+	void _finish(std::vector<Row>& rows, Statistics& statistics);
+
+	bool _is_selected(entity_id entity) const;
+
+	Row& _group(entity_id entity, timestamp time);
+	Row& _group(const Row& key);
+	void _add_interval(const IntervalBuilder::Interval& interval, Statistics& statistics);
+
+	void _add_sketched_event(entity_id entity);
+	void _add_sketched_duration(entity_id entity, timestamp duration);
+	void _sketched_rows(std::vector<Row>& rows, Statistics& statistics) const;
+
+	void _add_histogram_rows(const Histogram& histogram);
+
+	std::string _key_name(Group group, const Row& row) const;
+	static std::string _duration_string(timestamp duration);
+};
\ No newline at end of file
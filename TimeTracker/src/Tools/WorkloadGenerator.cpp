@@ -0,0 +1,339 @@
+#include "WorkloadGenerator.h"
+
+WorkloadGenerator::WorkloadGenerator(const Options& options)
+	: _options(options), _state(options.seed * 0x9E3779B97F4A7C15ull + 0x2545F4914F6CDD1Dull)
+{
+	if (_state == 0)
+	{
+		_state = 1;
+	}
+
+	_domains[RUNTIME].name = "Runtime";
+	_domains[RUNTIME].entities = { "Startup", "Shutdown" };
+
+	_domains[ACTIVITY].name = "Activity";
+	_domains[ACTIVITY].entities = { "Inactivity start", "Inactivity end" };
+
+	_domains[SYSTEM].name = "System";
+	_domains[SYSTEM].entities = { "chrome.exe", "Code.exe", "explorer.exe", "Obsidian.exe" };
+	for (size_t i = _domains[SYSTEM].entities.size(); i < options.system_entities; i++)
+	{
+		_domains[SYSTEM].entities.push_back(Format::format("app{:04}.exe", i));
+	}
+
+	_domains[BROWSER].name = "Browser";
+	for (size_t i = 0; i < options.browser_entities; i++)
+	{
+		_domains[BROWSER].entities.push_back(Format::format("site{:05}.example.com", i));
+	}
+
+	_domains[VSCODE].name = "VSCode";
+	for (size_t i = 0; i < options.vscode_entities; i++)
+	{
+		_domains[VSCODE].entities.push_back(Format::format("project{:04}", i));
+	}
+
+	_domains[OBSIDIAN].name = "Obsidian";
+	for (size_t i = 0; i < options.obsidian_entities; i++)
+	{
+		_domains[OBSIDIAN].entities.push_back(Format::format("vault{:03}", i));
+	}
+
+	for (_Domain& domain : _domains)
+	{
+		domain.popularity = _ZipfDistribution(domain.entities.size(), options.zipf_exponent);
+	}
+}
+
+bool WorkloadGenerator::generate(const std::wstring& ttr_file_path, const std::wstring& tte_file_path, Statistics& statistics)
+{
+	if (!write_registry(ttr_file_path))
+	{
+		Logger::append_info("Failed to generate workload");
+		return false;
+	}
+
+	TTEFileStreamWriter writer(tte_file_path);
+
+	if (!writer.open())
+	{
+		Logger::append_info("Failed to generate workload");
+		return false;
+	}
+
+	bool success = generate_events(
+		[&writer](const TTEFileDate& date, const TTEFileEvent& event)
+		{
+			return writer.add_event(date, event);
+		},
+		statistics
+	);
+
+	success = writer.close() && success;
+	statistics.num_of_dates = writer.num_of_dates();
+
+	return success;
+}
+
+bool WorkloadGenerator::write_registry(const std::wstring& ttr_file_path)
+{
+	TTRFileStreamWriter registry(ttr_file_path);
+
+	if (!_build_registry(registry))
+	{
+		return false;
+	}
+
+	return registry.write();
+}
+
+bool WorkloadGenerator::generate_events(EventHandler handler, Statistics& statistics)
+{
+	if (_domains[RUNTIME].ids.empty())
+	{
+		TTRFileStreamWriter registry(L"");
+		if (!_build_registry(registry))
+		{
+			return false;
+		}
+	}
+
+	statistics.num_of_entities = 0;
+	for (const _Domain& domain : _domains)
+	{
+		statistics.num_of_entities += domain.ids.size();
+	}
+
+	int32_t first_day = TimeConverter::to_day(TimeConverter::to_timestamp(
+		2000 + _options.start_date.year, _options.start_date.month, _options.start_date.day, 0, 0, 0));
+
+	for (uint32_t i = 0; i < _options.days; i++)
+	{
+		int32_t day = first_day + int32_t(i);
+
+		// 2000-01-01 was a Saturday
+		int weekday = ((day % 7) + 7) % 7;
+		bool weekend = weekday == 0 || weekday == 1;
+
+		if (_uniform() >= (weekend ? _options.weekend_activity : _options.weekday_activity))
+		{
+			continue;
+		}
+
+		int64_t start = int64_t(std::clamp(_normal(8.5 * 3600, 3600), 5.0 * 3600, 12.0 * 3600));
+		int64_t end = int64_t(std::clamp(_normal(18.0 * 3600, 5400), 13.0 * 3600, 23.5 * 3600));
+
+		// Occasionally split the day with a lunch time shutdown
+		if (_uniform() < 0.2 && end - start > 3 * 3600)
+		{
+			int64_t lunch = int64_t(std::clamp(_normal(12.5 * 3600, 1800), start + 3600.0, end - 3600.0));
+			int64_t resume = lunch + 1800 + int64_t(_exponential(1800));
+
+			if (resume + 3600 < end)
+			{
+				if (!_simulate_session(handler, day, start, lunch, statistics))
+				{
+					return false;
+				}
+
+				start = resume;
+			}
+		}
+
+		if (!_simulate_session(handler, day, start, end, statistics))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint64_t WorkloadGenerator::_next()
+{
+	// xorshift64*
+	_state ^= _state >> 12;
+	_state ^= _state << 25;
+	_state ^= _state >> 27;
+	return _state * 0x2545F4914F6CDD1Dull;
+}
+
+double WorkloadGenerator::_uniform()
+{
+	return double(_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double WorkloadGenerator::_exponential(double mean)
+{
+	return -std::log(1.0 - _uniform()) * mean;
+}
+
+double WorkloadGenerator::_normal(double mean, double deviation)
+{
+	double u1 = 1.0 - _uniform();
+	double u2 = _uniform();
+
+	return mean + deviation * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * 3.14159265358979323846 * u2);
+}
+
+WorkloadGenerator::_ZipfDistribution::_ZipfDistribution()
+{
+}
+
+WorkloadGenerator::_ZipfDistribution::_ZipfDistribution(size_t size, double exponent)
+	: _cdf(size)
+{
+	double sum = 0.0;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		sum += 1.0 / std::pow(double(i + 1), exponent);
+		_cdf[i] = sum;
+	}
+
+	for (double& value : _cdf)
+	{
+		value /= sum;
+	}
+}
+
+size_t WorkloadGenerator::_ZipfDistribution::sample(double uniform) const
+{
+	auto it = std::upper_bound(_cdf.begin(), _cdf.end(), uniform);
+
+	if (it == _cdf.end())
+	{
+		return _cdf.size() - 1;
+	}
+
+	return size_t(it - _cdf.begin());
+}
+
+bool WorkloadGenerator::_build_registry(TTRFileStreamWriter& registry)
+{
+	for (_Domain& domain : _domains)
+	{
+		domain.ids.clear();
+
+		TTRFileStreamWriter::domain_id domain_id;
+		if (!registry.add_domain(domain.name, domain_id))
+		{
+			Logger::append_info("Failed to build registry");
+			return false;
+		}
+
+		for (const std::string& entity : domain.entities)
+		{
+			TTRFileStreamWriter::entity_id entity_id;
+			if (!registry.add_entity(domain_id, entity, entity_id))
+			{
+				Logger::append_info("Failed to build registry");
+				return false;
+			}
+
+			domain.ids.push_back(entity_id);
+		}
+	}
+
+	return true;
+}
+
+bool WorkloadGenerator::_emit(EventHandler& handler, int32_t day, int64_t second, TTEFileEvent::entity_id entity, Statistics& statistics)
+{
+	// The Database never stores the same entity twice in a row
+	if (_has_last_entity && _last_entity == entity)
+	{
+		return true;
+	}
+
+	int year, month, day_of_month;
+	TimeConverter::to_date(day, year, month, day_of_month);
+
+	TTEFileDate date(uint8_t(year - 2000), uint8_t(month), uint8_t(day_of_month));
+	TTEFileEvent event(entity, uint8_t(second / 3600), uint8_t(second / 60 % 60), uint8_t(second % 60));
+
+	if (!handler(date, event))
+	{
+		return false;
+	}
+
+	_last_entity = entity;
+	_has_last_entity = true;
+
+	statistics.num_of_events++;
+
+	return true;
+}
+
+bool WorkloadGenerator::_simulate_session(EventHandler& handler, int32_t day, int64_t start, int64_t end, Statistics& statistics)
+{
+	statistics.num_of_sessions++;
+
+	if (!_emit(handler, day, start, _domains[RUNTIME].ids[0], statistics))
+	{
+		return false;
+	}
+
+	double mean_gap = 3600.0 / (std::max)(_options.events_per_hour, 0.01);
+	double idle_probability = _options.idle_periods_per_hour / (std::max)(_options.events_per_hour, 0.01);
+
+	int64_t time = start + 1;
+
+	while (true)
+	{
+		time += 1 + int64_t(_exponential(mean_gap));
+
+		if (time >= end)
+		{
+			break;
+		}
+
+		if (_uniform() < idle_probability)
+		{
+			int64_t idle_end = time + 300 + int64_t(_exponential(1200));
+
+			if (idle_end >= end)
+			{
+				break;
+			}
+
+			if (!_emit(handler, day, time, _domains[ACTIVITY].ids[0], statistics) ||
+				!_emit(handler, day, idle_end, _domains[ACTIVITY].ids[1], statistics))
+			{
+				return false;
+			}
+
+			time = idle_end;
+			continue;
+		}
+
+		_Domain& system = _domains[SYSTEM];
+		size_t application = system.popularity.sample(_uniform());
+
+		if (!_emit(handler, day, time, system.ids[application], statistics))
+		{
+			return false;
+		}
+
+		_Domain* plugin = nullptr;
+
+		if (system.entities[application] == "chrome.exe")
+			plugin = &_domains[BROWSER];
+		else if (system.entities[application] == "Code.exe")
+			plugin = &_domains[VSCODE];
+		else if (system.entities[application] == "Obsidian.exe")
+			plugin = &_domains[OBSIDIAN];
+
+		if (plugin != nullptr && !plugin->ids.empty() && _uniform() < 0.7 && time + 2 < end)
+		{
+			time += 1 + int64_t(_uniform() * 2);
+
+			if (!_emit(handler, day, time, plugin->ids[plugin->popularity.sample(_uniform())], statistics))
+			{
+				return false;
+			}
+		}
+	}
+
+	return _emit(handler, day, end, _domains[RUNTIME].ids[1], statistics);
+}
\ No newline at end of file
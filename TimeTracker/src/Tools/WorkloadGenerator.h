@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+
+#include <stdint.h>
+
+#include "../Database/TTEFile/TTEFileDate.h"
+#include "../Database/TTEFile/TTEFileEvent.h"
+#include "../Database/TTEFile/TTEFileStreamWriter.h"
+#include "../Database/TTRFile/TTRFileStreamWriter.h"
+
+#include "../Utils/Format.h"
+#include "../Utils/Logger.h"
+#include "../Utils/TimeConverter.h"
+
+/*
+* Produces synthetic but realistic TTE/TTR databases:
+* 
+*   - Each active day has one or more sessions framed by Runtime Startup/Shutdown.
+*   - Within a session the foreground application changes with exponential gaps,
+*     picked from the System domain with Zipfian popularity. Focusing a browser,
+*     VSCode or Obsidian is usually followed by the matching plugin event.
+*   - Sessions contain idle periods marked by Activity Inactivity start/end.
+* 
+* All randomness comes from a seeded xorshift generator with hand-written
+* distributions, so a seed produces the same files on every platform.
+*/
+
+class WorkloadGenerator
+{
+public:
+	struct Options
+	{
+		uint64_t seed = 1;
+
+		TTEFileDate start_date = TTEFileDate(20, 1, 1);
+		uint32_t days = 365;
+
+		uint16_t system_entities = 200;
+		uint16_t browser_entities = 5000;
+		uint16_t vscode_entities = 100;
+		uint16_t obsidian_entities = 20;
+
+		double zipf_exponent = 1.1;
+
+		double events_per_hour = 60.0;
+		double idle_periods_per_hour = 0.5;
+
+		double weekday_activity = 0.95;
+		double weekend_activity = 0.4;
+	};
+
+	struct Statistics
+	{
+		uint64_t num_of_events = 0;
+		uint16_t num_of_dates = 0;
+		uint64_t num_of_sessions = 0;
+		size_t num_of_entities = 0;
+	};
+
+	using EventHandler = std::function<bool(const TTEFileDate&, const TTEFileEvent&)>;
+
+public:
+	WorkloadGenerator(const Options& options);
+
+	bool generate(const std::wstring& ttr_file_path, const std::wstring& tte_file_path, Statistics& statistics);
+
+	bool write_registry(const std::wstring& ttr_file_path);
+	bool generate_events(EventHandler handler, Statistics& statistics);
+
+private:
+	Options _options;
+
+	uint64_t _state;
+
+	uint64_t _next();
+	double _uniform();
+	double _exponential(double mean);
+	double _normal(double mean, double deviation);
+
+private:
+	class _ZipfDistribution
+	{
+	public:
+		_ZipfDistribution();
+		_ZipfDistribution(size_t size, double exponent);
+
+		size_t sample(double uniform) const;
+
+	private:
+		std::vector<double> _cdf;
+	};
+
+	struct _Domain
+	{
+		std::string name;
+		std::vector<std::string> entities;
+		std::vector<TTEFileEvent::entity_id> ids;
+		_ZipfDistribution popularity;
+	};
+
+	enum _DomainIndex { RUNTIME, ACTIVITY, SYSTEM, BROWSER, VSCODE, OBSIDIAN, NUM_OF_DOMAINS };
+
+	_Domain _domains[NUM_OF_DOMAINS];
+
+	bool _build_registry(TTRFileStreamWriter& registry);
+
+private:
+	TTEFileEvent::entity_id _last_entity = 0;
+	bool _has_last_entity = false;
+
+	bool _emit(EventHandler& handler, int32_t day, int64_t second, TTEFileEvent::entity_id entity, Statistics& statistics);
+	bool _simulate_session(EventHandler& handler, int32_t day, int64_t start, int64_t end, Statistics& statistics);
+};
\ No newline at end of file
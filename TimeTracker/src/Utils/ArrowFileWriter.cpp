@@ -0,0 +1,564 @@
+#include "ArrowFileWriter.h"
+
+// Values from the Arrow format definitions (Schema.fbs, Message.fbs)
+namespace
+{
+	constexpr int16_t metadata_version_v5 = 4;
+
+	constexpr uint8_t header_schema = 1;
+	constexpr uint8_t header_dictionary_batch = 2;
+	constexpr uint8_t header_record_batch = 3;
+
+	constexpr uint8_t type_int = 2;
+	constexpr uint8_t type_utf8 = 5;
+	constexpr uint8_t type_timestamp = 10;
+	constexpr uint8_t type_duration = 18;
+
+	constexpr int16_t time_unit_second = 0;
+
+	constexpr char magic[] = "ARROW1";
+}
+
+ArrowFileWriter::ArrowFileWriter(const std::wstring& file_path, const std::vector<Column>& columns, size_t batch_size)
+	: _file_path(file_path), _columns(columns), _batch_size((std::max<size_t>)(batch_size, 1))
+{
+}
+
+ArrowFileWriter::~ArrowFileWriter()
+{
+	if (_file.is_open())
+	{
+		close();
+	}
+}
+
+bool ArrowFileWriter::open()
+{
+	_file.open(std::filesystem::path(_file_path), std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!_file.is_open())
+	{
+		Logger::log_error("Unable to create file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	_batch.assign(_columns.size(), std::vector<uint8_t>());
+	for (size_t i = 0; i < _columns.size(); i++)
+	{
+		_batch[i].resize(_batch_size * _width(_columns[i].type));
+	}
+
+	_rows_in_batch = 0;
+	_num_of_rows = 0;
+	_offset = 0;
+
+	_dictionary_blocks.clear();
+	_record_batch_blocks.clear();
+
+	if (!_write(magic, 6) || !_write_padding(2) || !_write_schema())
+	{
+		return false;
+	}
+
+	int64_t dictionary_id = 0;
+	for (size_t i = 0; i < _columns.size(); i++)
+	{
+		if (_columns[i].type == Type::DICTIONARY && !_write_dictionary(i, dictionary_id++))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ArrowFileWriter::close()
+{
+	if (!_file.is_open())
+	{
+		return false;
+	}
+
+	bool success = true;
+
+	if (_rows_in_batch > 0)
+	{
+		success = _write_batch();
+	}
+
+	// End of stream marker, followed by the footer of the file format
+	const int32_t end_of_stream[2] = { -1, 0 };
+	success = success && _write(end_of_stream, sizeof(end_of_stream)) && _write_footer();
+
+	_file.close();
+
+	return success;
+}
+
+void ArrowFileWriter::set(size_t column, int64_t value)
+{
+	if (column >= _columns.size())
+	{
+		return;
+	}
+
+	uint8_t* data = _batch[column].data() + _rows_in_batch * _width(_columns[column].type);
+
+	if (_columns[column].type == Type::DICTIONARY)
+	{
+		int16_t index = int16_t(value);
+		std::memcpy(data, &index, sizeof(index));
+	}
+	else
+	{
+		std::memcpy(data, &value, sizeof(value));
+	}
+}
+
+bool ArrowFileWriter::end_row()
+{
+	_rows_in_batch++;
+	_num_of_rows++;
+
+	if (_rows_in_batch < _batch_size)
+	{
+		return true;
+	}
+
+	return _write_batch();
+}
+
+uint64_t ArrowFileWriter::num_of_rows() const
+{
+	return _num_of_rows;
+}
+
+uint64_t ArrowFileWriter::num_of_batches() const
+{
+	return _record_batch_blocks.size();
+}
+
+uint64_t ArrowFileWriter::num_of_bytes() const
+{
+	return _offset;
+}
+
+size_t ArrowFileWriter::_width(Type type)
+{
+	return type == Type::DICTIONARY ? sizeof(int16_t) : sizeof(int64_t);
+}
+
+size_t ArrowFileWriter::_padded(size_t size)
+{
+	return (size + 7) & ~size_t(7);
+}
+
+bool ArrowFileWriter::_write(const void* data, size_t size)
+{
+	_file.write(reinterpret_cast<const char*>(data), size);
+	_offset += size;
+
+	if (!_file.good())
+	{
+		Logger::log_error("Failed to write to file: {}", StringConverter::to_utf8(_file_path));
+		return false;
+	}
+
+	return true;
+}
+
+bool ArrowFileWriter::_write_padding(size_t size)
+{
+	static const uint8_t zeros[8] = { 0 };
+
+	return size == 0 || _write(zeros, size);
+}
+
+bool ArrowFileWriter::_write_message(const std::vector<uint8_t>& metadata, const std::vector<_BodyBuffer>& body, _Block* block)
+{
+	// Continuation marker and metadata length, the body has to start 8-byte aligned
+	int32_t metadata_length = int32_t(_padded(metadata.size()));
+	const int32_t prefix[2] = { -1, metadata_length };
+
+	int64_t start = int64_t(_offset);
+
+	if (!_write(prefix, sizeof(prefix)) || !_write(metadata.data(), metadata.size()) || !_write_padding(metadata_length - metadata.size()))
+	{
+		return false;
+	}
+
+	int64_t body_start = int64_t(_offset);
+
+	for (const _BodyBuffer& buffer : body)
+	{
+		if (!_write(buffer.data, buffer.size) || !_write_padding(_padded(buffer.size) - buffer.size))
+		{
+			return false;
+		}
+	}
+
+	if (block != nullptr)
+	{
+		block->offset = start;
+		block->metadata_length = int32_t(sizeof(prefix)) + metadata_length;
+		block->body_length = int64_t(_offset) - body_start;
+	}
+
+	return true;
+}
+
+bool ArrowFileWriter::_write_schema()
+{
+	std::vector<uint8_t> metadata = _build_message(header_schema, 0,
+		[this](_FlatBufferBuilder& builder)
+		{
+			return _build_schema(builder);
+		}
+	);
+
+	return _write_message(metadata, {}, nullptr);
+}
+
+bool ArrowFileWriter::_write_dictionary(size_t column, int64_t id)
+{
+	const std::vector<std::string>& dictionary = _columns[column].dictionary;
+
+	std::vector<int32_t> offsets = { 0 };
+	std::string data;
+
+	for (const std::string& value : dictionary)
+	{
+		data += value;
+		offsets.push_back(int32_t(data.size()));
+	}
+
+	std::vector<_BodyBuffer> body = {
+		{ nullptr, 0 },
+		{ offsets.data(), offsets.size() * sizeof(int32_t) },
+		{ data.data(), data.size() }
+	};
+
+	int64_t length = int64_t(dictionary.size());
+
+	int64_t body_length = 0;
+	for (const _BodyBuffer& buffer : body)
+	{
+		body_length += _padded(buffer.size);
+	}
+
+	std::vector<uint8_t> metadata = _build_message(header_dictionary_batch, body_length,
+		[this, id, length, &body](_FlatBufferBuilder& builder)
+		{
+			_FlatBufferBuilder::offset data = _build_record_batch(builder, length, { length }, body);
+
+			builder.start_table();
+			builder.add_field<int64_t>(0, id);
+			builder.add_offset_field(1, data);
+			builder.add_field<uint8_t>(2, 0);
+			return builder.end_table();
+		}
+	);
+
+	_Block block;
+	if (!_write_message(metadata, body, &block))
+	{
+		return false;
+	}
+
+	_dictionary_blocks.push_back(block);
+
+	return true;
+}
+
+bool ArrowFileWriter::_write_batch()
+{
+	int64_t length = int64_t(_rows_in_batch);
+
+	std::vector<int64_t> nodes(_columns.size(), length);
+	std::vector<_BodyBuffer> body;
+
+	int64_t body_length = 0;
+
+	for (size_t i = 0; i < _columns.size(); i++)
+	{
+		// No nulls, so the validity bitmap is left empty
+		body.push_back({ nullptr, 0 });
+		body.push_back({ _batch[i].data(), _rows_in_batch * _width(_columns[i].type) });
+
+		body_length += _padded(body.back().size);
+	}
+
+	std::vector<uint8_t> metadata = _build_message(header_record_batch, body_length,
+		[this, length, &nodes, &body](_FlatBufferBuilder& builder)
+		{
+			return _build_record_batch(builder, length, nodes, body);
+		}
+	);
+
+	_Block block;
+	if (!_write_message(metadata, body, &block))
+	{
+		return false;
+	}
+
+	_record_batch_blocks.push_back(block);
+	_rows_in_batch = 0;
+
+	return true;
+}
+
+bool ArrowFileWriter::_write_footer()
+{
+	auto blocks = [](const std::vector<_Block>& blocks)
+		{
+			// struct Block { offset: long; metaDataLength: int; bodyLength: long; }, 24 bytes
+			std::vector<uint8_t> elements(blocks.size() * 24, 0);
+
+			for (size_t i = 0; i < blocks.size(); i++)
+			{
+				std::memcpy(elements.data() + i * 24, &blocks[i].offset, sizeof(int64_t));
+				std::memcpy(elements.data() + i * 24 + 8, &blocks[i].metadata_length, sizeof(int32_t));
+				std::memcpy(elements.data() + i * 24 + 16, &blocks[i].body_length, sizeof(int64_t));
+			}
+
+			return elements;
+		};
+
+	_FlatBufferBuilder builder;
+
+	_FlatBufferBuilder::offset schema = _build_schema(builder);
+	_FlatBufferBuilder::offset dictionaries = builder.create_struct_vector(blocks(_dictionary_blocks), uint32_t(_dictionary_blocks.size()), 8);
+	_FlatBufferBuilder::offset record_batches = builder.create_struct_vector(blocks(_record_batch_blocks), uint32_t(_record_batch_blocks.size()), 8);
+
+	builder.start_table();
+	builder.add_field<int16_t>(0, metadata_version_v5);
+	builder.add_offset_field(1, schema);
+	builder.add_offset_field(2, dictionaries);
+	builder.add_offset_field(3, record_batches);
+
+	std::vector<uint8_t> footer = builder.finish(builder.end_table());
+
+	int32_t footer_length = int32_t(footer.size());
+
+	return _write(footer.data(), footer.size()) && _write(&footer_length, sizeof(footer_length)) && _write(magic, 6);
+}
+
+ArrowFileWriter::_FlatBufferBuilder::offset ArrowFileWriter::_build_schema(_FlatBufferBuilder& builder) const
+{
+	std::vector<_FlatBufferBuilder::offset> fields;
+
+	int64_t dictionary_id = 0;
+
+	for (const Column& column : _columns)
+	{
+		_FlatBufferBuilder::offset name = builder.create_string(column.name);
+		_FlatBufferBuilder::offset children = builder.create_offset_vector({});
+
+		_FlatBufferBuilder::offset type = 0;
+		_FlatBufferBuilder::offset dictionary = 0;
+		uint8_t type_type = 0;
+
+		if (column.type == Type::DICTIONARY)
+		{
+			builder.start_table();
+			type = builder.end_table();
+			type_type = type_utf8;
+
+			builder.start_table();
+			builder.add_field<int32_t>(0, 16);
+			builder.add_field<uint8_t>(1, 1);
+			_FlatBufferBuilder::offset index_type = builder.end_table();
+
+			builder.start_table();
+			builder.add_field<int64_t>(0, dictionary_id++);
+			builder.add_offset_field(1, index_type);
+			builder.add_field<uint8_t>(2, 0);
+			dictionary = builder.end_table();
+		}
+		else
+		{
+			builder.start_table();
+			builder.add_field<int16_t>(0, time_unit_second);
+			type = builder.end_table();
+			type_type = column.type == Type::TIMESTAMP ? type_timestamp : type_duration;
+		}
+
+		builder.start_table();
+		builder.add_offset_field(0, name);
+		builder.add_field<uint8_t>(1, 0);
+		builder.add_field<uint8_t>(2, type_type);
+		builder.add_offset_field(3, type);
+		if (dictionary != 0)
+		{
+			builder.add_offset_field(4, dictionary);
+		}
+		builder.add_offset_field(5, children);
+		fields.push_back(builder.end_table());
+	}
+
+	_FlatBufferBuilder::offset field_vector = builder.create_offset_vector(fields);
+
+	builder.start_table();
+	builder.add_field<int16_t>(0, 0);
+	builder.add_offset_field(1, field_vector);
+	return builder.end_table();
+}
+
+ArrowFileWriter::_FlatBufferBuilder::offset ArrowFileWriter::_build_record_batch(_FlatBufferBuilder& builder, int64_t length, const std::vector<int64_t>& nodes, const std::vector<_BodyBuffer>& body) const
+{
+	// struct FieldNode { length: long; null_count: long; }
+	std::vector<uint8_t> node_elements(nodes.size() * 16, 0);
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		std::memcpy(node_elements.data() + i * 16, &nodes[i], sizeof(int64_t));
+	}
+
+	// struct Buffer { offset: long; length: long; }, relative to the start of the body
+	std::vector<uint8_t> buffer_elements(body.size() * 16, 0);
+	int64_t offset = 0;
+	for (size_t i = 0; i < body.size(); i++)
+	{
+		int64_t size = int64_t(body[i].size);
+
+		std::memcpy(buffer_elements.data() + i * 16, &offset, sizeof(int64_t));
+		std::memcpy(buffer_elements.data() + i * 16 + 8, &size, sizeof(int64_t));
+
+		offset += _padded(body[i].size);
+	}
+
+	_FlatBufferBuilder::offset node_vector = builder.create_struct_vector(node_elements, uint32_t(nodes.size()), 8);
+	_FlatBufferBuilder::offset buffer_vector = builder.create_struct_vector(buffer_elements, uint32_t(body.size()), 8);
+
+	builder.start_table();
+	builder.add_field<int64_t>(0, length);
+	builder.add_offset_field(1, node_vector);
+	builder.add_offset_field(2, buffer_vector);
+	return builder.end_table();
+}
+
+std::vector<uint8_t> ArrowFileWriter::_build_message(uint8_t header_type, int64_t body_length, const std::function<_FlatBufferBuilder::offset(_FlatBufferBuilder&)>& build_header) const
+{
+	_FlatBufferBuilder builder;
+
+	_FlatBufferBuilder::offset header = build_header(builder);
+
+	builder.start_table();
+	builder.add_field<int64_t>(3, body_length);
+	builder.add_offset_field(2, header);
+	builder.add_field<int16_t>(0, metadata_version_v5);
+	builder.add_field<uint8_t>(1, header_type);
+
+	return builder.finish(builder.end_table());
+}
+
+ArrowFileWriter::_FlatBufferBuilder::offset ArrowFileWriter::_FlatBufferBuilder::create_string(std::string_view str)
+{
+	_align(sizeof(uint32_t), str.size() + 1);
+
+	const uint8_t terminator = 0;
+	_prepend(&terminator, 1);
+	_prepend(str.data(), str.size());
+	_prepend<uint32_t>(uint32_t(str.size()));
+
+	return offset(_buffer.size());
+}
+
+ArrowFileWriter::_FlatBufferBuilder::offset ArrowFileWriter::_FlatBufferBuilder::create_struct_vector(const std::vector<uint8_t>& elements, uint32_t count, size_t alignment)
+{
+	_align(sizeof(uint32_t), elements.size());
+	_align(alignment, elements.size());
+
+	_prepend(elements.data(), elements.size());
+	_prepend<uint32_t>(count);
+
+	return offset(_buffer.size());
+}
+
+ArrowFileWriter::_FlatBufferBuilder::offset ArrowFileWriter::_FlatBufferBuilder::create_offset_vector(const std::vector<offset>& offsets)
+{
+	_align(sizeof(uint32_t), offsets.size() * sizeof(uint32_t));
+
+	for (auto it = offsets.rbegin(); it != offsets.rend(); it++)
+	{
+		_prepend_offset(*it);
+	}
+
+	_prepend<uint32_t>(uint32_t(offsets.size()));
+
+	return offset(_buffer.size());
+}
+
+void ArrowFileWriter::_FlatBufferBuilder::start_table()
+{
+	_table_start = _buffer.size();
+	_fields.clear();
+}
+
+ArrowFileWriter::_FlatBufferBuilder::offset ArrowFileWriter::_FlatBufferBuilder::end_table()
+{
+	_prepend<int32_t>(0);
+	offset table = offset(_buffer.size());
+
+	uint16_t num_of_fields = 0;
+	for (const auto& [field, location] : _fields)
+	{
+		num_of_fields = (std::max<uint16_t>)(num_of_fields, field + 1);
+	}
+
+	// The vtable holds its own size, the size of the table and the position of every field in the table
+	std::vector<uint16_t> vtable(2 + num_of_fields, 0);
+	vtable[0] = uint16_t(vtable.size() * sizeof(uint16_t));
+	vtable[1] = uint16_t(table - _table_start);
+
+	for (const auto& [field, location] : _fields)
+	{
+		vtable[2 + field] = uint16_t(table - location);
+	}
+
+	for (auto it = vtable.rbegin(); it != vtable.rend(); it++)
+	{
+		_prepend<uint16_t>(*it);
+	}
+
+	// The table starts with the distance back to its vtable
+	int32_t vtable_distance = int32_t(_buffer.size()) - int32_t(table);
+	std::memcpy(_buffer.data() + _buffer.size() - table, &vtable_distance, sizeof(vtable_distance));
+
+	_fields.clear();
+
+	return table;
+}
+
+void ArrowFileWriter::_FlatBufferBuilder::add_offset_field(uint16_t field, offset value)
+{
+	_prepend_offset(value);
+	_fields.emplace_back(field, offset(_buffer.size()));
+}
+
+std::vector<uint8_t> ArrowFileWriter::_FlatBufferBuilder::finish(offset root)
+{
+	_align(_max_alignment, sizeof(uint32_t));
+	_prepend_offset(root);
+
+	return _buffer;
+}
+
+void ArrowFileWriter::_FlatBufferBuilder::_align(size_t alignment, size_t additional)
+{
+	_max_alignment = (std::max<size_t>)(_max_alignment, alignment);
+
+	size_t padding = (alignment - (_buffer.size() + additional) % alignment) % alignment;
+	_buffer.insert(_buffer.begin(), padding, 0);
+}
+
+void ArrowFileWriter::_FlatBufferBuilder::_prepend(const void* data, size_t size)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+	_buffer.insert(_buffer.begin(), bytes, bytes + size);
+}
+
+void ArrowFileWriter::_FlatBufferBuilder::_prepend_offset(offset target)
+{
+	_align(sizeof(uint32_t));
+	_prepend<uint32_t>(uint32_t(_buffer.size() + sizeof(uint32_t) - target));
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+#include <stdint.h>
+#include <cstring>
+
+#include "Logger.h"
+#include "StringConverter.h"
+
+/*
+* Writes the Arrow IPC file format (Feather V2), which pyarrow, pandas
+* (read_feather), Polars and DuckDB load without any conversion.
+*
+* Only the column types the exporters need are supported: timestamps and
+* durations in seconds stored as int64, and strings dictionary-encoded with
+* int16 indices. Dictionaries are fixed when the file is opened. Rows are
+* buffered until batch_size rows were added and then written as one record
+* batch, so memory is bounded by the batch size and not by the row count.
+*
+* The flatbuffers metadata is produced by a minimal builder instead of the
+* flatbuffers library, every table is written with all of its fields.
+*/
+
+class ArrowFileWriter
+{
+public:
+	enum class Type
+	{
+		TIMESTAMP,
+		DURATION,
+		DICTIONARY
+	};
+
+	struct Column
+	{
+		std::string name;
+		Type type = Type::TIMESTAMP;
+
+		// Values of a DICTIONARY column, its rows are indices into them
+		std::vector<std::string> dictionary;
+	};
+
+public:
+	ArrowFileWriter(const std::wstring& file_path, const std::vector<Column>& columns, size_t batch_size = 65536);
+	~ArrowFileWriter();
+
+	// Writes the schema and the dictionaries
+	bool open();
+	bool close();
+
+	// Sets a value of the current row, seconds or a dictionary index
+	void set(size_t column, int64_t value);
+	bool end_row();
+
+	uint64_t num_of_rows() const;
+	uint64_t num_of_batches() const;
+	uint64_t num_of_bytes() const;
+
+private:
+	std::wstring _file_path;
+	std::ofstream _file;
+
+	std::vector<Column> _columns;
+	size_t _batch_size;
+
+	// One buffer of _batch_size values per column
+	std::vector<std::vector<uint8_t>> _batch;
+	size_t _rows_in_batch = 0;
+
+	uint64_t _num_of_rows = 0;
+	uint64_t _offset = 0;
+
+	struct _Block
+	{
+		int64_t offset = 0;
+		int32_t metadata_length = 0;
+		int64_t body_length = 0;
+	};
+
+	std::vector<_Block> _dictionary_blocks;
+	std::vector<_Block> _record_batch_blocks;
+
+	static size_t _width(Type type);
+	static size_t _padded(size_t size);
+
+private:
+	bool _write(const void* data, size_t size);
+	bool _write_padding(size_t size);
+
+	struct _BodyBuffer
+	{
+		const void* data = nullptr;
+		size_t size = 0;
+	};
+
+	bool _write_message(const std::vector<uint8_t>& metadata, const std::vector<_BodyBuffer>& body, _Block* block);
+
+	bool _write_schema();
+	bool _write_dictionary(size_t column, int64_t id);
+	bool _write_batch();
+	bool _write_footer();
+
+private:
+	// Builds flatbuffers back to front, offsets count bytes from the end of the buffer
+	class _FlatBufferBuilder
+	{
+	public:
+		using offset = uint32_t;
+
+		offset create_string(std::string_view str);
+		offset create_struct_vector(const std::vector<uint8_t>& elements, uint32_t count, size_t alignment);
+		offset create_offset_vector(const std::vector<offset>& offsets);
+
+		void start_table();
+		offset end_table();
+
+		template <typename T>
+		void add_field(uint16_t field, T value);
+		void add_offset_field(uint16_t field, offset value);
+
+		std::vector<uint8_t> finish(offset root);
+
+	private:
+		std::vector<uint8_t> _buffer;
+		size_t _max_alignment = 1;
+
+		size_t _table_start = 0;
+		std::vector<std::pair<uint16_t, offset>> _fields;
+
+		void _align(size_t alignment, size_t additional = 0);
+		void _prepend(const void* data, size_t size);
+
+		template <typename T>
+		void _prepend(T value);
+		void _prepend_offset(offset target);
+	};
+
+	_FlatBufferBuilder::offset _build_schema(_FlatBufferBuilder& builder) const;
+	_FlatBufferBuilder::offset _build_record_batch(_FlatBufferBuilder& builder, int64_t length, const std::vector<int64_t>& nodes, const std::vector<_BodyBuffer>& body) const;
+	std::vector<uint8_t> _build_message(uint8_t header_type, int64_t body_length, const std::function<_FlatBufferBuilder::offset(_FlatBufferBuilder&)>& build_header) const;
+};
+
+template <typename T>
+void ArrowFileWriter::_FlatBufferBuilder::add_field(uint16_t field, T value)
+{
+	_prepend(value);
+	_fields.emplace_back(field, offset(_buffer.size()));
+}
+
+template <typename T>
+void ArrowFileWriter::_FlatBufferBuilder::_prepend(T value)
+{
+	_align(sizeof(T));
+	_prepend(&value, sizeof(T));
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "ChangeNotifier.h"
+
+std::mutex ChangeNotifier::_mutex{};
+std::condition_variable ChangeNotifier::_changed{};
+
+uint64_t ChangeNotifier::_generation = 0;
+
+uint64_t ChangeNotifier::generation()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _generation;
+}
+
+void ChangeNotifier::notify()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_generation++;
+	}
+
+	_changed.notify_all();
+}
+
+bool ChangeNotifier::wait(uint64_t generation, std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	return _changed.wait_for(lock, timeout, [generation] { return _generation != generation; });
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include <stdint.h>
+
+/*
+* Process-wide signal that a database file was written. Writers call
+* notify() after every change, readers waiting for new data block in wait()
+* instead of polling the file. Any change wakes every waiter, which then
+* checks its own file.
+*
+* Writers in other processes are not seen, so waiters should also recheck
+* their file at an interval.
+*/
+
+class ChangeNotifier
+{
+public:
+	static uint64_t generation();
+
+	static void notify();
+
+	// Returns true if notify() was called since generation was read
+	static bool wait(uint64_t generation, std::chrono::milliseconds timeout);
+
+private:
+	static std::mutex _mutex;
+	static std::condition_variable _changed;
+
+	static uint64_t _generation;
+};
\ No newline at end of file
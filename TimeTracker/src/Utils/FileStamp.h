@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+
+#include <stdint.h>
+
+/*
+* Size and last write time of a file. Readers keep the stamp of the file they
+* parsed and compare it with a fresh one before reusing cached data, which
+* costs a stat instead of a reparse.
+* 
+* Size and time only catch appends reliably. A file that is also rewritten in
+* place, like the domain region of a TTR file, can keep its size, and the
+* write time may not tick between two writes, so such readers stamp the first
+* head_size bytes as well, which have to change with every such rewrite.
+*/
+
+struct FileStamp
+{
+	uintmax_t size = 0;
+	std::filesystem::file_time_type write_time{};
+	std::string head;
+
+	static bool read(const std::wstring& file_path, FileStamp& stamp, size_t head_size = 0)
+	{
+		std::error_code error;
+		std::filesystem::path path(file_path);
+
+		stamp.size = std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return false;
+		}
+
+		stamp.write_time = std::filesystem::last_write_time(path, error);
+		if (error)
+		{
+			return false;
+		}
+
+		stamp.head.clear();
+
+		if (head_size > 0)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			stamp.head.resize(head_size);
+			file.read(stamp.head.data(), std::streamsize(head_size));
+			stamp.head.resize(size_t(file.gcount()));
+		}
+
+		return true;
+	}
+
+	bool operator==(const FileStamp& other) const = default;
+};
\ No newline at end of file
@@ -9,7 +9,9 @@ public:
 
 	static Filter empty()
 	{
-		return Filter([](T...) { return true; });
+		Filter filter([](T...) { return true; });
+		filter._is_empty = true;
+		return filter;
 	}
 
 	static Filter create(FilterFunction filter)
@@ -27,6 +29,13 @@ public:
 		return _filter(args...);
 	}
 
+	// True if the filter accepts everything, so callers can skip filtering
+	bool is_empty() const
+	{
+		return _is_empty;
+	}
+
 private:
 	FilterFunction _filter;
+	bool _is_empty = false;
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <version>
+
+/*
+* std::format is not available in every standard library the core is built
+* with (libstdc++ before 13). Code formats through the Format namespace,
+* which resolves to <format> when present and to the fmt library otherwise.
+*/
+
+#if defined(__cpp_lib_format)
+
+#include <format>
+
+namespace Format
+{
+	using std::format;
+	using std::vformat;
+	using std::make_format_args;
+}
+
+#else
+
+#include <fmt/format.h>
+
+namespace Format
+{
+	using fmt::format;
+	using fmt::vformat;
+	using fmt::make_format_args;
+}
+
+#endif
\ No newline at end of file
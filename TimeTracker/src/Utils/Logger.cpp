@@ -1,4 +1,5 @@
 #include "Logger.h"
+#include "Platform.h"
 
 LogLevel Logger::_log_level = LogLevel::LOG_INFO;
 
@@ -40,10 +41,31 @@ std::string Logger::_get_time_stamp()
 	time(&raw_time);
 
 	std::tm time_info;
-	localtime_s(&time_info, &raw_time);
+	Platform::local_time(raw_time, time_info);
 
 	char buffer[80];
 	strftime(buffer, sizeof(buffer), "(%Y-%m-%d %H:%M:%S)", &time_info);
 
 	return std::string(buffer);
+}
+
+void Logger::_count_message(LogLevel level)
+{
+	// Counted before the log level is applied, so warnings stay visible when they are not written
+	static Metrics::Counter& info_messages = Metrics::counter("timetracker_log_messages_total", "Log messages by level", "level=\"info\"");
+	static Metrics::Counter& warning_messages = Metrics::counter("timetracker_log_messages_total", "Log messages by level", "level=\"warning\"");
+	static Metrics::Counter& error_messages = Metrics::counter("timetracker_log_messages_total", "Log messages by level", "level=\"error\"");
+
+	switch (level)
+	{
+	case LogLevel::LOG_INFO:
+		info_messages.increment();
+		break;
+	case LogLevel::LOG_WARNING:
+		warning_messages.increment();
+		break;
+	case LogLevel::LOG_ERROR:
+		error_messages.increment();
+		break;
+	}
 }
\ No newline at end of file
@@ -4,11 +4,14 @@
 #include <fstream>
 #include <filesystem>
 #include <string>
-#include <format>
 #include <mutex>
 
 #include <time.h>
 
+#include "Format.h"
+#include "Metrics.h"
+#include "Trace.h"
+
 #ifdef _DEBUG
 #define DEBUG_LOG(x) std::cout << x
 #define DEBUG_LOG_LINE(x) std::cout << x << std::endl
@@ -55,15 +58,21 @@ private:
 
 private:
 	static std::string _get_time_stamp();
+
+	static void _count_message(LogLevel level);
 };
 
 
 template <typename... Args>
 void Logger::log(LogLevel level, const std::string& message, Args&&... args)
 {
+	TRACE_SPAN("Logger::log");
+
 	std::unique_lock<std::mutex> lock(_mutex);
 
-	std::string formatted_message = std::vformat(message, std::make_format_args(args...));
+	_count_message(level);
+
+	std::string formatted_message = Format::vformat(message, Format::make_format_args(args...));
 
 	std::string log_level_string;
 	switch (level)
@@ -104,7 +113,7 @@ void Logger::log(LogLevel level, const std::string& message, Args&&... args)
 			std::filesystem::create_directories(std::filesystem::path(_file_path).parent_path());
 		}
 
-		std::ofstream file(_file_path, std::ios::app);
+		std::ofstream file(std::filesystem::path(_file_path), std::ios::app);
 		if (file.is_open())
 		{
 			file << log_message << std::endl;
@@ -134,14 +143,14 @@ void Logger::log_error(const std::string& message, Args&&... args)
 template <typename... Args>
 void Logger::append_info(const std::string& message, Args&&... args)
 {
-	std::string formatted_message = std::vformat(message, std::make_format_args(args...));
+	std::string formatted_message = Format::vformat(message, Format::make_format_args(args...));
 	std::string line = std::string(25, ' ') + "- " + formatted_message;
 
 	DEBUG_LOG_LINE(line);
 
 	if (!_file_path.empty())
 	{
-		std::ofstream file(_file_path, std::ios::app);
+		std::ofstream file(std::filesystem::path(_file_path), std::ios::app);
 		if (file.is_open())
 		{
 			file << line << std::endl;
@@ -0,0 +1,173 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#else
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif
+
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::is_open() const
+{
+	return _is_open;
+}
+
+const char* MappedFile::data() const
+{
+	return _data;
+}
+
+size_t MappedFile::size() const
+{
+	return _size;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::wstring& file_path)
+{
+	close();
+
+	HANDLE file = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	_file = file;
+	_size = size_t(size.QuadPart);
+	_is_open = true;
+
+	// Empty files cannot be mapped, but are still valid
+	if (_size == 0)
+	{
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mapping == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	_mapping = mapping;
+	_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (_data == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (_data != nullptr)
+	{
+		UnmapViewOfFile(_data);
+	}
+
+	if (_mapping != nullptr)
+	{
+		CloseHandle(_mapping);
+	}
+
+	if (_file != nullptr)
+	{
+		CloseHandle(_file);
+	}
+
+	_data = nullptr;
+	_mapping = nullptr;
+	_file = nullptr;
+	_size = 0;
+	_is_open = false;
+}
+
+#else
+
+bool MappedFile::open(const std::wstring& file_path)
+{
+	close();
+
+	int file = ::open(std::filesystem::path(file_path).c_str(), O_RDONLY);
+
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	_size = size_t(status.st_size);
+	_is_open = true;
+
+	// Empty files cannot be mapped, but are still valid
+	if (_size == 0)
+	{
+		::close(file);
+		return true;
+	}
+
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, file, 0);
+
+	// The mapping keeps its own reference to the file
+	::close(file);
+
+	if (data == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	_data = static_cast<const char*>(data);
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (_data != nullptr)
+	{
+		munmap(const_cast<char*>(_data), _size);
+	}
+
+	_data = nullptr;
+	_size = 0;
+	_is_open = false;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <filesystem>
+
+#include <cstddef>
+
+/*
+* Read-only memory mapping of a whole file. The mapping reflects the file
+* size at open(); bytes appended later are only visible after reopening.
+*/
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::wstring& file_path);
+	void close();
+
+	bool is_open() const;
+
+	const char* data() const;
+	size_t size() const;
+
+private:
+	bool _is_open = false;
+
+	const char* _data = nullptr;
+	size_t _size = 0;
+
+#ifdef _WIN32
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "Metrics.h"
+
+#include "Format.h"
+
+size_t Metrics::_shard()
+{
+	static std::atomic<size_t> next_shard{ 0 };
+	thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % _num_of_shards;
+
+	return shard;
+}
+
+void Metrics::Counter::increment(uint64_t n)
+{
+	_shards[_shard()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::Counter::value() const
+{
+	uint64_t value = 0;
+
+	for (const _PaddedCounter& shard : _shards)
+	{
+		value += shard.value.load(std::memory_order_relaxed);
+	}
+
+	return value;
+}
+
+void Metrics::Gauge::set(int64_t value)
+{
+	_value.store(value, std::memory_order_relaxed);
+}
+
+void Metrics::Gauge::add(int64_t n)
+{
+	_value.fetch_add(n, std::memory_order_relaxed);
+}
+
+int64_t Metrics::Gauge::value() const
+{
+	return _value.load(std::memory_order_relaxed);
+}
+
+Metrics::Histogram::Histogram()
+	: _shards(new _Shard[_num_of_shards])
+{
+	for (size_t i = 0; i < _num_of_shards; i++)
+	{
+		for (std::atomic<uint64_t>& bucket : _shards[i].buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void Metrics::Histogram::record(uint64_t value)
+{
+	_Shard& shard = _shards[_shard()];
+
+	shard.buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+	shard.count.fetch_add(1, std::memory_order_relaxed);
+	shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Metrics::Histogram::snapshot(Snapshot& snapshot) const
+{
+	snapshot = Snapshot();
+
+	for (size_t i = 0; i < _num_of_shards; i++)
+	{
+		for (size_t j = 0; j < num_of_buckets; j++)
+		{
+			snapshot.buckets[j] += _shards[i].buckets[j].load(std::memory_order_relaxed);
+		}
+
+		snapshot.count += _shards[i].count.load(std::memory_order_relaxed);
+		snapshot.sum += _shards[i].sum.load(std::memory_order_relaxed);
+	}
+}
+
+size_t Metrics::Histogram::bucket(uint64_t value)
+{
+	// Values below sub_buckets get one bucket each
+	if (value < sub_buckets)
+	{
+		return size_t(value);
+	}
+
+	size_t exponent = 63;
+	while ((value >> exponent) == 0)
+	{
+		exponent--;
+	}
+
+	size_t sub_bucket = size_t(value >> (exponent - 3)) & (sub_buckets - 1);
+
+	return (exponent - 2) * sub_buckets + sub_bucket;
+}
+
+uint64_t Metrics::Histogram::bucket_upper_bound(size_t bucket)
+{
+	if (bucket < sub_buckets)
+	{
+		return bucket;
+	}
+
+	size_t exponent = bucket / sub_buckets + 2;
+	uint64_t sub_bucket = bucket % sub_buckets;
+
+	uint64_t lower_bound = (sub_buckets + sub_bucket) << (exponent - 3);
+	uint64_t width = uint64_t(1) << (exponent - 3);
+
+	return lower_bound + (width - 1);
+}
+
+Metrics::Timer::Timer(Histogram& histogram)
+	: _histogram(histogram), _start(std::chrono::steady_clock::now())
+{
+}
+
+Metrics::Timer::~Timer()
+{
+	auto elapsed = std::chrono::steady_clock::now() - _start;
+	_histogram.record(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+Metrics::Counter& Metrics::counter(std::string_view name, std::string_view help, std::string_view labels)
+{
+	_Registry& registry = _registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	std::unique_ptr<Counter>& counter = _family(registry, name, help, _Type::COUNTER).counters[std::string(labels)];
+	if (!counter)
+	{
+		counter = std::make_unique<Counter>();
+	}
+
+	return *counter;
+}
+
+Metrics::Gauge& Metrics::gauge(std::string_view name, std::string_view help, std::string_view labels)
+{
+	_Registry& registry = _registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	std::unique_ptr<Gauge>& gauge = _family(registry, name, help, _Type::GAUGE).gauges[std::string(labels)];
+	if (!gauge)
+	{
+		gauge = std::make_unique<Gauge>();
+	}
+
+	return *gauge;
+}
+
+Metrics::Histogram& Metrics::histogram(std::string_view name, std::string_view help, double scale)
+{
+	_Registry& registry = _registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	_Family& family = _family(registry, name, help, _Type::HISTOGRAM);
+	family.scale = scale;
+
+	std::unique_ptr<Histogram>& histogram = family.histograms[""];
+	if (!histogram)
+	{
+		histogram = std::make_unique<Histogram>();
+	}
+
+	return *histogram;
+}
+
+std::string Metrics::to_text()
+{
+	_Registry& registry = _registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	std::string text;
+
+	Histogram::Snapshot snapshot;
+
+	for (const auto& [name, family] : registry.families)
+	{
+		const char* type = family.type == _Type::COUNTER ? "counter" : family.type == _Type::GAUGE ? "gauge" : "histogram";
+
+		text += Format::format("# HELP {} {}\n# TYPE {} {}\n", name, family.help, name, type);
+
+		for (const auto& [labels, counter] : family.counters)
+		{
+			text += labels.empty() ? Format::format("{} {}\n", name, counter->value()) : Format::format("{}{{{}}} {}\n", name, labels, counter->value());
+		}
+
+		for (const auto& [labels, gauge] : family.gauges)
+		{
+			text += labels.empty() ? Format::format("{} {}\n", name, gauge->value()) : Format::format("{}{{{}}} {}\n", name, labels, gauge->value());
+		}
+
+		for (const auto& [labels, histogram] : family.histograms)
+		{
+			histogram->snapshot(snapshot);
+
+			// Only the powers of two are exported, the buckets between them are folded into the next one.
+			// The same boundaries on every scrape keep the series of a histogram stable
+			uint64_t cumulative = 0;
+			for (size_t i = 0; i < Histogram::num_of_buckets; i++)
+			{
+				cumulative += snapshot.buckets[i];
+
+				// The last bucket ends at the largest value, which is the +Inf boundary
+				uint64_t upper_bound = Histogram::bucket_upper_bound(i);
+				if (((upper_bound + 1) & upper_bound) != 0 || upper_bound == UINT64_MAX)
+				{
+					continue;
+				}
+
+				text += Format::format("{}_bucket{{le=\"{:.9g}\"}} {}\n", name, upper_bound * family.scale, cumulative);
+			}
+
+			text += Format::format("{}_bucket{{le=\"+Inf\"}} {}\n", name, snapshot.count);
+			text += Format::format("{}_sum {:.9g}\n", name, snapshot.sum * family.scale);
+			text += Format::format("{}_count {}\n", name, snapshot.count);
+		}
+	}
+
+	return text;
+}
+
+Metrics::_Registry& Metrics::_registry()
+{
+	static _Registry registry;
+	return registry;
+}
+
+Metrics::_Family& Metrics::_family(_Registry& registry, std::string_view name, std::string_view help, _Type type)
+{
+	auto it = registry.families.find(name);
+	if (it == registry.families.end())
+	{
+		it = registry.families.emplace(std::string(name), _Family()).first;
+		it->second.help = help;
+		it->second.type = type;
+	}
+
+	return it->second;
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <stdint.h>
+
+/*
+* Process-wide counters, gauges and latency histograms, exported in the
+* Prometheus text format.
+*
+* Counters and histograms are sharded: every thread writes to its own cache
+* line and the shards are only summed on export, so instrumenting a hot path
+* costs one uncontended atomic add. Histograms are log-linear, every power of
+* two is split into 8 linear buckets, which bounds the relative error of a
+* recorded value to 12.5%. The text format only exports a boundary per power
+* of two, which keeps the number of series of every histogram small.
+*
+* Metrics are registered once, usually into a static reference, and live
+* until the process exits. Registering the same name and labels again
+* returns the existing metric.
+*/
+
+class Metrics
+{
+private:
+	static constexpr size_t _num_of_shards = 16;
+
+	static size_t _shard();
+
+	struct alignas(64) _PaddedCounter
+	{
+		std::atomic<uint64_t> value{ 0 };
+	};
+
+public:
+	class Counter
+	{
+	public:
+		void increment(uint64_t n = 1);
+
+		uint64_t value() const;
+
+	private:
+		_PaddedCounter _shards[_num_of_shards];
+	};
+
+	class Gauge
+	{
+	public:
+		void set(int64_t value);
+		void add(int64_t n);
+
+		int64_t value() const;
+
+	private:
+		std::atomic<int64_t> _value{ 0 };
+	};
+
+	class Histogram
+	{
+	public:
+		static constexpr size_t sub_buckets = 8;
+		static constexpr size_t num_of_buckets = (64 - 2) * sub_buckets;
+
+		Histogram();
+
+		void record(uint64_t value);
+
+		struct Snapshot
+		{
+			uint64_t buckets[num_of_buckets] = { 0 };
+
+			uint64_t count = 0;
+			uint64_t sum = 0;
+		};
+
+		void snapshot(Snapshot& snapshot) const;
+
+		static size_t bucket(uint64_t value);
+		static uint64_t bucket_upper_bound(size_t bucket);
+
+	private:
+		struct alignas(64) _Shard
+		{
+			std::atomic<uint64_t> buckets[num_of_buckets];
+
+			std::atomic<uint64_t> count{ 0 };
+			std::atomic<uint64_t> sum{ 0 };
+		};
+
+		std::unique_ptr<_Shard[]> _shards;
+	};
+
+	// Records the lifetime of the object in nanoseconds
+	class Timer
+	{
+	public:
+		Timer(Histogram& histogram);
+		~Timer();
+
+	private:
+		Histogram& _histogram;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+public:
+	// labels are in exposition format, e.g. level="error"
+	static Counter& counter(std::string_view name, std::string_view help, std::string_view labels = "");
+	static Gauge& gauge(std::string_view name, std::string_view help, std::string_view labels = "");
+
+	// Recorded values are multiplied by scale on export, 1e-9 exports nanoseconds as seconds
+	static Histogram& histogram(std::string_view name, std::string_view help, double scale = 1.0);
+
+	static std::string to_text();
+
+private:
+	enum class _Type
+	{
+		COUNTER,
+		GAUGE,
+		HISTOGRAM
+	};
+
+	struct _Family
+	{
+		std::string help;
+		_Type type = _Type::COUNTER;
+		double scale = 1.0;
+
+		std::map<std::string, std::unique_ptr<Counter>> counters;
+		std::map<std::string, std::unique_ptr<Gauge>> gauges;
+		std::map<std::string, std::unique_ptr<Histogram>> histograms;
+	};
+
+	struct _Registry
+	{
+		std::mutex mutex;
+		std::map<std::string, _Family, std::less<>> families;
+	};
+
+	// Metrics are registered from static initializers in other translation units
+	static _Registry& _registry();
+
+	static _Family& _family(_Registry& registry, std::string_view name, std::string_view help, _Type type);
+};
\ No newline at end of file
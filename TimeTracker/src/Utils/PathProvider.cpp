@@ -1,8 +1,8 @@
 #include "PathProvider.h"
 
-std::wstring PathProvider::_file_paths[3] = { L"", L"", L"" };
+std::wstring PathProvider::_file_paths[4] = { L"", L"", L"", L"" };
 
-bool PathProvider::_has_been_set[3] = { false, false, false };
+bool PathProvider::_has_been_set[4] = { false, false, false, false };
 
 std::mutex PathProvider::_mutex;
 
@@ -24,6 +24,12 @@ std::wstring PathProvider::tte_file_path()
 	return PathProvider::_file_paths[_get_type_index(FileType::TTE)];
 }
 
+std::wstring PathProvider::manifest_file_path()
+{
+	std::lock_guard<std::mutex> lock(PathProvider::_mutex);
+	return PathProvider::_file_paths[_get_type_index(FileType::MANIFEST)];
+}
+
 bool PathProvider::set_file_path(const std::wstring& file_path, FileType file_type)
 {
 	std::lock_guard<std::mutex> lock(PathProvider::_mutex);
@@ -67,55 +73,51 @@ bool PathProvider::use_default_location(DefaultLocation location, FileType file_
 		return false;
 	}
 
-	std::wstring path;
-
-	KNOWNFOLDERID folder_id;
+	Platform::Folder folder;
 
 	switch (location)
 	{
 		case DefaultLocation::APPDATA:
-			folder_id = FOLDERID_RoamingAppData;
+			folder = Platform::Folder::APPDATA;
 			break;
 		case DefaultLocation::DESKTOP:
-			folder_id = FOLDERID_Desktop;
+			folder = Platform::Folder::DESKTOP;
 			break;
 		default:
 			Logger::log_error("Invalid default location");
 			return false;
 	}
 
-	wchar_t* path_ptr;
+	std::filesystem::path path;
 
-	if (SHGetKnownFolderPath(folder_id, 0, NULL, &path_ptr) != S_OK)
+	if (!Platform::known_folder(folder, path))
 	{
 		Logger::log_error("Failed to get default path");
 		return false;
 	}
 
-	std::wstringstream ss;
-	ss << path_ptr << L"\\TimeTracker\\";
-
-	path = ss.str();
-
-	CoTaskMemFree(path_ptr);
+	path /= L"TimeTracker";
 
 	switch (file_type)
 	{
 		case FileType::LOG:
-			path += L"TimeTracker.log";
+			path /= L"TimeTracker.log";
 			break;
 		case FileType::TTR:
-			path += L"TimeTracker.ttr";
+			path /= L"TimeTracker.ttr";
 			break;
 		case FileType::TTE:
-			path += L"TimeTracker.tte";
+			path /= L"TimeTracker.tte";
+			break;
+		case FileType::MANIFEST:
+			path /= L"TimeTracker.ttm";
 			break;
 		default:
 			Logger::log_error("Invalid file type");
 			return false;
 	}
 
-	PathProvider::_file_paths[index] = path;
+	PathProvider::_file_paths[index] = path.wstring();
 	_has_been_set[index] = true;
 
 	return true;
@@ -131,6 +133,8 @@ int PathProvider::_get_type_index(FileType path_type)
 			return 1;
 		case FileType::TTE:
 			return 2;
+		case FileType::MANIFEST:
+			return 3;
 		default:
 			return -1;
 	}
@@ -2,13 +2,10 @@
 
 #include <string>
 #include <mutex>
-#include <sstream>
-
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
-#include <shlobj_core.h>
+#include <filesystem>
 
 #include "Logger.h"
+#include "Platform.h"
 
 class PathProvider
 {
@@ -17,12 +14,16 @@ public:
 	static std::wstring ttr_file_path();
 	static std::wstring tte_file_path();
 
+	// Empty unless set explicitly, the database then keeps all events in the single TTE file
+	static std::wstring manifest_file_path();
+
 public:
 	enum class FileType
 	{
 		LOG,
 		TTR,
-		TTE
+		TTE,
+		MANIFEST
 	};
 
 	enum class DefaultLocation
@@ -32,15 +33,16 @@ public:
 	};
 
 public:
+	// Sets LOG, TTR and TTE, segmentation stays off until MANIFEST is set on its own
 	static bool use_default_location(DefaultLocation location);
 
 	static bool set_file_path(const std::wstring& file_path, FileType file_type);
 	static bool use_default_location(DefaultLocation location, FileType file_type);
 
 private:
-	static std::wstring _file_paths[3]; // [LOG, TTR, TTE]
+	static std::wstring _file_paths[4]; // [LOG, TTR, TTE, MANIFEST]
 
-	static bool _has_been_set[3]; // [LOG, TTR, TTE]
+	static bool _has_been_set[4]; // [LOG, TTR, TTE, MANIFEST]
 
 	static std::mutex _mutex;
 
@@ -0,0 +1,251 @@
+#include "Platform.h"
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <shlobj_core.h>
+
+bool Platform::known_folder(Folder folder, std::filesystem::path& path)
+{
+	KNOWNFOLDERID folder_id;
+
+	switch (folder)
+	{
+		case Folder::APPDATA:
+			folder_id = FOLDERID_RoamingAppData;
+			break;
+		case Folder::DESKTOP:
+			folder_id = FOLDERID_Desktop;
+			break;
+		default:
+			return false;
+	}
+
+	wchar_t* path_ptr;
+
+	if (SHGetKnownFolderPath(folder_id, 0, NULL, &path_ptr) != S_OK)
+	{
+		return false;
+	}
+
+	path = path_ptr;
+
+	CoTaskMemFree(path_ptr);
+
+	return true;
+}
+
+bool Platform::local_time(std::time_t time, std::tm& result)
+{
+	return localtime_s(&result, &time) == 0;
+}
+
+std::string Platform::error_message(int error)
+{
+	char error_buffer[256];
+	strerror_s(error_buffer, sizeof(error_buffer), error);
+
+	return std::string(error_buffer);
+}
+
+std::string Platform::to_utf8(const std::wstring& str)
+{
+	UINT code_page = CP_UTF8;
+	int flags = 0;
+
+	int size = WideCharToMultiByte(code_page, flags, str.c_str(), str.size(), nullptr, 0, nullptr, nullptr);
+
+	std::string result(size, 0);
+
+	WideCharToMultiByte(code_page, flags, str.c_str(), str.size(), result.data(), size, nullptr, nullptr);
+
+	return result;
+}
+
+std::wstring Platform::to_wide(const std::string& str)
+{
+	UINT code_page = CP_UTF8;
+	int flags = 0;
+
+	int size = MultiByteToWideChar(code_page, flags, str.c_str(), str.size(), nullptr, 0);
+
+	std::wstring result(size, 0);
+
+	MultiByteToWideChar(code_page, flags, str.c_str(), str.size(), result.data(), size);
+
+	return result;
+}
+
+#else
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+bool Platform::known_folder(Folder folder, std::filesystem::path& path)
+{
+	const char* home = std::getenv("HOME");
+
+	switch (folder)
+	{
+		case Folder::APPDATA:
+		{
+			const char* data_home = std::getenv("XDG_DATA_HOME");
+			if (data_home != nullptr && data_home[0] != '\0')
+			{
+				path = data_home;
+				return true;
+			}
+
+			if (home == nullptr)
+				return false;
+
+			path = std::filesystem::path(home) / ".local" / "share";
+			return true;
+		}
+		case Folder::DESKTOP:
+			if (home == nullptr)
+				return false;
+
+			path = std::filesystem::path(home) / "Desktop";
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool Platform::local_time(std::time_t time, std::tm& result)
+{
+	return localtime_r(&time, &result) != nullptr;
+}
+
+std::string Platform::error_message(int error)
+{
+	char error_buffer[256];
+
+	// GNU strerror_r may return a static string instead of filling the buffer
+	auto result = strerror_r(error, error_buffer, sizeof(error_buffer));
+
+	if constexpr (std::is_same_v<decltype(result), char*>)
+		return std::string(result);
+	else
+		return result == 0 ? std::string(error_buffer) : std::string("Unknown error");
+}
+
+// wchar_t holds UTF-32 code points on POSIX systems
+
+std::string Platform::to_utf8(const std::wstring& str)
+{
+	std::string result;
+	result.reserve(str.size());
+
+	for (wchar_t c : str)
+	{
+		uint32_t code_point = static_cast<uint32_t>(c);
+
+		if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+			code_point = 0xFFFD;
+
+		if (code_point < 0x80)
+		{
+			result += static_cast<char>(code_point);
+		}
+		else if (code_point < 0x800)
+		{
+			result += static_cast<char>(0xC0 | (code_point >> 6));
+			result += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x10000)
+		{
+			result += static_cast<char>(0xE0 | (code_point >> 12));
+			result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			result += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			result += static_cast<char>(0xF0 | (code_point >> 18));
+			result += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+			result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			result += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+	}
+
+	return result;
+}
+
+std::wstring Platform::to_wide(const std::string& str)
+{
+	std::wstring result;
+	result.reserve(str.size());
+
+	size_t i = 0;
+	while (i < str.size())
+	{
+		uint8_t lead = static_cast<uint8_t>(str[i]);
+
+		size_t length;
+		uint32_t code_point;
+
+		if (lead < 0x80)
+		{
+			length = 1;
+			code_point = lead;
+		}
+		else if ((lead & 0xE0) == 0xC0)
+		{
+			length = 2;
+			code_point = lead & 0x1F;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			length = 3;
+			code_point = lead & 0x0F;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			length = 4;
+			code_point = lead & 0x07;
+		}
+		else
+		{
+			result += static_cast<wchar_t>(0xFFFD);
+			i++;
+			continue;
+		}
+
+		if (i + length > str.size())
+		{
+			result += static_cast<wchar_t>(0xFFFD);
+			break;
+		}
+
+		bool valid = true;
+		for (size_t j = 1; j < length; j++)
+		{
+			uint8_t continuation = static_cast<uint8_t>(str[i + j]);
+			if ((continuation & 0xC0) != 0x80)
+			{
+				valid = false;
+				break;
+			}
+
+			code_point = (code_point << 6) | (continuation & 0x3F);
+		}
+
+		if (!valid)
+		{
+			result += static_cast<wchar_t>(0xFFFD);
+			i++;
+			continue;
+		}
+
+		result += static_cast<wchar_t>(code_point);
+		i += length;
+	}
+
+	return result;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <filesystem>
+
+#include <ctime>
+
+/*
+* Thin wrapper around the few operating system services the core needs.
+* Everything else in Database, TTEFile, TTRFile and Utils is standard C++,
+* so this is the only translation unit that differs between Windows and
+* POSIX builds.
+*/
+
+class Platform
+{
+public:
+	enum class Folder
+	{
+		APPDATA,
+		DESKTOP
+	};
+
+	static bool known_folder(Folder folder, std::filesystem::path& path);
+
+public:
+	static bool local_time(std::time_t time, std::tm& result);
+
+	static std::string error_message(int error);
+
+public:
+	static std::string to_utf8(const std::wstring& str);
+	static std::wstring to_wide(const std::string& str);
+};
\ No newline at end of file
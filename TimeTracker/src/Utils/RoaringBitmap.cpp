@@ -0,0 +1,335 @@
+#include "RoaringBitmap.h"
+
+void RoaringBitmap::add(value_type value)
+{
+	if (_container == _Container::RUN)
+	{
+		_to_bitset();
+	}
+
+	if (_container == _Container::BITSET)
+	{
+		uint64_t& word = _bits[value / 64];
+		uint64_t bit = uint64_t(1) << (value % 64);
+
+		_cardinality += (word & bit) == 0 ? 1 : 0;
+		word |= bit;
+		return;
+	}
+
+	if (_values.empty() || value > _values.back())
+	{
+		_values.push_back(value);
+	}
+	else
+	{
+		auto it = std::lower_bound(_values.begin(), _values.end(), value);
+		if (*it == value)
+		{
+			return;
+		}
+
+		_values.insert(it, value);
+	}
+
+	_cardinality++;
+
+	if (_values.size() > _max_array_size)
+	{
+		_to_bitset();
+	}
+}
+
+bool RoaringBitmap::contains(value_type value) const
+{
+	switch (_container)
+	{
+	case _Container::ARRAY:
+		return std::binary_search(_values.begin(), _values.end(), value);
+	case _Container::BITSET:
+		return (_bits[value / 64] >> (value % 64)) & 1;
+	case _Container::RUN:
+	{
+		// Last run starting at or before the value
+		size_t low = 0, high = _values.size() / 2;
+		while (low < high)
+		{
+			size_t middle = (low + high) / 2;
+
+			if (_values[2 * middle] <= value)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		return low > 0 && value - _values[2 * (low - 1)] <= _values[2 * (low - 1) + 1];
+	}
+	}
+
+	return false;
+}
+
+uint32_t RoaringBitmap::cardinality() const
+{
+	return _cardinality;
+}
+
+bool RoaringBitmap::empty() const
+{
+	return _cardinality == 0;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other)
+{
+	if (other.empty())
+	{
+		return *this;
+	}
+
+	if (_container == _Container::ARRAY && other._container == _Container::ARRAY
+		&& _values.size() + other._values.size() <= _max_array_size)
+	{
+		std::vector<value_type> values;
+		values.reserve(_values.size() + other._values.size());
+
+		std::set_union(_values.begin(), _values.end(), other._values.begin(), other._values.end(), std::back_inserter(values));
+
+		_values = std::move(values);
+		_cardinality = uint32_t(_values.size());
+		return *this;
+	}
+
+	_to_bitset();
+
+	if (other._container == _Container::BITSET)
+	{
+		for (size_t i = 0; i < _num_of_words; i++)
+		{
+			_bits[i] |= other._bits[i];
+		}
+
+		_cardinality = 0;
+		for (uint64_t word : _bits)
+		{
+			_cardinality += uint32_t(std::popcount(word));
+		}
+	}
+	else
+	{
+		for (value_type value : other.values())
+		{
+			add(value);
+		}
+	}
+
+	return *this;
+}
+
+void RoaringBitmap::optimize()
+{
+	size_t array_size = _array_size_in_bytes();
+	size_t run_size = _run_size_in_bytes();
+	size_t bitset_size = sizeof(uint64_t) * _num_of_words;
+
+	_Container best = _Container::BITSET;
+	if (array_size <= bitset_size && array_size <= run_size && _cardinality <= _max_array_size)
+		best = _Container::ARRAY;
+	else if (run_size < bitset_size)
+		best = _Container::RUN;
+
+	if (best == _container)
+	{
+		return;
+	}
+
+	std::vector<value_type> values = this->values();
+
+	_values.clear();
+	_bits.clear();
+	_bits.shrink_to_fit();
+
+	_container = best;
+
+	if (best == _Container::ARRAY)
+	{
+		_values = std::move(values);
+	}
+	else if (best == _Container::RUN)
+	{
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			if (i > 0 && values[i] == values[i - 1] + 1)
+			{
+				_values.back()++;
+			}
+			else
+			{
+				_values.push_back(values[i]);
+				_values.push_back(0);
+			}
+		}
+	}
+	else
+	{
+		_bits.assign(_num_of_words, 0);
+
+		for (value_type value : values)
+		{
+			_bits[value / 64] |= uint64_t(1) << (value % 64);
+		}
+	}
+
+	_values.shrink_to_fit();
+}
+
+std::vector<RoaringBitmap::value_type> RoaringBitmap::values() const
+{
+	std::vector<value_type> values;
+	values.reserve(_cardinality);
+
+	switch (_container)
+	{
+	case _Container::ARRAY:
+		values = _values;
+		break;
+	case _Container::BITSET:
+		for (size_t i = 0; i < _num_of_words; i++)
+		{
+			for (uint64_t word = _bits[i]; word != 0; word &= word - 1)
+			{
+				values.push_back(value_type(i * 64 + std::countr_zero(word)));
+			}
+		}
+		break;
+	case _Container::RUN:
+		for (size_t i = 0; i + 1 < _values.size(); i += 2)
+		{
+			for (uint32_t value = _values[i]; value <= uint32_t(_values[i]) + _values[i + 1]; value++)
+			{
+				values.push_back(value_type(value));
+			}
+		}
+		break;
+	}
+
+	return values;
+}
+
+size_t RoaringBitmap::size_in_bytes() const
+{
+	return _values.capacity() * sizeof(value_type) + _bits.capacity() * sizeof(uint64_t);
+}
+
+bool RoaringBitmap::write(std::ostream& stream) const
+{
+	uint8_t container = uint8_t(_container);
+	stream.write(reinterpret_cast<const char*>(&container), sizeof(container));
+	stream.write(reinterpret_cast<const char*>(&_cardinality), sizeof(_cardinality));
+
+	if (_container == _Container::BITSET)
+	{
+		stream.write(reinterpret_cast<const char*>(_bits.data()), _bits.size() * sizeof(uint64_t));
+	}
+	else
+	{
+		// An array holds at most 4096 values and there are at most 32768 runs
+		uint16_t size = uint16_t(_container == _Container::RUN ? _values.size() / 2 : _values.size());
+		stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		stream.write(reinterpret_cast<const char*>(_values.data()), _values.size() * sizeof(value_type));
+	}
+
+	return bool(stream);
+}
+
+bool RoaringBitmap::read(std::istream& stream)
+{
+	uint8_t container = 0;
+	stream.read(reinterpret_cast<char*>(&container), sizeof(container));
+	stream.read(reinterpret_cast<char*>(&_cardinality), sizeof(_cardinality));
+
+	if (!stream || container > uint8_t(_Container::RUN))
+	{
+		return false;
+	}
+
+	_container = _Container(container);
+	_values.clear();
+	_bits.clear();
+
+	if (_container == _Container::BITSET)
+	{
+		_bits.resize(_num_of_words);
+		stream.read(reinterpret_cast<char*>(_bits.data()), _bits.size() * sizeof(uint64_t));
+	}
+	else
+	{
+		uint16_t size = 0;
+		stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+		_values.resize(_container == _Container::RUN ? size_t(size) * 2 : size_t(size));
+		stream.read(reinterpret_cast<char*>(_values.data()), _values.size() * sizeof(value_type));
+	}
+
+	return bool(stream);
+}
+
+void RoaringBitmap::_to_bitset()
+{
+	if (_container == _Container::BITSET)
+	{
+		return;
+	}
+
+	std::vector<value_type> values = this->values();
+
+	_bits.assign(_num_of_words, 0);
+
+	for (value_type value : values)
+	{
+		_bits[value / 64] |= uint64_t(1) << (value % 64);
+	}
+
+	_values.clear();
+	_values.shrink_to_fit();
+
+	_container = _Container::BITSET;
+}
+
+size_t RoaringBitmap::_array_size_in_bytes() const
+{
+	return sizeof(uint16_t) + _cardinality * sizeof(value_type);
+}
+
+size_t RoaringBitmap::_run_size_in_bytes() const
+{
+	return sizeof(uint16_t) + _num_of_runs() * 2 * sizeof(value_type);
+}
+
+size_t RoaringBitmap::_num_of_runs() const
+{
+	if (_container == _Container::RUN)
+	{
+		return _values.size() / 2;
+	}
+
+	size_t runs = 0;
+
+	if (_container == _Container::ARRAY)
+	{
+		for (size_t i = 0; i < _values.size(); i++)
+		{
+			runs += i == 0 || _values[i] != _values[i - 1] + 1 ? 1 : 0;
+		}
+
+		return runs;
+	}
+
+	// A run starts at every set bit whose predecessor is clear
+	for (size_t i = 0; i < _num_of_words; i++)
+	{
+		uint64_t previous = (_bits[i] << 1) | (i > 0 ? _bits[i - 1] >> 63 : 0);
+		runs += size_t(std::popcount(_bits[i] & ~previous));
+	}
+
+	return runs;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <bit>
+#include <iterator>
+
+#include <stdint.h>
+
+/*
+* Compressed set of 16-bit values, one container of a Roaring bitmap.
+*
+* Sparse sets are kept as a sorted array, dense ones as a 65536 bit set, and
+* optimize() switches to runs of consecutive values when those are smaller,
+* which suits values like date block indices that mostly come in streaks.
+* Values can be added in any order, appending in ascending order is O(1).
+*
+* Serialized form:
+*   - uint8    container     0 array, 1 bit set, 2 runs
+*   - uint32   cardinality
+*   - uint16   size          values or runs, absent for bit sets
+*   - ...                    the values, (start, length - 1) per run, or 1024 uint64 words
+*/
+
+class RoaringBitmap
+{
+public:
+	using value_type = uint16_t;
+
+public:
+	void add(value_type value);
+	bool contains(value_type value) const;
+
+	uint32_t cardinality() const;
+	bool empty() const;
+
+	RoaringBitmap& operator|=(const RoaringBitmap& other);
+
+	// Converts to the container that is smallest for the current values
+	void optimize();
+
+	std::vector<value_type> values() const;
+
+	size_t size_in_bytes() const;
+
+	bool write(std::ostream& stream) const;
+	bool read(std::istream& stream);
+
+private:
+	enum class _Container : uint8_t
+	{
+		ARRAY = 0,
+		BITSET = 1,
+		RUN = 2
+	};
+
+	_Container _container = _Container::ARRAY;
+	uint32_t _cardinality = 0;
+
+	// Sorted values of an array, or pairs of start and length - 1 of runs
+	std::vector<value_type> _values;
+	std::vector<uint64_t> _bits;
+
+	static constexpr size_t _max_array_size = 4096;
+	static constexpr size_t _num_of_words = 65536 / 64;
+
+private:
+	void _to_bitset();
+
+	size_t _array_size_in_bytes() const;
+	size_t _run_size_in_bytes() const;
+	size_t _num_of_runs() const;
+};
\ No newline at end of file
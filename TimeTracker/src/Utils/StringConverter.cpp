@@ -2,28 +2,56 @@
 
 std::string StringConverter::to_utf8(const std::wstring& str)
 {
-	UINT code_page = CP_UTF8;
-	int flags = 0;
-
-	int size = WideCharToMultiByte(code_page, flags, str.c_str(), str.size(), nullptr, 0, nullptr, nullptr);
-
-	std::string result(size, 0);
-
-	WideCharToMultiByte(code_page, flags, str.c_str(), str.size(), result.data(), size, nullptr, nullptr);
-
-	return result;
+	return Platform::to_utf8(str);
 }
 
 std::wstring StringConverter::to_utf16(const std::string& str)
 {
-	UINT code_page = CP_UTF8;
-	int flags = 0;
-
-	int size = MultiByteToWideChar(code_page, flags, str.c_str(), str.size(), nullptr, 0);
-
-	std::wstring result(size, 0);
+	return Platform::to_wide(str);
+}
 
-	MultiByteToWideChar(code_page, flags, str.c_str(), str.size(), result.data(), size);
+std::string StringConverter::to_json(std::string_view str)
+{
+	std::string result;
+	result.reserve(str.size() + 2);
+
+	result += '"';
+
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		case '\n':
+			result += "\\n";
+			break;
+		case '\r':
+			result += "\\r";
+			break;
+		case '\t':
+			result += "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char buffer[8];
+				snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+				result += buffer;
+			}
+			else
+			{
+				result += c;
+			}
+			break;
+		}
+	}
+
+	result += '"';
 
 	return result;
 }
\ No newline at end of file
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <cstdio>
 
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
+#include "Platform.h"
 
 class StringConverter
 {
 public:
 	static std::string to_utf8(const std::wstring& str);
 	static std::wstring to_utf16(const std::string& str);
+
+	static std::string to_json(std::string_view str);
 };
\ No newline at end of file
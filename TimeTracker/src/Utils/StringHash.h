@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <functional>
+
+struct StringHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view str) const
+	{
+		return std::hash<std::string_view>{}(str);
+	}
+};
+
+// Allows lookups by std::string_view without constructing a std::string
+template <typename T>
+using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "TimeConverter.h"
+
+TimeConverter::timestamp TimeConverter::to_timestamp(int year, int month, int day, int hour, int minute, int second)
+{
+	// Days from civil, see http://howardhinnant.github.io/date_algorithms.html
+	year -= month <= 2;
+
+	int64_t era = (year >= 0 ? year : year - 399) / 400;
+	int64_t year_of_era = year - era * 400;
+	int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+	int64_t days = era * 146097 + day_of_era - 730425; // 2000-03-01 based era to 2000-01-01
+
+	return days * seconds_per_day + hour * 3600 + minute * 60 + second;
+}
+
+TimeConverter::timestamp TimeConverter::to_timestamp(const std::tm& time)
+{
+	return to_timestamp(time.tm_year + 1900, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
+}
+
+int32_t TimeConverter::to_day(timestamp time)
+{
+	timestamp day = time / seconds_per_day;
+	if (time % seconds_per_day < 0)
+	{
+		day--;
+	}
+
+	return int32_t(day);
+}
+
+TimeConverter::timestamp TimeConverter::from_day(int32_t day)
+{
+	return timestamp(day) * seconds_per_day;
+}
+
+void TimeConverter::to_date(int32_t day, int& year, int& month, int& day_of_month)
+{
+	// Civil from days, see http://howardhinnant.github.io/date_algorithms.html
+	int64_t days = int64_t(day) + 730425;
+
+	int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+	int64_t day_of_era = days - era * 146097;
+	int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	int64_t month_index = (5 * day_of_year + 2) / 153;
+
+	day_of_month = int(day_of_year - (153 * month_index + 2) / 5 + 1);
+	month = int(month_index < 10 ? month_index + 3 : month_index - 9);
+	year = int(year_of_era + era * 400 + (month <= 2));
+}
+
+std::string TimeConverter::to_string(timestamp time)
+{
+	int year, month, day;
+	to_date(to_day(time), year, month, day);
+
+	timestamp seconds = time - from_day(to_day(time));
+
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d",
+		year, month, day, int(seconds / 3600), int(seconds / 60 % 60), int(seconds % 60));
+
+	return std::string(buffer);
+}
+
+bool TimeConverter::parse(std::string_view str, timestamp& time)
+{
+	// Accepts YYYY-MM-DD and YYYY-MM-DDTHH:MM:SS
+	if (str.size() != 10 && str.size() != 19)
+	{
+		return false;
+	}
+
+	const char* format = "dddd-dd-ddTdd:dd:dd";
+
+	int fields[6] = { 0, 0, 0, 0, 0, 0 };
+	int field = 0;
+
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		if (format[i] != 'd')
+		{
+			if (str[i] != format[i] && !(format[i] == 'T' && str[i] == ' '))
+			{
+				return false;
+			}
+
+			field++;
+			continue;
+		}
+
+		if (str[i] < '0' || str[i] > '9')
+		{
+			return false;
+		}
+
+		fields[field] = fields[field] * 10 + (str[i] - '0');
+	}
+
+	if (fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > 31 ||
+		fields[3] > 23 || fields[4] > 59 || fields[5] > 59)
+	{
+		return false;
+	}
+
+	time = to_timestamp(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <stdint.h>
+#include <ctime>
+#include <cstdio>
+
+/*
+* Timestamps count seconds since 2000-01-01 00:00:00 in local civil time,
+* matching the year offset used by the TTE date encoding. They are never
+* adjusted for time zones, so converting to and from a date is pure
+* arithmetic.
+*/
+
+class TimeConverter
+{
+public:
+	using timestamp = int64_t;
+
+	static constexpr timestamp seconds_per_day = 86400;
+
+	static timestamp to_timestamp(int year, int month, int day, int hour, int minute, int second);
+	static timestamp to_timestamp(const std::tm& time);
+
+	static int32_t to_day(timestamp time);
+	static timestamp from_day(int32_t day);
+
+	static void to_date(int32_t day, int& year, int& month, int& day_of_month);
+
+	static std::string to_string(timestamp time);
+	static bool parse(std::string_view str, timestamp& time);
+};
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "Trace.h"
+
+#include <fstream>
+#include <filesystem>
+
+#include "Format.h"
+#include "StringConverter.h"
+
+std::atomic<bool> Trace::_enabled = true;
+
+std::mutex Trace::_mutex{};
+std::vector<std::shared_ptr<Trace::_ThreadBuffer>> Trace::_buffers{};
+
+Trace::Span::Span(const char* name)
+	: _name(name), _start(Trace::enabled() ? Trace::_now() : -1)
+{
+}
+
+Trace::Span::~Span()
+{
+	if (_start < 0)
+	{
+		return;
+	}
+
+	int64_t end = Trace::_now();
+
+	_ThreadBuffer& buffer = Trace::_thread_buffer();
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+
+	_Span span{ _name, _start, end - _start };
+
+	if (buffer.spans.size() < _max_spans_per_thread)
+	{
+		buffer.spans.push_back(span);
+	}
+	else
+	{
+		buffer.spans[buffer.next] = span;
+	}
+
+	buffer.next = (buffer.next + 1) % _max_spans_per_thread;
+}
+
+void Trace::start()
+{
+	_enabled = true;
+}
+
+void Trace::stop()
+{
+	_enabled = false;
+}
+
+bool Trace::enabled()
+{
+	return _enabled.load(std::memory_order_relaxed);
+}
+
+void Trace::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (const std::shared_ptr<_ThreadBuffer>& buffer : _buffers)
+	{
+		std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+		buffer->spans.clear();
+		buffer->next = 0;
+	}
+}
+
+std::string Trace::to_json()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::string json = "{\"traceEvents\":[";
+
+	bool first = true;
+
+	for (const std::shared_ptr<_ThreadBuffer>& buffer : _buffers)
+	{
+		std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+		for (const _Span& span : buffer->spans)
+		{
+			// Timestamps are in microseconds, the fraction keeps nanosecond precision
+			json += Format::format("{}{{\"name\":{},\"cat\":\"TimeTracker\",\"ph\":\"X\",\"ts\":{}.{:03},\"dur\":{}.{:03},\"pid\":1,\"tid\":{}}}",
+				first ? "" : ",",
+				StringConverter::to_json(span.name),
+				span.start / 1000, span.start % 1000,
+				span.duration / 1000, span.duration % 1000,
+				buffer->thread_id);
+
+			first = false;
+		}
+	}
+
+	json += "],\"displayTimeUnit\":\"ns\"}";
+
+	return json;
+}
+
+bool Trace::write(const std::wstring& file_path)
+{
+	std::ofstream file(std::filesystem::path(file_path), std::ios::out | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << to_json();
+
+	return file.good();
+}
+
+Trace::_ThreadBuffer& Trace::_thread_buffer()
+{
+	// The registry shares ownership, so spans of exited threads can still be exported
+	thread_local std::shared_ptr<_ThreadBuffer> buffer = []()
+		{
+			std::shared_ptr<_ThreadBuffer> buffer = std::make_shared<_ThreadBuffer>();
+
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			buffer->thread_id = uint32_t(_buffers.size() + 1);
+			_buffers.push_back(buffer);
+
+			return buffer;
+		}();
+
+	return *buffer;
+}
+
+int64_t Trace::_now()
+{
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <stdint.h>
+
+/*
+* Scoped trace spans, exported in the Chrome trace_event JSON format
+* (chrome://tracing, Perfetto).
+*
+* TRACE_SPAN("name") records the enclosing scope as a complete event into a
+* buffer owned by the calling thread, so recording never contends with other
+* threads. Every buffer keeps the most recent _max_spans_per_thread spans.
+* Recording can be paused with Trace::stop() and resumed with Trace::start().
+*
+* Spans only exist when TIME_TRACKER_TRACING is defined, otherwise the macro
+* expands to nothing and tracing has no cost. The names must be string
+* literals, they are stored by pointer.
+*/
+
+#ifdef TIME_TRACKER_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name) Trace::Span TRACE_CONCAT(_trace_span_, __LINE__)(name)
+#else
+#define TRACE_SPAN(name)
+#endif
+
+class Trace
+{
+public:
+	class Span
+	{
+	public:
+		Span(const char* name);
+		~Span();
+
+		Span(const Span&) = delete;
+		Span& operator=(const Span&) = delete;
+
+	private:
+		const char* _name;
+		int64_t _start;
+	};
+
+public:
+	static void start();
+	static void stop();
+
+	static bool enabled();
+
+	static void clear();
+
+	static std::string to_json();
+	static bool write(const std::wstring& file_path);
+
+private:
+	struct _Span
+	{
+		const char* name;
+
+		int64_t start;
+		int64_t duration;
+	};
+
+	struct _ThreadBuffer
+	{
+		std::mutex mutex;
+
+		uint32_t thread_id = 0;
+
+		std::vector<_Span> spans;
+		size_t next = 0;
+	};
+
+	static constexpr size_t _max_spans_per_thread = 1 << 16;
+
+	static std::atomic<bool> _enabled;
+
+	static std::mutex _mutex;
+	static std::vector<std::shared_ptr<_ThreadBuffer>> _buffers;
+
+	static _ThreadBuffer& _thread_buffer();
+
+	static int64_t _now();
+};
\ No newline at end of file
@@ -0,0 +1,471 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <charconv>
+#include <functional>
+
+#include "../src/Database/Database.h"
+#include "../src/Database/TTEFile/TTEFileDate.h"
+#include "../src/Database/TTEFile/TTEFileEvent.h"
+#include "../src/Database/TTEFile/TTEFileReader.h"
+#include "../src/Database/TTEFile/TTEFileWriter.h"
+#include "../src/Database/TTEFile/TTEMergeReader.h"
+#include "../src/Database/TTRFile/TTRFileReader.h"
+#include "../src/Database/TTRFile/TTRFileMappedReader.h"
+
+#include "../src/Tools/WorkloadGenerator.h"
+
+#include "../src/Utils/Format.h"
+#include "../src/Utils/Logger.h"
+#include "../src/Utils/PathProvider.h"
+#include "../src/Utils/StringConverter.h"
+#include "../src/Utils/TimeConverter.h"
+#include "../src/Utils/Trace.h"
+
+/*
+* Usage: Benchmark [options]
+* 
+*   --days <n,n,...>     Database sizes in simulated days (default 30,365,1825)
+*   --seed <n>           Workload seed (default 1)
+*   --min-time <ms>      Minimum measured time per benchmark (default 200)
+*   --filter <text>      Only run benchmarks whose name contains text
+*   --format <csv|json>  Output format (default csv)
+*   --dir <path>         Scratch directory (default: system temp directory)
+*   --trace <path>       Write recorded trace spans as Chrome trace JSON
+*                        (requires a build with TIME_TRACKER_TRACING)
+* 
+* Every result is one line, so two runs can be diffed directly.
+*/
+
+struct BenchmarkOptions
+{
+	std::vector<uint32_t> days = { 30, 365, 1825 };
+	uint64_t seed = 1;
+	double min_time = 0.2;
+	std::string filter;
+	bool json = false;
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "TimeTrackerBenchmark";
+	std::filesystem::path trace_path;
+};
+
+struct BenchmarkResult
+{
+	std::string name;
+	uint32_t days;
+	uint64_t database_events;
+	uint64_t operations;
+	double seconds;
+};
+
+// Keeps the compiler from discarding benchmarked work
+static volatile uint64_t sink = 0;
+
+static BenchmarkOptions options;
+
+static void report(const BenchmarkResult& result)
+{
+	double ns_per_op = result.operations == 0 ? 0.0 : result.seconds * 1e9 / result.operations;
+	double ops_per_second = result.seconds == 0.0 ? 0.0 : result.operations / result.seconds;
+
+	if (options.json)
+	{
+		std::cout << Format::format("{{\"benchmark\":\"{}\",\"days\":{},\"database_events\":{},\"operations\":{},\"seconds\":{:.6f},\"ns_per_op\":{:.2f},\"ops_per_second\":{:.0f}}}",
+			result.name, result.days, result.database_events, result.operations, result.seconds, ns_per_op, ops_per_second) << std::endl;
+	}
+	else
+	{
+		std::cout << Format::format("{},{},{},{},{:.6f},{:.2f},{:.0f}",
+			result.name, result.days, result.database_events, result.operations, result.seconds, ns_per_op, ops_per_second) << std::endl;
+	}
+}
+
+// Calls function until min_time has elapsed; function returns the number of operations it performed
+static void run(const std::string& name, uint32_t days, uint64_t database_events, std::function<uint64_t()> function)
+{
+	if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+	{
+		return;
+	}
+
+	uint64_t operations = 0;
+	double seconds = 0.0;
+
+	while (seconds < options.min_time || operations == 0)
+	{
+		auto start = std::chrono::steady_clock::now();
+		uint64_t performed = function();
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (performed == 0)
+		{
+			break;
+		}
+
+		operations += performed;
+	}
+
+	report(BenchmarkResult{ name, days, database_events, operations, seconds });
+}
+
+static std::wstring path(const std::string& name)
+{
+	return (options.directory / name).wstring();
+}
+
+// Seconds after 2100-01-01, past every generated workload, so appends keep advancing
+static std::tm append_time(uint64_t second)
+{
+	TimeConverter::timestamp time = TimeConverter::to_timestamp(2100, 1, 1, 0, 0, 0) + TimeConverter::timestamp(second);
+	int32_t day = TimeConverter::to_day(time);
+	TimeConverter::timestamp seconds_of_day = time - TimeConverter::from_day(day);
+
+	std::tm result{};
+	int year, month, day_of_month;
+	TimeConverter::to_date(day, year, month, day_of_month);
+
+	result.tm_year = year - 1900;
+	result.tm_mon = month - 1;
+	result.tm_mday = day_of_month;
+	result.tm_hour = int(seconds_of_day / 3600);
+	result.tm_min = int(seconds_of_day / 60 % 60);
+	result.tm_sec = int(seconds_of_day % 60);
+
+	return result;
+}
+
+static void benchmark_encoding()
+{
+	constexpr size_t count = 1 << 16;
+
+	std::vector<TTEFileEvent> events;
+	std::vector<TTEFileEvent::encoded_event> encoded(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		events.emplace_back(TTEFileEvent::entity_id(i % 0x7FFF), uint8_t(i % 24), uint8_t(i % 60), uint8_t(i / 60 % 60));
+		events.back().encode(encoded[i]);
+	}
+
+	run("tte_event_encode", 0, 0, [&]()
+		{
+			TTEFileEvent::encoded_event checksum = 0;
+			for (const TTEFileEvent& event : events)
+			{
+				TTEFileEvent::encoded_event value;
+				event.encode(value);
+				checksum ^= value;
+			}
+			sink = sink + checksum;
+			return uint64_t(count);
+		});
+
+	run("tte_event_decode", 0, 0, [&]()
+		{
+			uint64_t checksum = 0;
+			for (TTEFileEvent::encoded_event value : encoded)
+			{
+				checksum += TTEFileEvent::decode(value).entity;
+			}
+			sink = sink + checksum;
+			return uint64_t(count);
+		});
+
+	run("tte_date_encode_decode", 0, 0, [&]()
+		{
+			uint64_t checksum = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				TTEFileDate date(uint8_t(i % 100), uint8_t(i % 12 + 1), uint8_t(i % 28 + 1));
+				TTEFileDate::encoded_date value;
+				date.encode(value);
+				checksum += TTEFileDate::decode(value).day;
+			}
+			sink = sink + checksum;
+			return uint64_t(count);
+		});
+}
+
+static void benchmark_database_size(uint32_t days)
+{
+	std::string base = Format::format("workload_{}", days);
+
+	WorkloadGenerator::Options workload;
+	workload.seed = options.seed;
+	workload.days = days;
+
+	WorkloadGenerator generator(workload);
+	WorkloadGenerator::Statistics statistics;
+
+	if (!generator.generate(path(base + ".ttr"), path(base + ".tte"), statistics))
+	{
+		std::cerr << "Failed to generate workload for " << days << " days" << std::endl;
+		return;
+	}
+
+	uint64_t num_of_events = statistics.num_of_events;
+
+	run("tte_reader_sequential_scan", days, num_of_events, [&]()
+		{
+			TTEFileReader reader(path(base + ".tte"));
+
+			uint64_t count = 0;
+			for (const TTEFileReader::Event& event : reader.events())
+			{
+				sink = sink + event.entity;
+				count++;
+			}
+			return count;
+		});
+
+	run("tte_merge_reader_two_inputs", days, num_of_events, [&]()
+		{
+			TTEMergeReader reader({ path(base + ".tte"), path(base + ".tte") });
+
+			uint64_t count = 0;
+			for (const TTEMergeReader::Event& event : reader.events())
+			{
+				sink = sink + event.entity;
+				count++;
+			}
+			return count;
+		});
+
+	run("tte_reader_random_access", days, num_of_events, [&]()
+		{
+			TTEFileReader reader(path(base + ".tte"));
+			TTEFileReader::Event event;
+
+			constexpr uint64_t lookups = 1000;
+
+			uint64_t state = 0x9E3779B97F4A7C15ull;
+			for (uint64_t i = 0; i < lookups; i++)
+			{
+				state = state * 6364136223846793005ull + 1442695040888963407ull;
+				if (reader.get_event((state >> 33) % num_of_events, event))
+				{
+					sink = sink + event.entity;
+				}
+			}
+			return lookups;
+		});
+
+	run("tte_reader_count_dates", days, num_of_events, [&]()
+		{
+			TTEFileReader reader(path(base + ".tte"));
+			sink = sink + reader.count_dates();
+			return uint64_t(1);
+		});
+
+	run("ttr_reader_get_entity", days, num_of_events, [&]()
+		{
+			TTRFileReader reader(path(base + ".ttr"));
+
+			constexpr uint64_t lookups = 100;
+
+			uint64_t state = 0x2545F4914F6CDD1Dull;
+			for (uint64_t i = 0; i < lookups; i++)
+			{
+				state = state * 6364136223846793005ull + 1442695040888963407ull;
+				sink = sink + reader.get_entity(TTRFileReader::entity_id((state >> 33) % statistics.num_of_entities)).size();
+			}
+			return lookups;
+		});
+
+	run("ttr_reader_get_entity_id", days, num_of_events, [&]()
+		{
+			TTRFileReader reader(path(base + ".ttr"));
+			TTRFileReader::domain_id domain = reader.get_domain_id("Browser");
+
+			constexpr uint64_t lookups = 100;
+
+			for (uint64_t i = 0; i < lookups; i++)
+			{
+				sink = sink + reader.get_entity_id(domain, Format::format("site{:05}.example.com", i * 37 % 5000));
+			}
+			return lookups;
+		});
+
+	run("ttr_mapped_reader_load", days, num_of_events, [&]()
+		{
+			TTRFileMappedReader reader(path(base + ".ttr"));
+			sink = sink + reader.count_entities();
+			return uint64_t(1);
+		});
+
+	TTRFileMappedReader mapped_reader(path(base + ".ttr"));
+	mapped_reader.count_entities();
+
+	run("ttr_mapped_reader_get_entity", days, num_of_events, [&]()
+		{
+			constexpr uint64_t lookups = 10000;
+
+			uint64_t state = 0x2545F4914F6CDD1Dull;
+			for (uint64_t i = 0; i < lookups; i++)
+			{
+				state = state * 6364136223846793005ull + 1442695040888963407ull;
+				TTRFileMappedReader::entity_id id = TTRFileMappedReader::entity_id((state >> 33) % statistics.num_of_entities);
+				sink = sink + mapped_reader.get_entity(id).size() + mapped_reader.get_domain(id).size();
+			}
+			return lookups;
+		});
+
+	run("ttr_mapped_reader_get_entity_id", days, num_of_events, [&]()
+		{
+			TTRFileMappedReader::domain_id domain = mapped_reader.get_domain_id("Browser");
+
+			constexpr uint64_t lookups = 1000;
+
+			for (uint64_t i = 0; i < lookups; i++)
+			{
+				sink = sink + mapped_reader.get_entity_id(domain, Format::format("site{:05}.example.com", i * 37 % 5000));
+			}
+			return lookups;
+		});
+
+	{
+		// Only the appends are timed, the writer keeps growing the same copy
+		std::filesystem::copy_file(path(base + ".tte"), path("append.tte"), std::filesystem::copy_options::overwrite_existing);
+
+		TTEFileWriter writer(path("append.tte"));
+		uint64_t appended = 0;
+
+		run("tte_writer_add_event", days, num_of_events, [&]()
+			{
+				constexpr uint64_t appends = 100;
+
+				for (uint64_t i = 0; i < appends; i++, appended++)
+				{
+					std::tm time = append_time(appended);
+					writer.add_event(TTEFileWriter::Date(time.tm_year - 100, time.tm_mon + 1, time.tm_mday),
+						TTEFileWriter::Event(TTEFileWriter::entity_id(i % 2), uint8_t(time.tm_hour), uint8_t(time.tm_min), uint8_t(time.tm_sec)));
+				}
+				return appends;
+			});
+	}
+
+	// PathProvider paths can only be set once, so every size is copied to the same location
+	std::filesystem::copy_file(path(base + ".ttr"), path("database.ttr"), std::filesystem::copy_options::overwrite_existing);
+	std::filesystem::copy_file(path(base + ".tte"), path("database.tte"), std::filesystem::copy_options::overwrite_existing);
+
+	Database::startup();
+
+	uint64_t added = 0;
+
+	run("database_add_event", days, num_of_events, [&]()
+		{
+			constexpr uint64_t events = 100;
+
+			for (uint64_t i = 0; i < events; i++, added++)
+			{
+				Database::add_event("System", i % 2 == 0 ? "chrome.exe" : "Code.exe", append_time(added));
+			}
+			return events;
+		});
+
+	Database::shutdown();
+}
+
+template <typename T>
+static bool parse_number(std::string_view str, T& value)
+{
+	auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+	return error == std::errc() && end == str.data() + str.size();
+}
+
+static bool parse_options(int argc, char* argv[])
+{
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string_view option = argv[i];
+		std::string_view value = argv[i + 1];
+
+		if (option == "--days")
+		{
+			options.days.clear();
+
+			while (!value.empty())
+			{
+				size_t end = value.find(',');
+				uint32_t days = 0;
+
+				if (!parse_number(value.substr(0, end), days))
+				{
+					return false;
+				}
+
+				options.days.push_back(days);
+				value.remove_prefix(end == std::string_view::npos ? value.size() : end + 1);
+			}
+		}
+		else if (option == "--seed")
+		{
+			if (!parse_number(value, options.seed))
+				return false;
+		}
+		else if (option == "--min-time")
+		{
+			uint32_t milliseconds = 0;
+			if (!parse_number(value, milliseconds))
+				return false;
+			options.min_time = milliseconds / 1000.0;
+		}
+		else if (option == "--filter")
+			options.filter = value;
+		else if (option == "--format")
+		{
+			if (value != "csv" && value != "json")
+				return false;
+			options.json = value == "json";
+		}
+		else if (option == "--dir")
+			options.directory = std::filesystem::path(value);
+		else if (option == "--trace")
+			options.trace_path = std::filesystem::path(value);
+		else
+			return false;
+	}
+
+	return argc % 2 == 1;
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::set_log_level(LogLevel::LOG_ERROR);
+
+	if (!parse_options(argc, argv))
+	{
+		std::cout << "Usage: Benchmark [--days n,n,...] [--seed n] [--min-time ms] [--filter text] [--format csv|json] [--dir path] [--trace path]" << std::endl;
+		return 1;
+	}
+
+	std::filesystem::create_directories(options.directory);
+
+	PathProvider::set_file_path(path("database.ttr"), PathProvider::FileType::TTR);
+	PathProvider::set_file_path(path("database.tte"), PathProvider::FileType::TTE);
+
+	if (!options.json)
+	{
+		std::cout << "benchmark,days,database_events,operations,seconds,ns_per_op,ops_per_second" << std::endl;
+	}
+
+	benchmark_encoding();
+
+	for (uint32_t days : options.days)
+	{
+		benchmark_database_size(days);
+	}
+
+	std::filesystem::remove_all(options.directory);
+
+	if (!options.trace_path.empty() && !Trace::write(options.trace_path.wstring()))
+	{
+		std::cerr << "Failed to write trace to " << options.trace_path.string() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
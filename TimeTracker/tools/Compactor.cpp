@@ -0,0 +1,91 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../src/Tools/Compactor.h"
+
+#include "../src/Utils/Logger.h"
+#include "../src/Utils/StringConverter.h"
+
+/*
+* Usage: Compactor <input> [output] [options]
+* 
+* Reads <input>.ttr and <input>.tte and writes the compacted pair to
+* <output>.ttr and <output>.tte. Without an output the input is replaced.
+* 
+*   --keep-duplicates        Keep consecutive events of the same entity
+*   --keep-ids               Keep the registry order instead of ranking by frequency
+*   --no-scan                Do not time a scan of the input and the output
+*/
+
+static void print_usage()
+{
+	std::cout << "Usage: Compactor <input> [output] [--keep-duplicates] [--keep-ids] [--no-scan]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::set_log_level(LogLevel::LOG_WARNING);
+
+	if (argc < 2)
+	{
+		print_usage();
+		return 1;
+	}
+
+	std::string input = argv[1];
+	std::string output = input;
+
+	Compactor::Options options;
+
+	for (int i = 2; i < argc; i++)
+	{
+		std::string_view option = argv[i];
+
+		if (option == "--keep-duplicates")
+			options.drop_duplicates = false;
+		else if (option == "--keep-ids")
+			options.remap_by_frequency = false;
+		else if (option == "--no-scan")
+			options.measure_scans = false;
+		else if (i == 2 && !option.starts_with("--"))
+			output = option;
+		else
+		{
+			std::cout << "Unknown option: " << option << std::endl;
+			print_usage();
+			return 1;
+		}
+	}
+
+	Compactor compactor(options);
+	Compactor::Statistics statistics;
+
+	if (!compactor.compact(StringConverter::to_utf16(input + ".ttr"), StringConverter::to_utf16(input + ".tte"),
+		StringConverter::to_utf16(output + ".ttr"), StringConverter::to_utf16(output + ".tte"), statistics))
+	{
+		std::cout << "Failed to compact " << input << std::endl;
+		return 1;
+	}
+
+	int64_t saved = int64_t(statistics.input_bytes) - int64_t(statistics.output_bytes);
+
+	std::cout << "Events:   " << statistics.input_events << " -> " << statistics.output_events
+		<< " (" << statistics.invalid_events << " invalid, " << statistics.duplicate_events << " duplicate)" << std::endl;
+	std::cout << "Dates:    " << statistics.input_dates << " -> " << statistics.output_dates << std::endl;
+	std::cout << "Domains:  " << statistics.input_domains << " -> " << statistics.output_domains << std::endl;
+	std::cout << "Entities: " << statistics.input_entities << " -> " << statistics.output_entities << std::endl;
+	std::cout << "Bytes:    " << statistics.input_bytes << " -> " << statistics.output_bytes << " (" << saved << " saved)" << std::endl;
+
+	if (statistics.input_scan_seconds > 0.0 && statistics.output_scan_seconds > 0.0)
+	{
+		double input_throughput = statistics.input_events / statistics.input_scan_seconds;
+		double output_throughput = statistics.output_events / statistics.output_scan_seconds;
+
+		std::cout << "Scan:     " << statistics.input_scan_seconds << "s -> " << statistics.output_scan_seconds << "s ("
+			<< statistics.input_scan_seconds / statistics.output_scan_seconds << "x faster, "
+			<< uint64_t(input_throughput) << " -> " << uint64_t(output_throughput) << " events/s)" << std::endl;
+	}
+
+	return 0;
+}
\ No newline at end of file
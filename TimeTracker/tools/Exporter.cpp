@@ -0,0 +1,86 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <charconv>
+
+#include "../src/Tools/Exporter.h"
+
+#include "../src/Utils/Logger.h"
+#include "../src/Utils/StringConverter.h"
+
+/*
+* Usage: Exporter <input> <output> [options]
+* 
+* Reads <input>.ttr and <input>.tte and writes an Arrow IPC file to <output>,
+* e.g. for pandas.read_feather or DuckDB.
+* 
+*   --intervals              Write one row per interval instead of per event
+*   --batch-size <rows>      Rows per record batch, 65536 by default
+*/
+
+template <typename T>
+static bool parse_number(std::string_view str, T& value)
+{
+	auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+	return error == std::errc() && end == str.data() + str.size();
+}
+
+static void print_usage()
+{
+	std::cout << "Usage: Exporter <input> <output> [--intervals] [--batch-size <rows>]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::set_log_level(LogLevel::LOG_WARNING);
+
+	if (argc < 3)
+	{
+		print_usage();
+		return 1;
+	}
+
+	std::string input = argv[1];
+	std::string output = argv[2];
+
+	Exporter::Options options;
+
+	for (int i = 3; i < argc; i++)
+	{
+		std::string_view option = argv[i];
+
+		if (option == "--intervals")
+			options.mode = Exporter::Mode::INTERVALS;
+		else if (option == "--batch-size" && i + 1 < argc)
+		{
+			if (!parse_number(argv[++i], options.batch_size) || options.batch_size == 0)
+			{
+				std::cout << "Invalid batch size: " << argv[i] << std::endl;
+				print_usage();
+				return 1;
+			}
+		}
+		else
+		{
+			std::cout << "Unknown option: " << option << std::endl;
+			print_usage();
+			return 1;
+		}
+	}
+
+	Exporter exporter(options);
+	Exporter::Statistics statistics;
+
+	if (!exporter.export_arrow(StringConverter::to_utf16(input + ".ttr"), StringConverter::to_utf16(input + ".tte"), StringConverter::to_utf16(output), statistics))
+	{
+		std::cout << "Failed to export " << input << std::endl;
+		return 1;
+	}
+
+	std::cout << "Events:   " << statistics.input_events << " (" << statistics.skipped_events << " skipped)" << std::endl;
+	std::cout << "Rows:     " << statistics.rows << " in " << statistics.batches << " batches" << std::endl;
+	std::cout << "Bytes:    " << statistics.bytes << std::endl;
+	std::cout << "Time:     " << statistics.seconds << "s" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/Tools/Merger.h"
+
+#include "../src/Utils/Logger.h"
+#include "../src/Utils/StringConverter.h"
+
+/*
+* Usage: Merger <output> <device>=<input> <device>=<input> ... [options]
+* 
+* Reads <input>.ttr and <input>.tte of every device and writes the merged
+* pair to <output>.ttr and <output>.tte. A device without a name is named
+* after its input. The events of the devices may overlap in time, the merge
+* fails if the time per domain of the output differs from the inputs (see
+* Merger.h). The outputs are only replaced once the merge succeeded.
+* 
+*   --remap <file>           Write the ID remap table of every input as CSV
+*   --no-device-tag          Do not add the Device domain to the output
+*/
+
+static void print_usage()
+{
+	std::cout << "Usage: Merger <output> <device>=<input> <device>=<input> ... [--remap <file>] [--no-device-tag]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::set_log_level(LogLevel::LOG_WARNING);
+
+	if (argc < 3)
+	{
+		print_usage();
+		return 1;
+	}
+
+	std::string output = argv[1];
+	std::string remap;
+
+	Merger::Options options;
+	std::vector<Merger::Input> inputs;
+
+	for (int i = 2; i < argc; i++)
+	{
+		std::string_view option = argv[i];
+
+		if (option == "--remap" && i + 1 < argc)
+			remap = argv[++i];
+		else if (option == "--no-device-tag")
+			options.tag_devices = false;
+		else if (!option.starts_with("--"))
+		{
+			size_t separator = option.find('=');
+
+			std::string device = std::string(separator == std::string_view::npos ? option : option.substr(0, separator));
+			std::string input = std::string(separator == std::string_view::npos ? option : option.substr(separator + 1));
+
+			inputs.push_back({ device, StringConverter::to_utf16(input + ".ttr"), StringConverter::to_utf16(input + ".tte") });
+		}
+		else
+		{
+			std::cout << "Unknown option: " << option << std::endl;
+			print_usage();
+			return 1;
+		}
+	}
+
+	if (inputs.empty())
+	{
+		print_usage();
+		return 1;
+	}
+
+	Merger merger(options);
+	Merger::Statistics statistics;
+
+	if (!merger.merge(inputs, StringConverter::to_utf16(output + ".ttr"), StringConverter::to_utf16(output + ".tte"), statistics))
+	{
+		std::cout << "Failed to merge into " << output << std::endl;
+		return 1;
+	}
+
+	if (!remap.empty() && !merger.write_remaps(inputs, StringConverter::to_utf16(remap)))
+	{
+		std::cout << "Failed to write " << remap << std::endl;
+		return 1;
+	}
+
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		std::cout << inputs[i].device << ": " << statistics.input_events[i] << " events, "
+			<< merger.remaps()[i].entities.size() << " entities" << std::endl;
+	}
+
+	std::cout << "Events:   " << statistics.output_events << " (" << statistics.device_events << " device)" << std::endl;
+	std::cout << "Dates:    " << statistics.output_dates << std::endl;
+	std::cout << "Domains:  " << statistics.output_domains << std::endl;
+	std::cout << "Entities: " << statistics.output_entities << std::endl;
+
+	return 0;
+}
\ No newline at end of file
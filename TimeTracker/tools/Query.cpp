@@ -0,0 +1,194 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <charconv>
+
+#include "../src/Tools/Query.h"
+
+#include "../src/Utils/Logger.h"
+#include "../src/Utils/StringConverter.h"
+#include "../src/Utils/TimeConverter.h"
+
+/*
+* Usage: Query <input> [options]
+* 
+* Reads <input>.ttr and <input>.tte, or the segments listed in <input>.ttm
+* when it exists, and prints the number of events and the time spent per
+* group.
+* 
+*   --from <time>            Start of the range, YYYY-MM-DD or YYYY-MM-DDTHH:MM:SS
+*   --to <time>              End of the range, exclusive
+*   --domain <name>          Only this domain, may be repeated
+*   --entity <name>          Only this entity, may be repeated
+*   --group-by <keys>        Comma separated list of domain, entity, hour, weekday and day
+*   --sort <key>             duration (default), events or key
+*   --top <n>                Only the first n rows
+*   --sketch <k>             Track k entities per domain in bounded memory, approximate
+*   --bucket <minutes>       Width of the hour buckets, must evenly divide a day (default 60)
+*   --threads <n>            Workers of the hour and weekday histograms, 0 for one per core (default)
+*   --format <format>        text (default), csv or json
+*   --stats                  Print scan statistics to stderr
+* 
+* For example, the time per entity over the time of the day in quarter hours:
+* 
+*   Query <input> --group-by entity,hour --bucket 15 --sort key
+*/
+
+template <typename T>
+static bool parse_number(std::string_view str, T& value)
+{
+	auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+	return error == std::errc() && end == str.data() + str.size();
+}
+
+static void print_usage()
+{
+	std::cout << "Usage: Query <input> [--from <time>] [--to <time>] [--domain <name>] [--entity <name>]" << std::endl;
+	std::cout << "             [--group-by domain,entity,hour,weekday,day] [--sort duration|events|key] [--top <n>]" << std::endl;
+	std::cout << "             [--sketch <k>] [--bucket <minutes>] [--threads <n>] [--format text|csv|json] [--stats]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::set_log_level(LogLevel::LOG_WARNING);
+
+	if (argc < 2)
+	{
+		print_usage();
+		return 1;
+	}
+
+	std::string input = argv[1];
+
+	Query::Options options;
+	options.threads = 0;
+	Query::Output output = Query::Output::TEXT;
+	bool print_statistics = false;
+
+	for (int i = 2; i < argc; i++)
+	{
+		std::string_view option = argv[i];
+		bool has_value = i + 1 < argc;
+
+		bool valid = true;
+
+		if ((option == "--from" || option == "--to") && has_value)
+			valid = TimeConverter::parse(argv[++i], option == "--from" ? options.from : options.to);
+		else if (option == "--domain" && has_value)
+			options.domains.push_back(argv[++i]);
+		else if (option == "--entity" && has_value)
+			options.entities.push_back(argv[++i]);
+		else if (option == "--group-by" && has_value)
+		{
+			std::string_view keys = argv[++i];
+
+			while (valid && !keys.empty())
+			{
+				size_t separator = keys.find(',');
+
+				Query::Group group;
+				valid = Query::parse_group(keys.substr(0, separator), group);
+				options.group_by.push_back(group);
+
+				keys = separator == std::string_view::npos ? std::string_view() : keys.substr(separator + 1);
+			}
+		}
+		else if (option == "--sort" && has_value)
+		{
+			std::string_view sort = argv[++i];
+
+			if (sort == "duration")
+				options.sort = Query::Sort::DURATION;
+			else if (sort == "events")
+				options.sort = Query::Sort::EVENTS;
+			else if (sort == "key")
+				options.sort = Query::Sort::KEY;
+			else
+				valid = false;
+		}
+		else if (option == "--top" && has_value)
+			valid = parse_number(argv[++i], options.top);
+		else if (option == "--sketch" && has_value)
+			valid = parse_number(argv[++i], options.sketch_capacity);
+		else if (option == "--bucket" && has_value)
+		{
+			int64_t minutes = 0;
+			valid = parse_number(argv[++i], minutes) && minutes > 0 && minutes <= 1440;
+
+			options.bucket_size = minutes * 60;
+			valid = valid && Histogram::valid_bucket_size(options.bucket_size);
+		}
+		else if (option == "--threads" && has_value)
+			valid = parse_number(argv[++i], options.threads);
+		else if (option == "--format" && has_value)
+		{
+			std::string_view format = argv[++i];
+
+			if (format == "text")
+				output = Query::Output::TEXT;
+			else if (format == "csv")
+				output = Query::Output::CSV;
+			else if (format == "json")
+				output = Query::Output::JSON;
+			else
+				valid = false;
+		}
+		else if (option == "--stats")
+			print_statistics = true;
+		else
+			valid = false;
+
+		if (!valid)
+		{
+			std::cout << "Invalid option: " << option << std::endl;
+			print_usage();
+			return 1;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	Query query(options);
+	Query::Statistics statistics;
+
+	std::vector<Query::Row> rows;
+
+	std::wstring ttr_file_path = StringConverter::to_utf16(input + ".ttr");
+	std::wstring manifest_file_path = StringConverter::to_utf16(input + ".ttm");
+
+	bool success = std::filesystem::exists(manifest_file_path)
+		? query.run_segments(ttr_file_path, manifest_file_path, rows, statistics)
+		: query.run(ttr_file_path, StringConverter::to_utf16(input + ".tte"), rows, statistics);
+
+	if (!success)
+	{
+		std::cout << "Failed to query " << input << std::endl;
+		return 1;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	query.write(rows, output, std::cout);
+
+	if (print_statistics)
+	{
+		std::cerr << "Scanned " << statistics.scanned_events << " events, matched " << statistics.matched_events
+			<< ", " << statistics.intervals << " intervals, " << statistics.groups << " groups, "
+			<< statistics.skipped_dates << " dates skipped in " << seconds << "s" << std::endl;
+
+		if (statistics.histogram_threads > 0)
+		{
+			std::cerr << "Histogram used " << statistics.histogram_threads << " threads for " << statistics.histogram_batches << " batches" << std::endl;
+		}
+
+		if (statistics.approximate)
+		{
+			std::cerr << "Sketches used " << statistics.sketch_bytes << " bytes" << std::endl;
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
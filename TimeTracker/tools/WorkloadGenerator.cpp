@@ -0,0 +1,134 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <charconv>
+
+#include "../src/Tools/WorkloadGenerator.h"
+
+#include "../src/Utils/Logger.h"
+#include "../src/Utils/StringConverter.h"
+#include "../src/Utils/TimeConverter.h"
+
+/*
+* Usage: WorkloadGenerator <output> [options]
+* 
+* Writes <output>.ttr and <output>.tte.
+* 
+*   --seed <n>               Random seed (default 1)
+*   --start <YYYY-MM-DD>     First simulated day (default 2020-01-01)
+*   --days <n>               Number of simulated days (default 365)
+*   --system <n>             Number of applications (default 200)
+*   --browser <n>            Number of websites (default 5000)
+*   --vscode <n>             Number of VSCode workspaces (default 100)
+*   --obsidian <n>           Number of Obsidian vaults (default 20)
+*   --zipf <s>               Zipf exponent of entity popularity (default 1.1)
+*   --events-per-hour <n>    Mean foreground changes per active hour (default 60)
+*   --idle-per-hour <n>      Mean idle periods per active hour (default 0.5)
+*/
+
+template <typename T>
+static bool parse_number(std::string_view str, T& value)
+{
+	auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+	return error == std::errc() && end == str.data() + str.size();
+}
+
+static void print_usage()
+{
+	std::cout << "Usage: WorkloadGenerator <output> [--seed n] [--start YYYY-MM-DD] [--days n]" << std::endl;
+	std::cout << "       [--system n] [--browser n] [--vscode n] [--obsidian n]" << std::endl;
+	std::cout << "       [--zipf s] [--events-per-hour n] [--idle-per-hour n]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::set_log_level(LogLevel::LOG_WARNING);
+
+	if (argc < 2)
+	{
+		print_usage();
+		return 1;
+	}
+
+	std::string output = argv[1];
+	WorkloadGenerator::Options options;
+
+	for (int i = 2; i < argc; i += 2)
+	{
+		std::string_view option = argv[i];
+
+		if (i + 1 >= argc)
+		{
+			std::cout << "Missing value for " << option << std::endl;
+			return 1;
+		}
+
+		std::string_view value = argv[i + 1];
+		bool valid = true;
+
+		if (option == "--seed")
+			valid = parse_number(value, options.seed);
+		else if (option == "--days")
+			valid = parse_number(value, options.days);
+		else if (option == "--system")
+			valid = parse_number(value, options.system_entities);
+		else if (option == "--browser")
+			valid = parse_number(value, options.browser_entities);
+		else if (option == "--vscode")
+			valid = parse_number(value, options.vscode_entities);
+		else if (option == "--obsidian")
+			valid = parse_number(value, options.obsidian_entities);
+		else if (option == "--zipf")
+			valid = parse_number(value, options.zipf_exponent);
+		else if (option == "--events-per-hour")
+			valid = parse_number(value, options.events_per_hour);
+		else if (option == "--idle-per-hour")
+			valid = parse_number(value, options.idle_periods_per_hour);
+		else if (option == "--start")
+		{
+			TimeConverter::timestamp start;
+			valid = value.size() == 10 && TimeConverter::parse(value, start);
+
+			if (valid)
+			{
+				int year, month, day;
+				TimeConverter::to_date(TimeConverter::to_day(start), year, month, day);
+
+				valid = year >= 2000 && year <= 2127;
+				options.start_date = TTEFileDate(uint8_t(year - 2000), uint8_t(month), uint8_t(day));
+			}
+		}
+		else
+		{
+			std::cout << "Unknown option: " << option << std::endl;
+			print_usage();
+			return 1;
+		}
+
+		if (!valid)
+		{
+			std::cout << "Invalid value for " << option << ": " << value << std::endl;
+			return 1;
+		}
+	}
+
+	WorkloadGenerator generator(options);
+	WorkloadGenerator::Statistics statistics;
+
+	auto start = std::chrono::steady_clock::now();
+
+	if (!generator.generate(StringConverter::to_utf16(output + ".ttr"), StringConverter::to_utf16(output + ".tte"), statistics))
+	{
+		std::cout << "Failed to generate workload" << std::endl;
+		return 1;
+	}
+
+	auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Generated " << statistics.num_of_events << " events over " << statistics.num_of_dates << " dates ("
+		<< statistics.num_of_sessions << " sessions, " << statistics.num_of_entities << " entities) in "
+		<< elapsed << "s" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -4,10 +4,14 @@ from typing import Union
 
 from TTRFile import TTRFile
 from TTEFile import TTEFile
+from TimeTrackerLibrary import TimeTrackerLibrary, Database
 
 from Logger import Logger
 
 def format_data(path: str) -> list[tuple[str, str, datetime, datetime]]:
+    if TimeTrackerLibrary.available():
+        return format_data_with_library(path)
+        
     ttr_file_path = path + ".ttr"
     tte_file_path = path + ".tte"
     
@@ -144,4 +148,37 @@ def format_data(path: str) -> list[tuple[str, str, datetime, datetime]]:
             
     events = [event for event in events if event[0] != "Runtime" and event[0] != "Activity"] # Comment this line to include runtime events
     
+    return events
+
+# Same intervals as format_data, built by the C++ IntervalBuilder in one call
+def format_data_with_library(path: str) -> list[tuple[str, str, datetime, datetime]]:
+    database = Database(path + ".ttr", path + ".tte")
+    
+    if not database.ready():
+        Logger.log_error("Failed to open database: {}", path)
+        return []
+        
+    domains = database.domains()
+    entities = database.entities()
+    
+    intervals = database.intervals()
+    
+    if intervals is None:
+        Logger.log_error("Failed to read intervals: {}", path)
+        return []
+        
+    starts, ends, domain_ids, entity_ids = intervals
+    
+    epoch = datetime(1970, 1, 1)
+    
+    events: list[tuple[str, str, datetime, datetime]] = []
+    
+    for start, end, domain_id, entity_id in zip(starts, ends, domain_ids, entity_ids):
+        domain = domains[domain_id]
+        
+        if domain == "Runtime" or domain == "Activity": # Comment this line to include runtime events
+            continue
+            
+        events.append((domain, entities[entity_id][1], epoch + timedelta(seconds=start), epoch + timedelta(seconds=end)))
+        
     return events
\ No newline at end of file
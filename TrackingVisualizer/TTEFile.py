@@ -1,8 +1,10 @@
 from typing import Union
+from datetime import datetime, timedelta
 import ctypes as c
 import io
 
 from Logger import Logger
+from TimeTrackerLibrary import TimeTrackerLibrary, Database
 
 class Date:
     year: int
@@ -148,6 +150,9 @@ class TTEFile:
             return False
     
     def __parse(self) -> bool:
+        if TimeTrackerLibrary.available():
+            return self.__parse_with_library()
+            
         if not self.__file and not self.__open():
             Logger.append_info("Failed to parse file: {}", self.__path)
             return False
@@ -190,4 +195,30 @@ class TTEFile:
             
         except Exception as e:
             Logger.log_error("An error occurred while parsing: {}", e)
-            return False
\ No newline at end of file
+            return False
+        
+    def __parse_with_library(self) -> bool:
+        database = Database(None, self.__path)
+        
+        if not database.ready():
+            Logger.append_info("Failed to parse file: {}", self.__path)
+            return False
+            
+        events = database.events()
+        
+        if events is None:
+            Logger.append_info("Failed to read events: {}", self.__path)
+            return False
+            
+        timestamps, entities = events
+        
+        self.events: list[Event] = []
+        
+        epoch = datetime(1970, 1, 1)
+        
+        for timestamp, entity_id in zip(timestamps, entities):
+            time = epoch + timedelta(seconds=timestamp)
+            self.events.append(Event(Date(time.year - 2000, time.month, time.day), entity_id, time.hour, time.minute, time.second))
+            
+        self.__has_parsed = True
+        return True
\ No newline at end of file
@@ -2,6 +2,7 @@ from typing import Union
 import io
 
 from Logger import Logger
+from TimeTrackerLibrary import TimeTrackerLibrary, Database
 
 class TTRFile:
     domains: list[str]
@@ -139,6 +140,9 @@ class TTRFile:
             return False
     
     def __parse(self) -> bool:
+        if TimeTrackerLibrary.available():
+            return self.__parse_with_library()
+            
         if not self.__file and not self.__open():
             Logger.append_info("Failed to parse file: {}", self.__path)
             return False
@@ -184,4 +188,17 @@ class TTRFile:
         except Exception as e:
             Logger.log_error("An error occurred while parsing: {}", e)
             return False
-        
\ No newline at end of file
+        
+        
+    def __parse_with_library(self) -> bool:
+        database = Database(self.__path, None)
+        
+        if not database.ready():
+            Logger.append_info("Failed to parse file: {}", self.__path)
+            return False
+            
+        self.domains = database.domains()
+        self.entities = database.entities()
+        
+        self.__has_parsed = True
+        return True
\ No newline at end of file
@@ -0,0 +1,153 @@
+from typing import Union
+import ctypes as c
+import os
+import sys
+
+from Logger import Logger
+
+# Bindings of TimeTracker/src/Api/TimeTrackerApi.h. Every bulk function is called
+# twice, once to size the buffers and once to fill them. The buffers are ctypes
+# arrays, numpy.ctypeslib.as_array wraps them without copying.
+
+API_VERSION = 1
+
+class TimeTrackerLibrary:
+    __library: Union[c.CDLL, None] = None
+    __loaded: bool = False
+
+    @staticmethod
+    def load() -> Union[c.CDLL, None]:
+        if TimeTrackerLibrary.__loaded:
+            return TimeTrackerLibrary.__library
+
+        TimeTrackerLibrary.__loaded = True
+
+        if sys.platform == "win32":
+            name = "TimeTrackerApi.dll"
+        elif sys.platform == "darwin":
+            name = "libTimeTrackerApi.dylib"
+        else:
+            name = "libTimeTrackerApi.so"
+
+        candidates = [os.environ.get("TIME_TRACKER_LIBRARY"), os.path.join(os.path.dirname(os.path.abspath(__file__)), name), name]
+
+        for candidate in candidates:
+            if candidate is None:
+                continue
+
+            try:
+                library = c.CDLL(candidate)
+            except OSError:
+                continue
+
+            if library.tt_version() != API_VERSION:
+                Logger.log_warning("Ignoring library with API version {}: {}", library.tt_version(), candidate)
+                continue
+
+            TimeTrackerLibrary.__declare(library)
+            TimeTrackerLibrary.__library = library
+            break
+
+        return TimeTrackerLibrary.__library
+
+    @staticmethod
+    def available() -> bool:
+        return TimeTrackerLibrary.load() is not None
+
+    @staticmethod
+    def __declare(library: c.CDLL):
+        library.tt_version.restype = c.c_int32
+
+        library.tt_open.restype = c.c_void_p
+        library.tt_open.argtypes = [c.c_char_p, c.c_char_p]
+        library.tt_close.restype = None
+        library.tt_close.argtypes = [c.c_void_p]
+
+        library.tt_domain_names.restype = c.c_int64
+        library.tt_domain_names.argtypes = [c.c_void_p, c.c_char_p, c.c_int64]
+        library.tt_entity_names.restype = c.c_int64
+        library.tt_entity_names.argtypes = [c.c_void_p, c.c_char_p, c.c_int64]
+        library.tt_entity_domains.restype = c.c_int64
+        library.tt_entity_domains.argtypes = [c.c_void_p, c.POINTER(c.c_uint8), c.c_int64]
+
+        library.tt_read_events.restype = c.c_int64
+        library.tt_read_events.argtypes = [c.c_void_p, c.POINTER(c.c_int64), c.POINTER(c.c_uint16), c.c_int64]
+        library.tt_read_intervals.restype = c.c_int64
+        library.tt_read_intervals.argtypes = [c.c_void_p, c.POINTER(c.c_int64), c.POINTER(c.c_int64), c.POINTER(c.c_uint8), c.POINTER(c.c_uint16), c.c_int64]
+
+class Database:
+    # Either path may be None to read only the registry or only the events
+    def __init__(self, ttr_path: Union[str, None], tte_path: Union[str, None]):
+        self.__library = TimeTrackerLibrary.load()
+        self.__handle = None
+
+        if self.__library is None:
+            Logger.log_error("TimeTracker library not found")
+            return
+
+        encode = lambda path: path.encode("utf-8") if path is not None else None
+
+        self.__handle = self.__library.tt_open(encode(ttr_path), encode(tte_path))
+
+        if not self.__handle:
+            Logger.log_error("Failed to open database: {}", ttr_path)
+            self.__handle = None
+
+    def __del__(self):
+        if self.__handle is not None:
+            self.__library.tt_close(self.__handle)
+
+    def ready(self) -> bool:
+        return self.__handle is not None
+
+    def domains(self) -> list[str]:
+        return self.__names(self.__library.tt_domain_names)
+
+    # (domain id, name) for every entity, like TTRFile.entities
+    def entities(self) -> list[tuple[int, str]]:
+        names = self.__names(self.__library.tt_entity_names)
+
+        domains = (c.c_uint8 * len(names))()
+        self.__library.tt_entity_domains(self.__handle, domains, len(names))
+
+        return list(zip(domains, names))
+
+    # Timestamps in seconds since 1970-01-01 local time and entity IDs, None if the events cannot be read
+    def events(self) -> Union[tuple[c.Array, c.Array], None]:
+        count = self.__library.tt_read_events(self.__handle, None, None, 0)
+
+        if count < 0:
+            return None
+
+        timestamps = (c.c_int64 * count)()
+        entities = (c.c_uint16 * count)()
+
+        if self.__library.tt_read_events(self.__handle, timestamps, entities, count) < 0:
+            return None
+
+        return timestamps, entities
+
+    # Starts, ends, domain IDs and entity IDs, None if the intervals cannot be read
+    def intervals(self) -> Union[tuple[c.Array, c.Array, c.Array, c.Array], None]:
+        count = self.__library.tt_read_intervals(self.__handle, None, None, None, None, 0)
+
+        if count < 0:
+            return None
+
+        starts = (c.c_int64 * count)()
+        ends = (c.c_int64 * count)()
+        domains = (c.c_uint8 * count)()
+        entities = (c.c_uint16 * count)()
+
+        if self.__library.tt_read_intervals(self.__handle, starts, ends, domains, entities, count) < 0:
+            return None
+
+        return starts, ends, domains, entities
+
+    def __names(self, function) -> list[str]:
+        size = max(function(self.__handle, None, 0), 0)
+
+        buffer = c.create_string_buffer(size)
+        function(self.__handle, buffer, size)
+
+        return [name.decode("utf-8") for name in buffer.raw[:size].split(b"\0")[:-1]]
\ No newline at end of file